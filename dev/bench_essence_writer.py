@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+Block-size sweep for the embedded-essence writer.
+
+Generates (or reuses) a large PCM WAV, then embeds it into a fresh AAF once per
+combination of block size × preallocation × writer mode and reports wall time,
+MB/s of essence written and output size. Use a file bigger than RAM cache
+(1 GB+) so the numbers reflect the disk, not the page cache.
+
+--read-only writes no AAF: it times EssenceWriter's block reader plus the
+per-channel split, i.e. the source side of 'stream' mode.
+
+Usage:
+    python dev/bench_essence_writer.py /tmp/big.wav --make-gb 1.5 --channels 2
+    python dev/bench_essence_writer.py /tmp/big.wav --blocks 256K 4M 16M --modes stream
+    python dev/bench_essence_writer.py /tmp/big.wav --fsync close --out /mnt/fast
+    python dev/bench_essence_writer.py /tmp/big.wav --read-only
+"""
+import argparse
+import os
+import shutil
+import struct
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+DEFAULT_BLOCKS = ['64K', '256K', '1M', '4M', '16M']
+
+
+def make_wav(path: Path, gigabytes: float, channels: int, sample_width: int, sample_rate: int):
+    """Write a noise WAV of roughly `gigabytes` GB (real data, not a sparse hole)."""
+    block_align = channels * sample_width
+    frames = int(gigabytes * 1024 ** 3) // block_align
+    data_size = frames * block_align
+    fmt = struct.pack('<HHIIHH', 1, channels, sample_rate, sample_rate * block_align,
+                      block_align, sample_width * 8)
+    with open(path, 'wb') as fh:
+        fh.write(b'RIFF' + struct.pack('<I', 4 + 24 + 8 + data_size) + b'WAVE')
+        fh.write(b'fmt ' + struct.pack('<I', len(fmt)) + fmt)
+        fh.write(b'data' + struct.pack('<I', data_size))
+        chunk = 8 * 1024 * 1024
+        remaining = data_size
+        while remaining > 0:
+            n = min(chunk, remaining)
+            fh.write(os.urandom(n))
+            remaining -= n
+
+
+def run_one(wav_path: Path, out_dir: Path, block: str, preallocate: bool, mode: str, fsync: str) -> dict:
+    import aaf2
+    from wav_to_aaf import EssenceWriter, parse_byte_size, WAVMetadataExtractor
+
+    header = WAVMetadataExtractor().read_riff_header(str(wav_path))
+    writer = EssenceWriter(block_size=parse_byte_size(block), preallocate=preallocate,
+                           fsync=fsync, mode=mode)
+    out = out_dir / f"bench_{mode}_{block}_{'pre' if preallocate else 'nopre'}.aaf"
+    if out.exists():
+        out.unlink()
+    start = time.perf_counter()
+    with aaf2.open(str(out), 'w') as f:
+        if header['channels'] > 1:
+            mobs = writer.embed_channels(f, wav_path, wav_path.stem, header['sample_rate'])
+        else:
+            mob = f.create.SourceMob(wav_path.stem)
+            mobs = [writer.embed_into(f, mob, wav_path, header['sample_rate'])]
+        for mob in mobs:
+            f.content.mobs.append(mob)
+    writer.finalize(str(out))
+    seconds = time.perf_counter() - start
+    size = out.stat().st_size
+    out.unlink()
+    return {
+        'mode': mode, 'block': block, 'preallocate': preallocate, 'seconds': seconds,
+        'mb_per_sec': header['data_size'] / seconds / 1e6 if seconds > 0 else 0.0,
+        'writes': writer.stats['writes'], 'output_mb': size / 1e6,
+    }
+
+
+def run_read(wav_path: Path, block: str) -> dict:
+    from wav_to_aaf import EssenceWriter, parse_byte_size
+
+    writer = EssenceWriter(block_size=parse_byte_size(block))
+    header = writer._source(wav_path)
+    channels, sample_width = header['channels'], header['sample_width']
+    reads = 0
+    start = time.perf_counter()
+    for data in writer._blocks(wav_path, header):
+        if channels > 1:
+            writer._split_block(data, channels, sample_width)
+        reads += 1
+    seconds = time.perf_counter() - start
+    return {
+        'mode': 'read', 'block': block, 'preallocate': False, 'seconds': seconds,
+        'mb_per_sec': header['data_size'] / seconds / 1e6 if seconds > 0 else 0.0,
+        'writes': reads, 'output_mb': 0.0,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Sweep essence writer block sizes on a large WAV")
+    parser.add_argument('wav', help='Input WAV (created with --make-gb if missing)')
+    parser.add_argument('--make-gb', type=float, default=None, help='Generate the WAV at this size in GB first')
+    parser.add_argument('--channels', type=int, default=2, help='Channels for a generated WAV (default: 2)')
+    parser.add_argument('--bits', type=int, choices=[16, 24], default=24, help='Bit depth for a generated WAV')
+    parser.add_argument('--blocks', nargs='+', default=DEFAULT_BLOCKS, help='Block sizes to sweep')
+    parser.add_argument('--modes', nargs='+', choices=['stream', 'import'], default=['stream', 'import'])
+    parser.add_argument('--fsync', choices=['none', 'close'], default='close',
+                        help='fsync policy per run (default: close, so runs include the flush)')
+    parser.add_argument('--read-only', action='store_true',
+                        help='Time only the block reader and channel split (no AAF written)')
+    parser.add_argument('--out', default=None, help='Directory for the AAFs (default: temp directory)')
+    args = parser.parse_args()
+
+    sys.path.insert(0, str(ROOT))
+    wav_path = Path(args.wav)
+    if args.make_gb:
+        print(f"Writing {args.make_gb} GB test WAV to {wav_path}…", flush=True)
+        make_wav(wav_path, args.make_gb, args.channels, args.bits // 8, 48000)
+    if not wav_path.exists():
+        parser.error(f"{wav_path} does not exist (use --make-gb to create it)")
+
+    cleanup = args.out is None
+    out_dir = Path(args.out or tempfile.mkdtemp(prefix='w2a_essence_'))
+    out_dir.mkdir(parents=True, exist_ok=True)
+    results = []
+    try:
+        for block in args.blocks if args.read_only else []:
+            print(f"  read block={block}…", flush=True)
+            results.append(run_read(wav_path, block))
+        for mode in [] if args.read_only else args.modes:
+            for block in args.blocks:
+                for preallocate in (True, False):
+                    print(f"  {mode} block={block} preallocate={preallocate}…", flush=True)
+                    results.append(run_one(wav_path, out_dir, block, preallocate, mode, args.fsync))
+    finally:
+        if cleanup:
+            shutil.rmtree(out_dir, ignore_errors=True)
+
+    header = f"{'mode':<8}{'block':>7}{'prealloc':>10}{'seconds':>10}{'MB/s':>9}{'writes':>9}{'out MB':>10}"
+    print(header)
+    print('-' * len(header))
+    for r in results:
+        print(f"{r['mode']:<8}{r['block']:>7}{str(r['preallocate']):>10}{r['seconds']:>10.2f}"
+              f"{r['mb_per_sec']:>9.1f}{r['writes']:>9}{r['output_mb']:>10.1f}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""
+Scaling benchmark for multi-clip AAF builds (create_multi_aaf / create_multi_tape_aaf).
+
+Builds one multi-clip AAF per clip count (default 1k, 5k, 20k, 100k) from synthetic clip
+entries, each in its own child process so peak RSS is per build, and reports:
+  - build time (mob graph) and save time (writing the compound file), µs per clip
+  - per-clip time of the first and last tenth of the build; a last/first ratio well above 1
+    means each clip costs more as the file grows (superlinear)
+  - peak RSS and RSS growth per clip
+
+No WAVs are read: entries carry realistic metadata (BEXT, INFO, UCS, 1-8 channels) and
+paths that don't exist, so locators are skipped and UMIDs stay unique per clip.
+
+--append-only times nothing but f.content.mobs.append of bare MasterMobs (the one per-clip
+operation that touches the file-wide mob set), to tell its scaling apart from the clip builders'.
+
+--pause-gc disables cyclic garbage collection in the child, to see how much of the per-clip
+cost is collections of the growing graph.
+
+With --check, exits non-zero when per-clip time at the largest count exceeds --max-ratio
+times that at the smallest, or when any build's last/first tenth ratio does. Both are
+ratios within one run; there is no stored baseline.
+
+Usage:
+    python dev/bench_multi_aaf_scaling.py
+    python dev/bench_multi_aaf_scaling.py --counts 1000 5000 20000 --tape-mode
+    python dev/bench_multi_aaf_scaling.py --counts 1000 20000 --check --max-ratio 1.5
+    python dev/bench_multi_aaf_scaling.py --counts 5000 --mob-prototypes --cprofile
+    python dev/bench_multi_aaf_scaling.py --counts 1000 20000 --pause-gc
+    python dev/bench_multi_aaf_scaling.py --append-only --counts 1000 100000 --check
+"""
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+DEFAULT_COUNTS = [1000, 5000, 20000, 100000]
+CHANNEL_MIX = (1, 2, 2, 2, 6, 8)
+
+
+def _rss_mb() -> float:
+    """Current RSS (Linux /proc; falls back to peak RSS elsewhere)"""
+    try:
+        with open('/proc/self/statm', 'r') as fh:
+            return int(fh.read().split()[1]) * os.sysconf('SC_PAGE_SIZE') / (1024 * 1024)
+    except (OSError, ValueError, IndexError):
+        return _peak_rss_mb()
+
+
+def _peak_rss_mb() -> float:
+    try:
+        import resource
+        peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        return peak / (1024 * 1024) if sys.platform == 'darwin' else peak / 1024
+    except Exception:
+        return float('nan')
+
+
+def make_entries(count: int, root: str = '/nonexistent/w2a_scaling') -> list:
+    """Synthetic multi-AAF entries shaped like _extract_file_record output plus UCS"""
+    entries = []
+    for n in range(count):
+        channels = CHANNEL_MIX[n % len(CHANNEL_MIX)]
+        name = f"SFX_{n:06d}_Door_Wood_Close.wav"
+        entries.append({
+            'wav_metadata': {
+                'filename': name, 'filepath': f"{root}/roll{n // 500:03d}/{name}",
+                'channels': channels, 'sample_rate': 48000, 'sample_width': 3,
+                'frames': 48000 * (5 + n % 55),
+            },
+            'bext_metadata': {
+                'description': f"Door wood close, take {n}", 'originator': 'Recorder',
+                'originator_reference': f"REF{n:08d}", 'origination_date': '2024-05-01',
+                'origination_time': '10:00:00', 'time_reference': n * 48000 * 60,
+            },
+            'info_metadata': {'IART': 'Library', 'ICMT': 'Scaling benchmark', 'INAM': name[:-4]},
+            'xml_metadata': {},
+            'ucs_metadata': {'primary_category': {'id': 'DOORWood', 'full_name': 'DOORS-WOOD',
+                                                  'category': 'DOORS', 'subcategory': 'WOOD', 'score': 100.0}},
+        })
+    return entries
+
+
+class TimedEntries(list):
+    """Entry list that records elapsed time and RSS each time the builder passes a slice boundary"""
+
+    def __init__(self, entries, slices: int = 10):
+        super().__init__(entries)
+        self.step = max(1, len(entries) // slices)
+        self.marks = []
+
+    def __iter__(self):
+        start = time.perf_counter()
+        for n, entry in enumerate(list.__iter__(self)):
+            if n % self.step == 0:
+                self.marks.append((n, time.perf_counter() - start, _rss_mb()))
+            yield entry
+        self.marks.append((len(self), time.perf_counter() - start, _rss_mb()))
+
+
+class AppendOnly:
+    """Builder stand-in that only creates a MasterMob per entry and appends it to the file"""
+
+    @staticmethod
+    def run(entries, out: str):
+        import aaf2
+        with aaf2.open(out, 'w') as f:
+            for n, _ in enumerate(entries):
+                mob = f.create.MasterMob(f"clip{n}")
+                mob.mob_id = aaf2.mobid.MobID.new()
+                f.content.mobs.append(mob)
+
+
+def run_child(count: int, out_dir: str, tape_mode: bool, mob_prototypes: bool, cprofile: bool,
+              append_only: bool = False, pause_gc: bool = False) -> dict:
+    """Build one AAF of `count` clips in this process and return its measurements"""
+    sys.path.insert(0, str(ROOT))
+    import io
+    from contextlib import redirect_stdout
+    with redirect_stdout(io.StringIO()):
+        from wav_to_aaf import AAFGenerator
+        generator = AAFGenerator()
+    generator.mob_prototypes = mob_prototypes
+    entries = TimedEntries(make_entries(count))
+    rss_before = _rss_mb()
+    out = Path(out_dir) / f"scaling_{count}.aaf"
+
+    if pause_gc:
+        import gc
+        gc.disable()
+    profiler = None
+    if cprofile:
+        import cProfile
+        profiler = cProfile.Profile()
+        profiler.enable()
+    start = time.perf_counter()
+    try:
+        if append_only:
+            AppendOnly.run(entries, str(out))
+        elif tape_mode:
+            generator.create_multi_tape_aaf(entries, str(out), fps=24)
+        else:
+            generator.create_multi_aaf(entries, str(out), fps=24)
+    except Exception as e:
+        return {'count': count, 'error': str(e)}
+    total = time.perf_counter() - start
+    if profiler is not None:
+        import pstats
+        profiler.disable()
+        pstats.Stats(profiler, stream=sys.stderr).sort_stats('cumulative').print_stats(25)
+
+    # The loop ends at the last mark; the rest of the call is closing (saving) the file
+    _, build_seconds, rss_built = entries.marks[-1]
+    first = entries.marks[1] if len(entries.marks) > 2 else entries.marks[-1]
+    last_two = entries.marks[-2:]
+    first_us = first[1] / max(1, first[0]) * 1e6
+    last_us = (last_two[1][1] - last_two[0][1]) / max(1, last_two[1][0] - last_two[0][0]) * 1e6
+    result = {
+        'count': count,
+        'build_seconds': build_seconds,
+        'save_seconds': total - build_seconds,
+        'us_per_clip': total / count * 1e6,
+        'first_tenth_us': first_us,
+        'last_tenth_us': last_us,
+        'tenth_ratio': last_us / first_us if first_us else float('nan'),
+        'peak_rss_mb': _peak_rss_mb(),
+        'kb_per_clip': (rss_built - rss_before) * 1024 / count,
+        'aaf_mb': out.stat().st_size / 1e6 if out.exists() else 0.0,
+    }
+    if out.exists():
+        out.unlink()
+    return result
+
+
+def run_in_child(count: int, out_dir: str, tape_mode: bool, mob_prototypes: bool, cprofile: bool,
+                 append_only: bool = False, pause_gc: bool = False) -> dict:
+    cmd = [sys.executable, __file__, '--child', str(count), '--out', out_dir]
+    if append_only:
+        cmd.append('--append-only')
+    if pause_gc:
+        cmd.append('--pause-gc')
+    if tape_mode:
+        cmd.append('--tape-mode')
+    if mob_prototypes:
+        cmd.append('--mob-prototypes')
+    if cprofile:
+        cmd.append('--cprofile')
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, text=True)
+    try:
+        return json.loads(proc.stdout.strip().splitlines()[-1])
+    except (ValueError, IndexError):
+        return {'count': count, 'error': f"child exited with {proc.returncode}"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-clip time and memory of multi-clip AAF builds by clip count")
+    parser.add_argument('--counts', type=int, nargs='+', default=DEFAULT_COUNTS, help='Clip counts to build')
+    parser.add_argument('--tape-mode', action='store_true', help='Benchmark create_multi_tape_aaf instead')
+    parser.add_argument('--mob-prototypes', action='store_true',
+                        help='Clone each clip\'s mobs from a per-shape prototype instead of building them')
+    parser.add_argument('--cprofile', action='store_true', help='Print the top cProfile entries of each build to stderr')
+    parser.add_argument('--append-only', action='store_true',
+                        help='Time only content.mobs.append of bare MasterMobs instead of full clip builds')
+    parser.add_argument('--pause-gc', action='store_true',
+                        help='Disable cyclic GC for the whole build, to measure what collections cost')
+    parser.add_argument('--out', default=None, help='Directory for the AAFs (default: temp directory)')
+    parser.add_argument('--check', action='store_true',
+                        help='Fail when per-clip cost grows across the counts of this run or within a build')
+    parser.add_argument('--max-ratio', type=float, default=1.5,
+                        help='Largest allowed per-clip time ratio for --check (default: 1.5)')
+    parser.add_argument('--child', type=int, default=None, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child is not None:
+        result = run_child(args.child, args.out, args.tape_mode, args.mob_prototypes, args.cprofile,
+                           args.append_only, args.pause_gc)
+        print(json.dumps(result))
+        return 0
+
+    cleanup = args.out is None
+    out_dir = args.out or tempfile.mkdtemp(prefix='w2a_scaling_')
+    Path(out_dir).mkdir(parents=True, exist_ok=True)
+    results = []
+    try:
+        for count in sorted(args.counts):
+            print(f"  building {count} clips…", flush=True)
+            results.append(run_in_child(count, out_dir, args.tape_mode, args.mob_prototypes, args.cprofile,
+                                        args.append_only, args.pause_gc))
+    finally:
+        if cleanup:
+            shutil.rmtree(out_dir, ignore_errors=True)
+
+    header = (f"{'clips':>8}{'build s':>9}{'save s':>8}{'µs/clip':>9}{'1st 10%':>9}{'last 10%':>10}"
+              f"{'ratio':>7}{'peak MB':>9}{'KB/clip':>9}{'AAF MB':>8}")
+    print(header)
+    print('-' * len(header))
+    ok = [r for r in results if 'error' not in r]
+    for r in results:
+        if 'error' in r:
+            print(f"{r['count']:>8} ERROR: {r['error']}")
+            continue
+        print(f"{r['count']:>8}{r['build_seconds']:>9.2f}{r['save_seconds']:>8.2f}{r['us_per_clip']:>9.0f}"
+              f"{r['first_tenth_us']:>9.0f}{r['last_tenth_us']:>10.0f}{r['tenth_ratio']:>7.2f}"
+              f"{r['peak_rss_mb']:>9.0f}{r['kb_per_clip']:>9.1f}{r['aaf_mb']:>8.1f}")
+
+    if args.check:
+        failures = [f"{r['count']}: build errored" for r in results if 'error' in r]
+        if len(ok) >= 2:
+            growth = ok[-1]['us_per_clip'] / ok[0]['us_per_clip']
+            if growth > args.max_ratio:
+                failures.append(f"µs/clip grows {growth:.2f}x from {ok[0]['count']} to {ok[-1]['count']} clips")
+        for r in ok:
+            if r['count'] >= 1000 and r['tenth_ratio'] > args.max_ratio:
+                failures.append(f"{r['count']}: last tenth {r['tenth_ratio']:.2f}x slower per clip than the first")
+        if failures:
+            print("\nCHECK FAILED:\n  " + "\n  ".join(failures))
+            return 1
+        print(f"\nCheck passed: per-clip cost within {args.max_ratio:g}x across clip counts")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+Library-scale benchmark for WAVsToAAF batch modes.
+
+Runs process_directory over a (usually synthetic, see make_sparse_library.py) tree in
+linked per-clip, ALE-only and one-AAF modes. Each mode runs in its own child process
+so peak RSS is per mode. Reports files/sec, peak RSS and syscalls per file:
+  - read/write syscalls come from /proc/self/io (Linux)
+  - with --strace, the total syscall count from `strace -f -c` is reported as well
+
+Usage:
+    python dev/make_sparse_library.py /tmp/sparse_lib --count 100000
+    python dev/bench_scale.py /tmp/sparse_lib --out /tmp/sparse_out
+    python dev/bench_scale.py /tmp/sparse_lib --modes ale linked --cprofile
+    python dev/bench_scale.py /tmp/sparse_lib --modes one_aaf --mob-prototypes
+"""
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+MODES = ('linked', 'ale', 'one_aaf')
+
+
+def _proc_io() -> dict:
+    counters = {}
+    try:
+        with open('/proc/self/io', 'r') as fh:
+            for line in fh:
+                key, _, value = line.partition(':')
+                counters[key.strip()] = int(value.strip())
+    except (OSError, ValueError):
+        pass
+    return counters
+
+
+def _peak_rss_mb() -> float:
+    try:
+        import resource
+        peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        # Linux reports KiB, macOS reports bytes
+        return peak / (1024 * 1024) if sys.platform == 'darwin' else peak / 1024
+    except Exception:
+        return float('nan')
+
+
+def run_child(mode: str, input_dir: str, output_dir: str, cprofile: bool, mob_prototypes: bool = False) -> dict:
+    """Run one mode in this process and return its measurements."""
+    sys.path.insert(0, str(ROOT))
+    from wav_to_aaf import WAVsToAAFProcessor
+
+    kwargs = {'embed_audio': False}
+    if mode == 'ale':
+        kwargs['ale_only'] = True
+    elif mode == 'one_aaf':
+        kwargs['one_aaf'] = True
+        kwargs['emit_ale'] = True
+
+    real_stdout = sys.stdout
+    devnull = open(os.devnull, 'w')
+    io_before = _proc_io()
+    profiler = None
+    if cprofile:
+        import cProfile
+        profiler = cProfile.Profile()
+    start = time.perf_counter()
+    try:
+        sys.stdout = devnull
+        processor = WAVsToAAFProcessor()
+        processor.generator.mob_prototypes = mob_prototypes
+        discover_start = time.perf_counter()
+        wav_count = len(processor.discover_wav_files(Path(input_dir)))
+        discover_secs = time.perf_counter() - discover_start
+        if profiler:
+            profiler.enable()
+        run_start = time.perf_counter()
+        ret = processor.process_directory(input_dir, output_dir, **kwargs)
+        run_secs = time.perf_counter() - run_start
+        if profiler:
+            profiler.disable()
+    finally:
+        sys.stdout = real_stdout
+        devnull.close()
+    total_secs = time.perf_counter() - start
+    io_after = _proc_io()
+
+    result = {
+        'mode': mode,
+        'returncode': ret,
+        'files': wav_count,
+        'discovery_seconds': round(discover_secs, 3),
+        'run_seconds': round(run_secs, 3),
+        'total_seconds': round(total_secs, 3),
+        'files_per_sec': round(wav_count / run_secs, 1) if run_secs > 0 else None,
+        'peak_rss_mb': round(_peak_rss_mb(), 1),
+    }
+    if io_before and io_after and wav_count:
+        result['read_syscalls_per_file'] = round((io_after['syscr'] - io_before['syscr']) / wav_count, 2)
+        result['write_syscalls_per_file'] = round((io_after['syscw'] - io_before['syscw']) / wav_count, 2)
+        result['bytes_read_per_file'] = int((io_after['rchar'] - io_before['rchar']) / wav_count)
+    if profiler:
+        import io
+        import pstats
+        buf = io.StringIO()
+        pstats.Stats(profiler, stream=buf).sort_stats('cumulative').print_stats(15)
+        result['cprofile'] = buf.getvalue()
+    return result
+
+
+def _strace_total(path: str) -> int:
+    """Parse the 'total' row of an `strace -c` summary."""
+    try:
+        with open(path, 'r') as fh:
+            for line in fh:
+                parts = line.split()
+                if parts and parts[-1] == 'total':
+                    # columns: % time, seconds, usecs/call, calls, [errors], total
+                    numbers = [p for p in parts[:-1] if p.isdigit()]
+                    return int(numbers[0]) if numbers else -1
+    except OSError:
+        pass
+    return -1
+
+
+def run_mode(mode: str, input_dir: str, output_root: Path, use_strace: bool, cprofile: bool,
+             mob_prototypes: bool = False) -> dict:
+    out_dir = output_root / mode
+    if out_dir.exists():
+        shutil.rmtree(out_dir)
+    cmd = [sys.executable, __file__, input_dir, '--child', mode, '--out', str(out_dir)]
+    if cprofile:
+        cmd.append('--cprofile')
+    if mob_prototypes:
+        cmd.append('--mob-prototypes')
+    strace_file = None
+    if use_strace:
+        strace_file = tempfile.NamedTemporaryFile(prefix=f'strace_{mode}_', suffix='.txt', delete=False).name
+        cmd = ['strace', '-f', '-c', '-o', strace_file] + cmd
+    proc = subprocess.run(cmd, capture_output=True, text=True)
+    if proc.returncode != 0:
+        return {'mode': mode, 'error': proc.stderr.strip()[-2000:]}
+    result = json.loads(proc.stdout.strip().splitlines()[-1])
+    if strace_file:
+        total = _strace_total(strace_file)
+        if total >= 0 and result.get('files'):
+            result['syscalls_per_file'] = round(total / result['files'], 2)
+        os.unlink(strace_file)
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Scale benchmark for WAVsToAAF batch modes")
+    parser.add_argument('input', help='Input library directory (see dev/make_sparse_library.py)')
+    parser.add_argument('--out', default=None, help='Output root (default: temp directory, removed afterwards)')
+    parser.add_argument('--modes', nargs='+', choices=MODES, default=list(MODES), help='Modes to run')
+    parser.add_argument('--strace', action='store_true', help='Also count all syscalls with strace -f -c')
+    parser.add_argument('--cprofile', action='store_true', help='Print the top cumulative cProfile entries per mode')
+    parser.add_argument('--json', action='store_true', help='Print raw JSON results')
+    parser.add_argument('--mob-prototypes', action='store_true',
+                        help='Clone one-AAF clips from per-shape prototypes (compare against building from scratch)')
+    parser.add_argument('--child', choices=MODES, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        print(json.dumps(run_child(args.child, args.input, args.out, args.cprofile,
+                                   args.mob_prototypes)))
+        return 0
+
+    if args.strace and not shutil.which('strace'):
+        parser.error('--strace requested but strace is not installed')
+
+    cleanup = args.out is None
+    output_root = Path(args.out or tempfile.mkdtemp(prefix='w2a_scale_'))
+    results = []
+    try:
+        for mode in args.modes:
+            print(f"Running {mode}…", flush=True)
+            results.append(run_mode(mode, args.input, output_root, args.strace, args.cprofile,
+                                    args.mob_prototypes))
+    finally:
+        if cleanup:
+            shutil.rmtree(output_root, ignore_errors=True)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return 0
+
+    header = f"{'mode':<9}{'files':>9}{'files/s':>10}{'peak RSS MB':>13}{'rd sys/f':>10}{'wr sys/f':>10}{'all sys/f':>11}"
+    print(header)
+    print('-' * len(header))
+    for r in results:
+        if 'error' in r:
+            print(f"{r['mode']:<9} ERROR: {r['error']}")
+            continue
+        print(f"{r['mode']:<9}{r['files']:>9}{r.get('files_per_sec') or 0:>10}{r['peak_rss_mb']:>13}"
+              f"{r.get('read_syscalls_per_file', '-'):>10}{r.get('write_syscalls_per_file', '-'):>10}"
+              f"{r.get('syscalls_per_file', '-'):>11}")
+    for r in results:
+        if r.get('cprofile'):
+            print(f"\n=== cProfile: {r['mode']} ===\n{r['cprofile']}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""
+Compare 512-byte (version 3) and 4096-byte (version 4) sector compound files for embedded AAFs.
+
+For each sector size, embeds the same WAV with process_single_file and reports:
+  - write time and MB/s
+  - open time (aaf2.open + walking the mobs, what an importer does first)
+  - full essence read time and MB/s
+  - AAF size
+Import compatibility still has to be checked by hand: the AAFs are kept with --keep so they
+can be imported into Media Composer / Pro Tools.
+
+Usage:
+    python dev/bench_sector_size.py /tmp/big.wav --make-gb 2
+    python dev/bench_sector_size.py /tmp/big.wav --out /tmp/sector_aafs --keep
+"""
+import argparse
+import os
+import shutil
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+sys.path.insert(0, str(ROOT))
+sys.path.insert(0, str(ROOT / 'dev'))
+
+
+def open_and_read(aaf_path: Path) -> dict:
+    import aaf2
+    start = time.perf_counter()
+    with aaf2.open(str(aaf_path), 'r') as f:
+        mobs = list(f.content.mobs)
+        for mob in mobs:
+            list(mob.slots)
+        opened = time.perf_counter() - start
+        read_start = time.perf_counter()
+        total = 0
+        for essence in f.content.essencedata:
+            stream = essence.open('r')
+            while True:
+                block = stream.read(4 * 1024 * 1024)
+                if not block:
+                    break
+                total += len(block)
+        read_secs = time.perf_counter() - read_start
+    return {'open_seconds': opened, 'read_seconds': read_secs, 'essence_bytes': total}
+
+
+def run(wav_path: Path, out_dir: Path, sector_size: str) -> dict:
+    from wav_to_aaf import WAVsToAAFProcessor
+    out = out_dir / f"{wav_path.stem}_sector{sector_size}.aaf"
+    processor = WAVsToAAFProcessor()
+    processor.generator.sector_size = int(sector_size)
+    real_stdout = sys.stdout
+    start = time.perf_counter()
+    try:
+        sys.stdout = open(os.devnull, 'w')
+        ret = processor.process_single_file(str(wav_path), str(out), embed_audio=True)
+    finally:
+        sys.stdout.close()
+        sys.stdout = real_stdout
+    write_secs = time.perf_counter() - start
+    if ret != 0 or not out.exists():
+        return {'sector': sector_size, 'error': f"process_single_file returned {ret}"}
+    result = {'sector': sector_size, 'write_seconds': write_secs, 'aaf_bytes': out.stat().st_size, 'path': out}
+    result.update(open_and_read(out))
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="512 vs 4096 sector compound files for embedded AAFs")
+    parser.add_argument('wav', help='Input WAV (created with --make-gb if missing)')
+    parser.add_argument('--make-gb', type=float, default=None, help='Generate the WAV at this size in GB first')
+    parser.add_argument('--channels', type=int, default=2, help='Channels for a generated WAV (default: 2)')
+    parser.add_argument('--out', default=None, help='Directory for the AAFs (default: temp directory)')
+    parser.add_argument('--keep', action='store_true', help='Keep the AAFs for import testing')
+    args = parser.parse_args()
+
+    wav_path = Path(args.wav)
+    if args.make_gb:
+        from bench_essence_writer import make_wav
+        print(f"Writing {args.make_gb} GB test WAV to {wav_path}…", flush=True)
+        make_wav(wav_path, args.make_gb, args.channels, 3, 48000)
+    if not wav_path.exists():
+        parser.error(f"{wav_path} does not exist (use --make-gb to create it)")
+
+    out_dir = Path(args.out or tempfile.mkdtemp(prefix='w2a_sector_'))
+    out_dir.mkdir(parents=True, exist_ok=True)
+    results = [run(wav_path, out_dir, sector) for sector in ('512', '4096')]
+
+    header = f"{'sector':>7}{'write s':>9}{'write MB/s':>12}{'open s':>9}{'read s':>9}{'read MB/s':>11}{'AAF MB':>10}"
+    print(header)
+    print('-' * len(header))
+    for r in results:
+        if 'error' in r:
+            print(f"{r['sector']:>7} ERROR: {r['error']}")
+            continue
+        mb = r['essence_bytes'] / 1e6
+        print(f"{r['sector']:>7}{r['write_seconds']:>9.2f}{mb / r['write_seconds']:>12.1f}{r['open_seconds']:>9.3f}"
+              f"{r['read_seconds']:>9.2f}{mb / max(r['read_seconds'], 1e-9):>11.1f}{r['aaf_bytes'] / 1e6:>10.1f}")
+    if args.keep:
+        print(f"\nAAFs kept in {out_dir} for import testing")
+    elif args.out is None:
+        shutil.rmtree(out_dir, ignore_errors=True)
+    else:
+        for r in results:
+            if r.get('path'):
+                Path(r['path']).unlink()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Compare per-clip and shared TapeDescriptor SourceMobs in multi-clip tape-mode AAFs.
+
+Generates short WAVs spread over a few "roll" folders (each clip gets a BEXT time
+reference), writes one tape-mode AAF with create_multi_tape_aaf both ways and reports:
+  - write time
+  - open time (aaf2.open + walking every mob's slots, what an importer does first)
+  - mob, slot and total object counts
+  - AAF size
+
+Usage:
+    python dev/bench_shared_tapes.py --clips 500 --rolls 4
+    python dev/bench_shared_tapes.py --clips 2000 --rolls 10 --repeat 3
+"""
+import argparse
+import shutil
+import struct
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+sys.path.insert(0, str(ROOT))
+sys.path.insert(0, str(ROOT / 'dev'))
+
+
+def make_bwf(path: Path, seconds: float, time_reference: int, sample_rate: int = 48000):
+    frames = int(seconds * sample_rate)
+    bext = bytearray(602)
+    bext[338:346] = struct.pack('<Q', time_reference)
+    fmt = struct.pack('<HHIIHH', 1, 1, sample_rate, sample_rate * 2, 2, 16)
+    data = bytes(frames * 2)
+    body = (b'WAVE' + b'fmt ' + struct.pack('<I', len(fmt)) + fmt
+            + b'bext' + struct.pack('<I', len(bext)) + bext
+            + b'data' + struct.pack('<I', len(data)) + data)
+    path.write_bytes(b'RIFF' + struct.pack('<I', len(body)) + body)
+
+
+def build_entries(work: Path, clips: int, rolls: int):
+    from wav_to_aaf import WAVsToAAFProcessor
+    processor = WAVsToAAFProcessor()
+    entries = []
+    for n in range(clips):
+        roll = work / f"Roll_{n % rolls:02d}"
+        roll.mkdir(exist_ok=True)
+        wav = roll / f"take_{n:05d}.wav"
+        make_bwf(wav, 0.5, (3600 + n * 5) * 48000)
+        entries.append(processor._extract_file_record(wav))
+    return entries
+
+
+def run(entries, out: Path, shared: bool) -> dict:
+    import aaf2
+    from compare_interleaved_embed import count_objects
+    from wav_to_aaf import AAFGenerator
+    generator = AAFGenerator()
+    generator.shared_tapes = shared
+    start = time.perf_counter()
+    generator.create_multi_tape_aaf(entries, str(out), fps=25)
+    write_secs = time.perf_counter() - start
+    start = time.perf_counter()
+    with aaf2.open(str(out), 'r') as f:
+        for mob in f.content.mobs:
+            list(mob.slots)
+    open_secs = time.perf_counter() - start
+    result = {'write_seconds': write_secs, 'open_seconds': open_secs, 'aaf_bytes': out.stat().st_size}
+    result.update(count_objects(out))
+    out.unlink()
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-clip vs shared tape SourceMobs in tape-mode AAFs")
+    parser.add_argument('--clips', type=int, default=500, help='Number of clips (default: 500)')
+    parser.add_argument('--rolls', type=int, default=4, help='Number of roll folders / tapes (default: 4)')
+    parser.add_argument('--repeat', type=int, default=1, help='Runs per layout; the fastest is reported')
+    args = parser.parse_args()
+
+    work = Path(tempfile.mkdtemp(prefix='w2a_tapes_'))
+    try:
+        entries = build_entries(work, args.clips, args.rolls)
+        header = f"{'layout':<10}{'write s':>9}{'open s':>9}{'mobs':>7}{'slots':>8}{'objects':>9}{'AAF KB':>9}"
+        print(header)
+        print('-' * len(header))
+        for shared in (False, True):
+            runs = [run(entries, work / 'batch.aaf', shared) for _ in range(max(1, args.repeat))]
+            r = min(runs, key=lambda item: item['write_seconds'])
+            print(f"{'shared' if shared else 'per-clip':<10}{r['write_seconds']:>9.2f}{r['open_seconds']:>9.3f}"
+                  f"{r['mobs']:>7}{r['slots']:>8}{r['objects']:>9}{r['aaf_bytes'] / 1024:>9.0f}")
+    finally:
+        shutil.rmtree(work, ignore_errors=True)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
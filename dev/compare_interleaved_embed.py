@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Compare per-channel and interleaved embedding of multi-channel WAVs.
+
+For each channel count, generates a noise WAV (or uses the given ones), embeds it
+with process_single_file in both layouts and reports wall time, MB/s, AAF size and
+the number of AAF objects written (mobs, mob slots, essence streams, all objects).
+
+Usage:
+    python dev/compare_interleaved_embed.py --channels 2 6 8 --seconds 120
+    python dev/compare_interleaved_embed.py /path/to/poly.wav --repeat 3
+"""
+import argparse
+import os
+import shutil
+import sys
+import tempfile
+import time
+import wave
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+
+
+def make_wav(path: Path, channels: int, seconds: float, sample_width: int = 3, sample_rate: int = 48000):
+    frames = int(seconds * sample_rate)
+    with wave.open(str(path), 'wb') as w:
+        w.setnchannels(channels)
+        w.setsampwidth(sample_width)
+        w.setframerate(sample_rate)
+        step = sample_rate * 10
+        for start in range(0, frames, step):
+            w.writeframes(os.urandom(min(step, frames - start) * channels * sample_width))
+
+
+def count_objects(aaf_path: Path) -> dict:
+    import aaf2
+    counts = {'mobs': 0, 'slots': 0, 'essence': 0, 'objects': 0}
+    seen = set()
+
+    def walk(obj):
+        if id(obj) in seen:
+            return
+        seen.add(id(obj))
+        counts['objects'] += 1
+        for prop in obj.properties():
+            value = getattr(prop, 'value', None)
+            items = value if isinstance(value, (list, tuple)) else [value]
+            for item in items:
+                if hasattr(item, 'properties') and callable(item.properties):
+                    walk(item)
+
+    with aaf2.open(str(aaf_path), 'r') as f:
+        for mob in f.content.mobs:
+            counts['mobs'] += 1
+            counts['slots'] += len(list(mob.slots))
+            walk(mob)
+        counts['essence'] = len(list(f.content.essencedata))
+    return counts
+
+
+def run(wav_path: Path, out_dir: Path, interleaved: bool) -> dict:
+    from wav_to_aaf import WAVsToAAFProcessor
+    out = out_dir / f"{wav_path.stem}_{'interleaved' if interleaved else 'per_channel'}.aaf"
+    processor = WAVsToAAFProcessor()
+    processor.generator.interleaved_embed = interleaved
+    real_stdout = sys.stdout
+    start = time.perf_counter()
+    try:
+        sys.stdout = open(os.devnull, 'w')
+        ret = processor.process_single_file(str(wav_path), str(out), embed_audio=True)
+    finally:
+        sys.stdout.close()
+        sys.stdout = real_stdout
+    seconds = time.perf_counter() - start
+    if ret != 0 or not out.exists():
+        return {'error': f"process_single_file returned {ret}"}
+    result = {'seconds': seconds, 'mb_per_sec': wav_path.stat().st_size / seconds / 1e6,
+              'aaf_mb': out.stat().st_size / 1e6}
+    result.update(count_objects(out))
+    out.unlink()
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-channel vs interleaved embed comparison")
+    parser.add_argument('wavs', nargs='*', help='Multi-channel WAVs to embed (default: generate noise WAVs)')
+    parser.add_argument('--channels', type=int, nargs='+', default=[2, 6], help='Channel counts to generate')
+    parser.add_argument('--seconds', type=float, default=60.0, help='Length of generated WAVs (default: 60)')
+    parser.add_argument('--repeat', type=int, default=1, help='Runs per layout; the fastest is reported')
+    args = parser.parse_args()
+
+    sys.path.insert(0, str(ROOT))
+    work = Path(tempfile.mkdtemp(prefix='w2a_interleave_'))
+    try:
+        wavs = [Path(p) for p in args.wavs]
+        if not wavs:
+            for channels in args.channels:
+                path = work / f"noise_{channels}ch.wav"
+                make_wav(path, channels, args.seconds)
+                wavs.append(path)
+
+        header = (f"{'file':<22}{'layout':<13}{'seconds':>9}{'MB/s':>8}{'AAF MB':>9}"
+                  f"{'mobs':>6}{'slots':>7}{'essence':>9}{'objects':>9}")
+        print(header)
+        print('-' * len(header))
+        for wav_path in wavs:
+            for interleaved in (False, True):
+                runs = [run(wav_path, work, interleaved) for _ in range(max(1, args.repeat))]
+                ok = [r for r in runs if 'error' not in r]
+                layout = 'interleaved' if interleaved else 'per-channel'
+                if not ok:
+                    print(f"{wav_path.name[:21]:<22}{layout:<13} ERROR: {runs[0]['error']}")
+                    continue
+                r = min(ok, key=lambda item: item['seconds'])
+                print(f"{wav_path.name[:21]:<22}{layout:<13}{r['seconds']:>9.2f}{r['mb_per_sec']:>8.1f}"
+                      f"{r['aaf_mb']:>9.1f}{r['mobs']:>6}{r['slots']:>7}{r['essence']:>9}{r['objects']:>9}")
+    finally:
+        shutil.rmtree(work, ignore_errors=True)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+"""
+Accuracy + latency evaluation of the UCS scorers on a labeled corpus.
+
+Every scorer categorizes every (filename, description) pair of the corpus
+(tests/data/ucs_eval_corpus.csv by default) and is reported on:
+  - top-1 accuracy (primary category == label)
+  - top-5 accuracy (label among primary + alternative categories)
+  - low-confidence rate: guesses scoring below --ucs-min-score, as in ucs_low_confidence.csv
+  - per-query latency percentiles (p50/p90/p99/max) in microseconds, after a warm-up pass
+
+Scorers:
+  scalar      UCSProcessor.categorize_sound, one category at a time
+  batch       UCSProcessor.categorize_batch, one query per call (per-query latency)
+  batch-all   UCSProcessor.categorize_batch over the whole corpus (latency = total / queries)
+
+With --check, exits non-zero when any scorer's per-query answers differ from the
+scalar scorer, or when accuracy falls below the baseline (tests/data/ucs_eval_baseline.json).
+--write-baseline records the current scalar accuracy as the new baseline.
+
+Usage:
+    python dev/eval_ucs_matching.py
+    python dev/eval_ucs_matching.py --repeat 5 --ucs-min-score 30 --check
+    python dev/eval_ucs_matching.py --corpus my_library_labels.csv --scorers batch batch-all
+"""
+import argparse
+import csv
+import io
+import json
+import sys
+import time
+from contextlib import redirect_stdout
+from pathlib import Path
+from typing import Callable, Dict, List, Tuple
+
+ROOT = Path(__file__).resolve().parent.parent
+sys.path.insert(0, str(ROOT))
+DEFAULT_CORPUS = ROOT / 'tests' / 'data' / 'ucs_eval_corpus.csv'
+DEFAULT_BASELINE = ROOT / 'tests' / 'data' / 'ucs_eval_baseline.json'
+
+
+def load_corpus(path: Path) -> List[Tuple[str, str, str]]:
+    """(filename, description, expected_id) rows of a labeled corpus CSV"""
+    with open(path, 'r', encoding='utf-8', newline='') as fh:
+        return [(row['filename'], row.get('description') or '', row['expected_id'].strip())
+                for row in csv.DictReader(fh) if row.get('expected_id')]
+
+
+def scorers(ucs) -> Dict[str, Tuple[Callable, bool]]:
+    """name -> (function, whole_corpus): per-query functions take (filename, description),
+    whole-corpus functions take the list of pairs and return one result per pair"""
+    return {
+        'scalar': (lambda filename, description: ucs.categorize_sound(filename, description), False),
+        'batch': (lambda filename, description: ucs.categorize_batch([(filename, description)])[0], False),
+        'batch-all': (ucs.categorize_batch, True),
+    }
+
+
+def ranked_ids(result: Dict) -> List[str]:
+    if not result:
+        return []
+    return [result['primary_category']['id']] + [alt['id'] for alt in result.get('alternative_categories', [])]
+
+
+def percentile(sorted_values: List[float], pct: float) -> float:
+    if not sorted_values:
+        return 0.0
+    rank = min(len(sorted_values) - 1, max(0, int(round(pct / 100.0 * (len(sorted_values) - 1)))))
+    return sorted_values[rank]
+
+
+def evaluate(ucs, corpus: List[Tuple[str, str, str]], scorer: str, min_score: float = 25.0,
+             repeat: int = 1) -> Dict:
+    """Run one scorer over the corpus; returns accuracy, low-confidence and latency figures
+    plus the per-query results (for comparing scorers)"""
+    function, whole_corpus = scorers(ucs)[scorer]
+    pairs = [(filename, description) for filename, description, _ in corpus]
+    # Warm-up: builds lazy indexes and word caches so latency reflects steady state
+    if whole_corpus:
+        function(pairs)
+    else:
+        for filename, description in pairs:
+            function(filename, description)
+
+    latencies: List[float] = []
+    results: List[Dict] = []
+    for _ in range(max(1, repeat)):
+        if whole_corpus:
+            start = time.perf_counter()
+            results = function(pairs)
+            per_query = (time.perf_counter() - start) / max(1, len(pairs))
+            latencies.extend([per_query] * len(pairs))
+        else:
+            results = []
+            for filename, description in pairs:
+                start = time.perf_counter()
+                results.append(function(filename, description))
+                latencies.append(time.perf_counter() - start)
+
+    top1 = top5 = low = 0
+    misses = []
+    for (filename, description, expected), result in zip(corpus, results):
+        ids = ranked_ids(result)
+        if ids[:1] == [expected]:
+            top1 += 1
+        else:
+            misses.append((filename, expected, ids[0] if ids else ''))
+        if expected in ids[:5]:
+            top5 += 1
+        score = result.get('primary_category', {}).get('score', 0.0) if result else 0.0
+        if 0 < score < min_score:
+            low += 1
+    latencies.sort()
+    n = max(1, len(corpus))
+    return {
+        'scorer': scorer,
+        'queries': len(corpus),
+        'top1': top1 / n,
+        'top5': top5 / n,
+        'low_confidence': low / n,
+        'p50_us': percentile(latencies, 50) * 1e6,
+        'p90_us': percentile(latencies, 90) * 1e6,
+        'p99_us': percentile(latencies, 99) * 1e6,
+        'max_us': (latencies[-1] if latencies else 0.0) * 1e6,
+        'misses': misses,
+        'results': results,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="UCS scorer accuracy and latency on a labeled corpus")
+    parser.add_argument('--corpus', default=str(DEFAULT_CORPUS), help='Labeled CSV: filename,description,expected_id')
+    parser.add_argument('--scorers', nargs='+', default=['scalar', 'batch', 'batch-all'],
+                        choices=['scalar', 'batch', 'batch-all'])
+    parser.add_argument('--ucs-min-score', type=float, default=25.0,
+                        help='Low-confidence threshold, as in wav_to_aaf.py (default: 25)')
+    parser.add_argument('--max-edit-distance', type=int, default=1, help='Typo tolerance (default: 1)')
+    parser.add_argument('--repeat', type=int, default=3, help='Timed passes per scorer (default: 3)')
+    parser.add_argument('--baseline', default=str(DEFAULT_BASELINE), help='Baseline accuracy JSON')
+    parser.add_argument('--check', action='store_true',
+                        help='Fail if scorers disagree with scalar or accuracy drops below the baseline')
+    parser.add_argument('--write-baseline', action='store_true', help='Record the scalar accuracy as the baseline')
+    parser.add_argument('--show-misses', action='store_true', help='List top-1 misses of the first scorer')
+    args = parser.parse_args()
+
+    from wav_to_aaf import UCSProcessor
+    with redirect_stdout(io.StringIO()):
+        ucs = UCSProcessor(max_edit_distance=args.max_edit_distance)
+    if not ucs.ucs_loaded:
+        parser.error("no UCS list found in data/")
+    corpus = load_corpus(Path(args.corpus))
+    unknown = sorted({expected for _, _, expected in corpus if expected not in ucs.ucs_data})
+    if unknown:
+        parser.error(f"corpus labels not in the UCS list: {', '.join(unknown)}")
+
+    names = list(args.scorers)
+    if (args.check or args.write_baseline) and 'scalar' not in names:
+        names.insert(0, 'scalar')
+    reports = [evaluate(ucs, corpus, name, args.ucs_min_score, args.repeat) for name in names]
+
+    header = f"{'scorer':<11}{'top-1':>8}{'top-5':>8}{'low conf':>10}{'p50 µs':>10}{'p90 µs':>10}{'p99 µs':>10}{'max µs':>10}"
+    print(f"{len(corpus)} labeled queries from {args.corpus}, min score {args.ucs_min_score:g}")
+    print(header)
+    print('-' * len(header))
+    for r in reports:
+        print(f"{r['scorer']:<11}{r['top1']:>8.1%}{r['top5']:>8.1%}{r['low_confidence']:>10.1%}"
+              f"{r['p50_us']:>10.1f}{r['p90_us']:>10.1f}{r['p99_us']:>10.1f}{r['max_us']:>10.1f}")
+    if args.show_misses:
+        print(f"\nTop-1 misses ({reports[0]['scorer']}):")
+        for filename, expected, got in reports[0]['misses']:
+            print(f"  {filename:<45} expected {expected:<11} got {got or '-'}")
+
+    scalar = next((r for r in reports if r['scorer'] == 'scalar'), None)
+    if args.write_baseline:
+        baseline = {'corpus': Path(args.corpus).name, 'queries': scalar['queries'],
+                    'top1': round(scalar['top1'], 4), 'top5': round(scalar['top5'], 4)}
+        Path(args.baseline).write_text(json.dumps(baseline, indent=2) + '\n')
+        print(f"\nBaseline written to {args.baseline}")
+
+    if args.check:
+        failures = []
+        for r in reports:
+            if r is scalar:
+                continue
+            changed = sum(1 for a, b in zip(r['results'], scalar['results']) if a != b)
+            if changed:
+                failures.append(f"{r['scorer']}: {changed} result(s) differ from scalar")
+        baseline = json.loads(Path(args.baseline).read_text())
+        for r in reports:
+            for key in ('top1', 'top5'):
+                if r[key] + 1e-9 < baseline[key]:
+                    failures.append(f"{r['scorer']}: {key} {r[key]:.1%} below baseline {baseline[key]:.1%}")
+        if failures:
+            print("\nCHECK FAILED:\n  " + "\n  ".join(failures))
+            return 1
+        print("\nCheck passed: all scorers agree with scalar and meet the baseline accuracy")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""
+Build a deep synthetic WAV library for scale testing.
+
+Every file is a real RIFF/WAVE header (fmt, bext, LIST-INFO, iXML, data) whose
+data chunk is left as a sparse hole, so 100k+ files of "minutes" of audio take
+almost no disk. Names follow UCS conventions (CatID_Description_Creator_NN.wav)
+using IDs from data/UCS_v8.2.1_Full_List.csv so UCS matching sees realistic input.
+
+Usage:
+    python dev/make_sparse_library.py /tmp/sparse_lib --count 100000
+    python dev/make_sparse_library.py /tmp/sparse_lib --count 2000 --seconds 5 --depth 3
+"""
+import argparse
+import csv
+import random
+import struct
+import sys
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+UCS_CSV = ROOT / 'data' / 'UCS_v8.2.1_Full_List.csv'
+
+CREATORS = ['JB', 'EC', 'FLD', 'SFXL', 'REC']
+DESCRIPTORS = ['Close', 'Distant', 'Heavy', 'Light', 'Long', 'Short', 'Interior', 'Exterior',
+               'Slow', 'Fast', 'Metallic', 'Wooden', 'Night', 'Day', 'Busy', 'Quiet']
+FORMATS = [
+    # (sample_rate, channels, sample_width)
+    (48000, 1, 3), (48000, 2, 3), (48000, 2, 2), (96000, 2, 3), (48000, 6, 3), (44100, 2, 2),
+]
+
+
+def load_ucs_rows():
+    rows = []
+    try:
+        with open(UCS_CSV, 'r', encoding='utf-8') as fh:
+            for row in csv.DictReader(fh):
+                cat_id = row.get('CatID') or row.get('ID')
+                if cat_id:
+                    syn = [s.strip() for s in (row.get('Synonyms - Comma Separated') or '').split(',') if s.strip()]
+                    rows.append((cat_id, row.get('Category', ''), row.get('SubCategory', ''), syn))
+    except OSError:
+        pass
+    return rows or [('AMBMisc', 'AMBIENCE', 'MISC', ['Room', 'Tone'])]
+
+
+def _chunk(chunk_id: bytes, payload: bytes) -> bytes:
+    pad = b'\x00' if len(payload) % 2 else b''
+    return chunk_id + struct.pack('<I', len(payload)) + payload + pad
+
+
+def build_header(description, originator, originator_ref, date, time_str, time_reference,
+                 info, ixml, sample_rate, channels, sample_width, data_size) -> bytes:
+    """Return every byte of the file up to (and including) the data chunk header."""
+    block_align = channels * sample_width
+    fmt = struct.pack('<HHIIHH', 1, channels, sample_rate, sample_rate * block_align,
+                      block_align, sample_width * 8)
+
+    bext = bytearray(602)
+    bext[0:256] = description.encode('ascii', 'ignore')[:256].ljust(256, b'\x00')
+    bext[256:288] = originator.encode('ascii', 'ignore')[:32].ljust(32, b'\x00')
+    bext[288:320] = originator_ref.encode('ascii', 'ignore')[:32].ljust(32, b'\x00')
+    bext[320:330] = date.encode('ascii')[:10].ljust(10, b'\x00')
+    bext[330:338] = time_str.encode('ascii')[:8].ljust(8, b'\x00')
+    bext[338:346] = struct.pack('<Q', time_reference)
+    bext[346:348] = struct.pack('<H', 1)
+    bext += b'A=PCM,F=%d,W=%d,M=%s\r\n' % (sample_rate, sample_width * 8, b'mono' if channels == 1 else b'stereo')
+
+    info_payload = b'INFO'
+    for key, value in info.items():
+        info_payload += _chunk(key.encode('ascii'), value.encode('utf-8') + b'\x00')
+
+    body = (_chunk(b'fmt ', fmt) + _chunk(b'bext', bytes(bext)) + _chunk(b'LIST', info_payload) +
+            _chunk(b'iXML', ixml.encode('utf-8')))
+    riff_size = 4 + len(body) + 8 + data_size + (data_size % 2)
+    return b'RIFF' + struct.pack('<I', riff_size) + b'WAVE' + body + b'data' + struct.pack('<I', data_size)
+
+
+def make_ixml(project, scene, take, tape, note, sample_rate):
+    return (
+        '<?xml version="1.0" encoding="UTF-8"?>'
+        '<BWFXML><IXML_VERSION>2.10</IXML_VERSION>'
+        f'<PROJECT>{project}</PROJECT><SCENE>{scene}</SCENE><TAKE>{take}</TAKE>'
+        f'<TAPE>{tape}</TAPE><NOTE>{note}</NOTE>'
+        f'<SPEED><TIMECODE_RATE>24/1</TIMECODE_RATE><FILE_SAMPLE_RATE>{sample_rate}</FILE_SAMPLE_RATE></SPEED>'
+        '</BWFXML>'
+    )
+
+
+def plan_dirs(count: int, depth: int, fanout: int, files_per_dir: int):
+    """Yield relative directory tuples for a deep tree until there is room for `count` files."""
+    needed = max(1, (count + files_per_dir - 1) // files_per_dir)
+    produced = 0
+    index = [0] * depth
+    while produced < needed:
+        yield tuple(f"L{level}_{index[level]:03d}" for level in range(depth))
+        produced += 1
+        # odometer increment so siblings fill before going wide
+        for level in reversed(range(depth)):
+            index[level] += 1
+            if index[level] < fanout:
+                break
+            index[level] = 0
+
+
+def generate(root: Path, count: int, seconds: float, depth: int, fanout: int,
+             files_per_dir: int, seed: int) -> int:
+    rng = random.Random(seed)
+    ucs_rows = load_ucs_rows()
+    written = 0
+    for rel in plan_dirs(count, depth, fanout, files_per_dir):
+        folder = root.joinpath(*rel)
+        folder.mkdir(parents=True, exist_ok=True)
+        tape = f"{rel[-1]}_ROLL"
+        day = f"2025-{rng.randint(1, 12):02d}-{rng.randint(1, 28):02d}"
+        for n in range(files_per_dir):
+            if written >= count:
+                return written
+            cat_id, category, subcategory, synonyms = rng.choice(ucs_rows)
+            sample_rate, channels, sample_width = rng.choice(FORMATS)
+            words = [rng.choice(synonyms) if synonyms else subcategory.title(), rng.choice(DESCRIPTORS)]
+            fx_name = ' '.join(w for w in words if w)
+            creator = rng.choice(CREATORS)
+            filename = f"{cat_id}_{fx_name}_{creator}_{n + 1:02d}.wav"
+            frames = int(seconds * sample_rate * rng.uniform(0.25, 2.0))
+            data_size = frames * channels * sample_width
+            start_sec = rng.randint(6 * 3600, 20 * 3600)
+            header = build_header(
+                description=f"{category} {subcategory} {fx_name}".strip(),
+                originator=creator,
+                originator_ref=f"{creator}{written:010d}",
+                date=day,
+                time_str=f"{start_sec // 3600:02d}:{(start_sec // 60) % 60:02d}:{start_sec % 60:02d}",
+                time_reference=start_sec * sample_rate,
+                info={'INAM': fx_name, 'ICMT': f"{category} / {subcategory}",
+                      'IKEY': ', '.join(synonyms[:6]), 'ISFT': 'make_sparse_library'},
+                ixml=make_ixml('SCALE', rel[-1], str(n + 1), tape, fx_name, sample_rate),
+                sample_rate=sample_rate, channels=channels, sample_width=sample_width,
+                data_size=data_size,
+            )
+            path = folder / filename
+            with open(path, 'wb') as fh:
+                fh.write(header)
+                # Extend without writing: the audio payload becomes a sparse hole
+                fh.truncate(len(header) + data_size + (data_size % 2))
+            written += 1
+    return written
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate a sparse synthetic WAV library for scale tests")
+    parser.add_argument('root', help='Output directory for the synthetic library')
+    parser.add_argument('--count', type=int, default=100000, help='Number of WAV files (default: 100000)')
+    parser.add_argument('--seconds', type=float, default=30.0, help='Median clip length in seconds (default: 30)')
+    parser.add_argument('--depth', type=int, default=4, help='Directory depth (default: 4)')
+    parser.add_argument('--fanout', type=int, default=12, help='Subdirectories per level (default: 12)')
+    parser.add_argument('--files-per-dir', type=int, default=40, help='WAVs per leaf directory (default: 40)')
+    parser.add_argument('--seed', type=int, default=76, help='Random seed for reproducible trees')
+    args = parser.parse_args()
+
+    root = Path(args.root)
+    root.mkdir(parents=True, exist_ok=True)
+    written = generate(root, args.count, args.seconds, args.depth, args.fanout, args.files_per_dir, args.seed)
+    print(f"Wrote {written} sparse WAV file(s) under {root}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,100 @@
+import tarfile
+import wave
+import zipfile
+from pathlib import Path
+from wav_to_aaf import EssenceWriter, WAVMetadataExtractor, WAVsToAAFProcessor, list_archive_wavs
+
+
+def _write_wav(path: Path, channels: int = 2, frames: int = 4000):
+    with wave.open(str(path), 'wb') as w:
+        w.setnchannels(channels)
+        w.setsampwidth(2)
+        w.setframerate(48000)
+        w.writeframes(bytes((n * 13) % 256 for n in range(frames * channels * 2)))
+
+
+def _archives(tmp_path: Path):
+    src = tmp_path / 'src'
+    (src / 'Doors').mkdir(parents=True)
+    _write_wav(src / 'Doors' / 'door_close.wav')
+    _write_wav(src / 'rain_loop.wav', channels=1)
+    zip_path = tmp_path / 'lib.zip'
+    with zipfile.ZipFile(zip_path, 'w') as zf:
+        zf.write(src / 'Doors' / 'door_close.wav', 'Doors/door_close.wav', compress_type=zipfile.ZIP_STORED)
+        zf.write(src / 'rain_loop.wav', 'rain_loop.wav', compress_type=zipfile.ZIP_STORED)
+        zf.write(src / 'rain_loop.wav', 'squeezed.wav', compress_type=zipfile.ZIP_DEFLATED)
+        zf.writestr('readme.txt', 'hello')
+    tar_path = tmp_path / 'lib.tar'
+    with tarfile.open(tar_path, 'w') as tf:
+        tf.add(src / 'Doors' / 'door_close.wav', 'Doors/door_close.wav')
+        tf.add(src / 'rain_loop.wav', 'rain_loop.wav')
+    return src, zip_path, tar_path
+
+
+def test_members_read_in_place_match_the_files(tmp_path: Path):
+    src, zip_path, tar_path = _archives(tmp_path)
+    extractor = WAVMetadataExtractor()
+    for archive in (zip_path, tar_path):
+        members, skipped = list_archive_wavs(archive)
+        assert [m.name for m in members] == ['Doors/door_close.wav', 'rain_loop.wav']
+        assert skipped == ([('squeezed.wav', 'compressed (only stored members can be read in place)')]
+                           if archive == zip_path else [])
+        for member in members:
+            on_disk = src / member.name
+            from_archive = extractor.read_riff_header(member)
+            direct = extractor.read_riff_header(str(on_disk))
+            assert from_archive['chunks'] == direct['chunks']
+            assert from_archive['metadata_bytes'] == direct['metadata_bytes']
+            writer = EssenceWriter(block_size=1000)
+            header = writer._source(member)
+            streamed = b''.join(bytes(block) for block in writer._blocks(member, header))
+            assert streamed == on_disk.read_bytes()[direct['data_offset']:]
+
+
+def test_archive_ale_only_and_linked_refused(tmp_path: Path):
+    _, zip_path, tar_path = _archives(tmp_path)
+    proc = WAVsToAAFProcessor()
+    assert proc.process_archive(str(tar_path), str(tmp_path / 'linked'), embed_audio=False) == 1
+    assert not (tmp_path / 'linked').exists()
+
+    assert proc.process_archive(str(zip_path), str(tmp_path / 'out'), ale_only=True) == 0
+    ale = (tmp_path / 'out' / 'batch.ale').read_text()
+    assert 'door_close\tA1A2' in ale and 'rain_loop\tA1' in ale
+    assert 'squeezed' not in ale
+
+
+def test_hostile_member_names_are_skipped(tmp_path: Path):
+    wav = tmp_path / 'x.wav'
+    _write_wav(wav, channels=1)
+    zip_path = tmp_path / 'hostile.zip'
+    with zipfile.ZipFile(zip_path, 'w') as zf:
+        # ZipInfo keeps the raw name (ZipFile.write would normalize it)
+        for name in ('../../escape.wav', '/abs/escape.wav', 'C:/escape.wav', 'ok/safe.wav'):
+            zf.writestr(zipfile.ZipInfo(name), wav.read_bytes())
+    tar_path = tmp_path / 'hostile.tar'
+    with tarfile.open(tar_path, 'w') as tf:
+        tf.add(wav, '../escape.wav')
+        tf.add(wav, 'ok/safe.wav')
+
+    for archive in (zip_path, tar_path):
+        members, skipped = list_archive_wavs(archive)
+        assert [m.name for m in members] == ['ok/safe.wav']
+        assert skipped and all(reason == 'unsafe path' for _, reason in skipped)
+
+    out = tmp_path / 'deep' / 'out'
+    assert WAVsToAAFProcessor().process_archive(str(zip_path), str(out), ale_only=True) == 0
+    assert not list(tmp_path.glob('**/escape*'))
+    assert 'safe' in (out / 'batch.ale').read_text()
+
+
+def test_up_to_date_members_still_get_ale_rows(tmp_path: Path):
+    src, zip_path, _ = _archives(tmp_path)
+    out = tmp_path / 'out'
+    (out / 'Doors').mkdir(parents=True)
+    (out / 'Doors' / 'door_close.aaf').write_bytes(b'')
+    (out / 'rain_loop.aaf').write_bytes(b'')
+    proc = WAVsToAAFProcessor()
+    proc.generator.essence_writer = EssenceWriter(mode='stream')
+    assert proc.process_archive(str(zip_path), str(out), emit_ale=True, skip_up_to_date=True) == 0
+    ale = (out / 'batch.ale').read_text()
+    assert 'door_close.wav' in ale and 'rain_loop.wav' in ale
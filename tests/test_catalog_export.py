@@ -0,0 +1,54 @@
+import os
+import shutil
+import time
+from pathlib import Path
+import pytest
+from wav_to_aaf import CatalogWriter, WAVsToAAFProcessor
+
+pa = pytest.importorskip('pyarrow')
+pq = pytest.importorskip('pyarrow.parquet')
+
+
+def _library(tmp_path: Path, wav: Path, names):
+    src = tmp_path / 'lib'
+    src.mkdir(exist_ok=True)
+    for name in names:
+        shutil.copyfile(str(wav), str(src / name))
+    return src
+
+
+def test_row_types_and_row_groups(tmp_path: Path, tiny_wav_stereo: Path):
+    src = _library(tmp_path, tiny_wav_stereo, [f"DOORWood_close_{n}.wav" for n in range(5)])
+    proc = WAVsToAAFProcessor()
+    catalog = tmp_path / 'catalog.parquet'
+    assert proc.process_catalog(str(src), str(catalog), row_group_size=2) == 0
+
+    meta = pq.ParquetFile(str(catalog)).metadata
+    assert meta.num_rows == 5 and meta.num_row_groups == 3
+    table = pq.read_table(str(catalog))
+    assert table.schema.equals(CatalogWriter.catalog_schema(pa))
+    row = table.slice(0, 1).to_pylist()[0]
+    assert row['channels'] == 2 and row['bit_depth'] == 16 and row['sample_rate'] == 48000
+    assert row['frames'] == 480 and row['ucs_id'] == 'DOORWood' and row['ucs_score'] == 100.0
+
+
+def test_incremental_refresh_reads_only_changed_files(tmp_path: Path, tiny_wav_mono: Path, monkeypatch):
+    src = _library(tmp_path, tiny_wav_mono, ['a.wav', 'b.wav', 'c.wav'])
+    catalog = tmp_path / 'catalog.arrow'
+    proc = WAVsToAAFProcessor()
+    assert proc.process_catalog(str(src), str(catalog)) == 0
+
+    (src / 'c.wav').unlink()
+    shutil.copyfile(str(tiny_wav_mono), str(src / 'd.wav'))
+    later = time.time() + 10
+    os.utime(src / 'a.wav', (later, later))
+
+    read = []
+    original = proc._extract_file_record
+    monkeypatch.setattr(proc, '_extract_file_record', lambda wav, basic_path=None: read.append(wav.name) or original(wav))
+    assert proc.process_catalog(str(src), str(catalog)) == 0
+    assert sorted(read) == ['a.wav', 'd.wav']
+    with pa.memory_map(str(catalog)) as stream:
+        table = pa.ipc.open_file(stream).read_all()
+    assert sorted(Path(p).name for p in table.column('path').to_pylist()) == ['a.wav', 'b.wav', 'd.wav']
+    assert not (tmp_path / 'catalog.arrow.tmp').exists()
@@ -0,0 +1,81 @@
+import hashlib
+import json
+import tarfile
+import wave
+import zipfile
+from pathlib import Path
+import pytest
+from wav_to_aaf import DeliveryPackage, WAVsToAAFProcessor
+
+
+def _members(package: Path) -> dict:
+    if package.suffix == '.zip':
+        with zipfile.ZipFile(package) as zf:
+            assert all(info.compress_type == zipfile.ZIP_STORED for info in zf.infolist())
+            return {name: zf.read(name) for name in zf.namelist()}
+    with tarfile.open(package) as tf:
+        return {m.name: tf.extractfile(m).read() for m in tf.getmembers()}
+
+
+@pytest.mark.parametrize('suffix', ['.zip', '.tar'])
+def test_package_streams_files_with_index_and_checksums(tmp_path: Path, suffix: str):
+    out = tmp_path / 'out'
+    (out / 'Doors').mkdir(parents=True)
+    files = {'Doors/door_close.aaf': bytes(range(256)) * 40000, 'batch.ale': b'Heading\n'}
+    for name, data in files.items():
+        (out / name).write_bytes(data)
+
+    package = DeliveryPackage(tmp_path / f'delivery{suffix}', remove_added=True)
+    package.COPY_BLOCK = 4096  # several blocks per member
+    for name in files:
+        package.add(out / name, name)
+    package.add(out / 'missing.csv', 'missing.csv')
+    package.close()
+
+    members = _members(tmp_path / f'delivery{suffix}')
+    assert not (tmp_path / f'delivery{suffix}.tmp').exists()
+    assert list(members)[-2:] == ['index.json', 'SHA256SUMS']
+    for name, data in files.items():
+        assert members[name] == data
+        assert not (out / name).exists()
+    index = json.loads(members['index.json'])
+    assert [(e['name'], e['size'], e['sha256']) for e in index['files']] == \
+        [(name, len(data), hashlib.sha256(data).hexdigest()) for name, data in files.items()]
+    assert members['SHA256SUMS'].decode() == ''.join(
+        f"{hashlib.sha256(data).hexdigest()}  {name}\n" for name, data in files.items())
+
+
+def test_directory_run_delivers_ale(tmp_path: Path):
+    src = tmp_path / 'src'
+    src.mkdir()
+    with wave.open(str(src / 'rain.wav'), 'wb') as w:
+        w.setnchannels(1)
+        w.setsampwidth(2)
+        w.setframerate(48000)
+        w.writeframes(b'\0\0' * 4800)
+    proc = WAVsToAAFProcessor()
+    proc.package = DeliveryPackage(tmp_path / 'delivery.zip')
+    assert proc.process_directory(str(src), str(tmp_path / 'out'), ale_only=True) == 0
+    proc.package.close()
+    members = _members(tmp_path / 'delivery.zip')
+    assert members['batch.ale'] == (tmp_path / 'out' / 'batch.ale').read_bytes()
+    assert b'rain' in members['batch.ale']
+
+
+def test_duplicate_name_is_refused_and_failures_are_recorded(tmp_path: Path):
+    (tmp_path / 'a').mkdir()
+    (tmp_path / 'b').mkdir()
+    (tmp_path / 'a' / 'clip.aaf').write_bytes(b'first')
+    (tmp_path / 'b' / 'clip.aaf').write_bytes(b'second')
+    proc = WAVsToAAFProcessor()
+    proc.package = DeliveryPackage(tmp_path / 'delivery.zip', remove_added=True)
+    proc._deliver(tmp_path / 'a' / 'clip.aaf', tmp_path / 'a')
+    with pytest.raises(ValueError, match='already in'):
+        proc.package.add(tmp_path / 'b' / 'clip.aaf', 'clip.aaf')
+    proc._deliver(tmp_path / 'b' / 'clip.aaf', tmp_path / 'b')
+    assert [name for name, _ in proc.package.failed] == ['clip.aaf']
+    # Nothing is removed until close(), so aborting keeps every loose output
+    proc.package.abort()
+    assert not (tmp_path / 'delivery.zip').exists()
+    assert (tmp_path / 'a' / 'clip.aaf').read_bytes() == b'first'
+    assert (tmp_path / 'b' / 'clip.aaf').read_bytes() == b'second'
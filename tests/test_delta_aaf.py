@@ -0,0 +1,152 @@
+import csv
+import json
+import os
+import shutil
+import threading
+import time
+from pathlib import Path
+from wav_to_aaf import WAVsToAAFProcessor
+
+
+def _processor(monkeypatch, written):
+    proc = WAVsToAAFProcessor()
+
+    def fake_multi_aaf(entries, output_path, **kwargs):
+        written.append((Path(output_path).name, sorted(e['wav_metadata']['filename'] for e in entries)))
+        Path(output_path).write_bytes(b'AAF')
+        return output_path
+
+    monkeypatch.setattr(proc.generator, 'create_multi_aaf', fake_multi_aaf)
+    return proc
+
+
+def test_delta_writes_only_new_and_changed_clips(tmp_path: Path, tiny_wav_mono: Path, monkeypatch):
+    src, out = tmp_path / 'src', tmp_path / 'out'
+    src.mkdir()
+    for name in ('a.wav', 'b.wav', 'c.wav'):
+        shutil.copyfile(str(tiny_wav_mono), str(src / name))
+
+    written = []
+    proc = _processor(monkeypatch, written)
+    assert proc.process_directory(str(src), str(out), one_aaf=True) == 0
+    assert written == [('batch.aaf', ['a.wav', 'b.wav', 'c.wav'])]
+    first = json.loads((out / 'batch_manifest.json').read_text())['clips']
+    assert len(first) == 3
+
+    later = time.time() + 10
+    os.utime(src / 'b.wav', (later, later))
+    (src / 'c.wav').unlink()
+    shutil.copyfile(str(tiny_wav_mono), str(src / 'd.wav'))
+
+    read = []
+    original = proc._extract_file_record
+    monkeypatch.setattr(proc, '_extract_file_record', lambda wav, basic_path=None: read.append(wav.name) or original(wav))
+    proc.delta = True
+    assert proc.process_directory(str(src), str(out), one_aaf=True) == 0
+    delta_name, clips = written[-1]
+    assert delta_name.startswith('batch_delta_') and clips == ['b.wav', 'd.wav']
+    assert sorted(read) == ['b.wav', 'd.wav']
+
+    with open(out / delta_name.replace('.aaf', '_removed.csv'), newline='') as fh:
+        rows = {row['name']: row for row in csv.DictReader(fh)}
+    assert rows['b.wav']['reason'] == 'changed' and rows['c.wav']['reason'] == 'removed'
+    b_key = 'b.wav'
+    assert rows['b.wav']['master_mob_id'] == first[b_key]['master_mob_id']
+
+    second = json.loads((out / 'batch_manifest.json').read_text())['clips']
+    assert sorted(second) == ['a.wav', 'b.wav', 'd.wav']
+    assert second[b_key]['master_mob_id'] != first[b_key]['master_mob_id']
+    a_key = 'a.wav'
+    assert second[a_key] == first[a_key]
+
+    # Nothing changed since: no AAF, no removed list, manifest unchanged
+    count = len(written)
+    assert proc.process_directory(str(src), str(out), one_aaf=True) == 0
+    assert len(written) == count
+    assert json.loads((out / 'batch_manifest.json').read_text())['clips'] == second
+    assert len(list(out.glob('batch_delta_*_removed.csv'))) == 1
+
+
+def test_cancelled_one_aaf_run_leaves_batch_and_manifest(tmp_path: Path, tiny_wav_mono: Path, monkeypatch):
+    src, out = tmp_path / 'src', tmp_path / 'out'
+    src.mkdir()
+    for name in ('a.wav', 'b.wav', 'c.wav'):
+        shutil.copyfile(str(tiny_wav_mono), str(src / name))
+    written = []
+    proc = _processor(monkeypatch, written)
+    assert proc.process_directory(str(src), str(out), one_aaf=True, emit_ale=True) == 0
+    before = {name: (out / name).read_bytes() for name in ('batch.aaf', 'batch_manifest.json', 'batch.ale')}
+
+    cancel = threading.Event()
+
+    def cancel_after_first(done, total):
+        if done >= 1:
+            cancel.set()
+    assert proc.process_directory(str(src), str(out), one_aaf=True, emit_ale=True, cancel_event=cancel,
+                                  progress_callback=cancel_after_first) == 0
+    assert cancel.is_set() and len(written) == 1
+    assert {name: (out / name).read_bytes() for name in before} == before
+
+
+def test_moved_library_is_not_reimported(tmp_path: Path, tiny_wav_mono: Path, monkeypatch):
+    src, out = tmp_path / 'src', tmp_path / 'out'
+    (src / 'Doors').mkdir(parents=True)
+    for name in ('a.wav', 'Doors/b.wav'):
+        shutil.copyfile(str(tiny_wav_mono), str(src / name))
+    written = []
+    proc = _processor(monkeypatch, written)
+    assert proc.process_directory(str(src), str(out), one_aaf=True) == 0
+    first = json.loads((out / 'batch_manifest.json').read_text())['clips']
+    assert sorted(first) == ['Doors/b.wav', 'a.wav']
+
+    moved = tmp_path / 'remounted' / 'library'
+    moved.parent.mkdir()
+    os.rename(src, moved)  # keeps size and mtime
+    proc.delta = True
+    assert proc.process_directory(str(moved), str(out), one_aaf=True) == 0
+    assert len(written) == 1
+    assert not list(out.glob('batch_delta_*_removed.csv'))
+    assert json.loads((out / 'batch_manifest.json').read_text())['clips'] == first
+
+
+def test_version1_manifest_keys_are_made_relative(tmp_path: Path, tiny_wav_mono: Path, monkeypatch):
+    src, out = tmp_path / 'src', tmp_path / 'out'
+    src.mkdir()
+    shutil.copyfile(str(tiny_wav_mono), str(src / 'a.wav'))
+    written = []
+    proc = _processor(monkeypatch, written)
+    assert proc.process_directory(str(src), str(out), one_aaf=True) == 0
+    manifest = json.loads((out / 'batch_manifest.json').read_text())
+    manifest['version'] = 1
+    manifest['clips'] = {str((src / key).resolve()): clip for key, clip in manifest['clips'].items()}
+    (out / 'batch_manifest.json').write_text(json.dumps(manifest))
+    proc.delta = True
+    assert proc.process_directory(str(src), str(out), one_aaf=True) == 0
+    assert len(written) == 1 and not list(out.glob('batch_delta_*_removed.csv'))
+
+
+def test_changed_clip_that_fails_to_read_keeps_its_entry(tmp_path: Path, tiny_wav_mono: Path, monkeypatch):
+    src, out = tmp_path / 'src', tmp_path / 'out'
+    src.mkdir()
+    for name in ('a.wav', 'b.wav'):
+        shutil.copyfile(str(tiny_wav_mono), str(src / name))
+    written = []
+    proc = _processor(monkeypatch, written)
+    assert proc.process_directory(str(src), str(out), one_aaf=True) == 0
+    first = json.loads((out / 'batch_manifest.json').read_text())['clips']
+
+    later = time.time() + 10
+    for name in ('a.wav', 'b.wav'):
+        os.utime(src / name, (later, later))
+    original = proc._extract_file_record
+    monkeypatch.setattr(proc, '_extract_file_record',
+                        lambda wav, basic_path=None: None if wav.name == 'b.wav' else original(wav))
+    proc.delta = True
+    assert proc.process_directory(str(src), str(out), one_aaf=True) == 0
+    assert written[-1][1] == ['a.wav']
+    removed = next(out.glob('batch_delta_*_removed.csv'))
+    with open(removed, newline='') as fh:
+        assert [row['name'] for row in csv.DictReader(fh)] == ['a.wav']
+    second = json.loads((out / 'batch_manifest.json').read_text())['clips']
+    assert second['b.wav'] == first['b.wav']
+    assert second['a.wav'] != first['a.wav']
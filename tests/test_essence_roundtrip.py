@@ -0,0 +1,61 @@
+"""
+Embedded essence written by either essence writer reads back from the AAF byte for byte.
+"""
+import wave
+from pathlib import Path
+import pytest
+import aaf2
+from wav_to_aaf import EssenceWriter, WAVsToAAFProcessor
+
+FRAMES = 4800 * 3 + 7  # not a multiple of the block size
+
+
+def _write_wav(path: Path, channels: int, width: int) -> bytes:
+    pcm = bytes((n * 31) % 253 for n in range(FRAMES * channels * width))
+    with wave.open(str(path), 'wb') as w:
+        w.setnchannels(channels)
+        w.setsampwidth(width)
+        w.setframerate(48000)
+        w.writeframes(pcm)
+    return pcm
+
+
+def _channel(pcm: bytes, channels: int, width: int, c: int) -> bytes:
+    align = channels * width
+    return b''.join(pcm[i + c * width:i + (c + 1) * width] for i in range(0, len(pcm), align))
+
+
+def _essence_mobs(path: Path):
+    """(name, essence bytes, descriptor Length, essence slot lengths) per SourceMob with essence"""
+    found = []
+    with aaf2.open(str(path), 'r') as f:
+        for mob in f.content.sourcemobs():
+            essence = mob.essence
+            if essence is None:
+                continue
+            stream = essence.open('r')
+            data = stream.read()
+            found.append((mob.name, data, mob.descriptor['Length'].value,
+                          [slot.segment.length for slot in mob.slots]))
+    return sorted(found)
+
+
+@pytest.mark.parametrize('mode', ['stream', 'import'])
+@pytest.mark.parametrize('channels, width', [(1, 2), (2, 3)])
+def test_embedded_essence_round_trips(tmp_path: Path, mode: str, channels: int, width: int):
+    wav = tmp_path / 'take.wav'
+    pcm = _write_wav(wav, channels, width)
+    proc = WAVsToAAFProcessor()
+    proc.generator.essence_writer = EssenceWriter(block_size=4096, mode=mode)
+    out = tmp_path / 'take.aaf'
+    assert proc.process_single_file(str(wav), str(out), embed_audio=True) == 0
+
+    mobs = _essence_mobs(out)
+    if channels == 1:
+        expected = [pcm]
+    else:
+        expected = [_channel(pcm, channels, width, c) for c in range(channels)]
+    assert [data for _, data, _, _ in mobs] == expected
+    for name, _, length, slot_lengths in mobs:
+        assert length == FRAMES, name
+        assert slot_lengths == [FRAMES], name
@@ -0,0 +1,132 @@
+import io
+import wave
+from pathlib import Path
+import pytest
+import wav_to_aaf
+from wav_to_aaf import EssenceWriter
+
+CHANNELS, WIDTH, RATE = 2, 3, 48000
+BLOCK_ALIGN = CHANNELS * WIDTH
+
+
+def _wav(path: Path, frames: int) -> bytes:
+    pcm = bytes((n * 13) % 251 for n in range(frames * BLOCK_ALIGN))
+    with wave.open(str(path), 'wb') as w:
+        w.setnchannels(CHANNELS)
+        w.setsampwidth(WIDTH)
+        w.setframerate(RATE)
+        w.writeframes(pcm)
+    return pcm
+
+
+class _ShortReads(io.RawIOBase):
+    """Raw file whose readinto() returns at most 7 bytes, never a whole frame boundary"""
+
+    def __init__(self, path):
+        self._fh = open(path, 'rb', buffering=0)
+
+    def readable(self):
+        return True
+
+    def seek(self, pos, whence=0):
+        return self._fh.seek(pos, whence)
+
+    def readinto(self, b):
+        return self._fh.readinto(memoryview(b)[:7])
+
+    def close(self):
+        self._fh.close()
+        super().close()
+
+
+class _Value:
+    def __init__(self):
+        self.value = None
+
+
+class _Descriptor(dict):
+    def __missing__(self, key):
+        self[key] = _Value()
+        return self[key]
+
+
+class _Segment:
+    length = 0
+
+
+class _Slot:
+    def __init__(self):
+        self.segment = _Segment()
+
+
+class _Mob:
+    def __init__(self, name=''):
+        self.name = name
+        self.slots = []
+        self.descriptor = None
+        self.essence = None
+
+    def create_essence(self, edit_rate, media_kind):
+        self.slots.append(_Slot())
+        self.essence = io.BytesIO()
+        return self.essence
+
+
+class _Create:
+    PCMDescriptor = _Descriptor
+    SourceMob = _Mob
+
+
+class _File:
+    create = _Create()
+
+    class dictionary:
+        @staticmethod
+        def lookup_containerdef(name):
+            return name
+
+
+def test_split_block_deinterleaves_24bit_stereo():
+    block = bytearray(b'ABCabcDEFdefGHIghi')
+    assert EssenceWriter._split_block(block, 2, 3) == [bytearray(b'ABCDEFGHI'), bytearray(b'abcdefghi')]
+
+
+def test_blocks_carry_partial_frames_across_short_reads(tmp_path: Path, monkeypatch):
+    pcm = _wav(tmp_path / 'a.wav', 1000)
+    writer = EssenceWriter(block_size=100)
+    header = writer._source(tmp_path / 'a.wav')
+    monkeypatch.setattr(wav_to_aaf, 'open_wav_source', lambda source, buffering=-1: _ShortReads(source))
+    blocks = [bytes(b) for b in writer._blocks(tmp_path / 'a.wav', header)]
+    assert all(len(b) % BLOCK_ALIGN == 0 for b in blocks)
+    assert b''.join(blocks) == pcm
+
+
+def test_blocks_raise_when_data_ends_early(tmp_path: Path):
+    _wav(tmp_path / 'short.wav', 100)
+    writer = EssenceWriter(block_size=64)
+    header = dict(writer._source(tmp_path / 'short.wav'), frames=200)
+    with pytest.raises(Exception, match='short'):
+        list(writer._blocks(tmp_path / 'short.wav', header))
+
+
+def test_stream_embed_into_writes_interleaved_data(tmp_path: Path):
+    pcm = _wav(tmp_path / 'a.wav', 1000)
+    writer = EssenceWriter(block_size=1000, mode='stream')
+    mob = writer.embed_into(_File(), _Mob(), tmp_path / 'a.wav', RATE)
+    assert mob.essence.getvalue() == pcm
+    assert mob.descriptor['Length'].value == 1000
+    assert mob.descriptor['Channels'].value == CHANNELS
+    assert mob.slots[-1].segment.length == 1000
+    assert writer.stats['bytes'] == len(pcm)
+
+
+def test_stream_embed_channels_splits_per_channel(tmp_path: Path):
+    pcm = _wav(tmp_path / 'a.wav', 1000)
+    writer = EssenceWriter(block_size=1000, mode='stream')
+    mobs = writer.embed_channels(_File(), tmp_path / 'a.wav', 'a', RATE)
+    assert [m.name for m in mobs] == ['a.PHYS.ch1', 'a.PHYS.ch2']
+    for c, mob in enumerate(mobs):
+        expected = b''.join(pcm[i + c * WIDTH:i + (c + 1) * WIDTH] for i in range(0, len(pcm), BLOCK_ALIGN))
+        assert mob.essence.getvalue() == expected
+        assert mob.descriptor['Channels'].value == 1
+        assert mob.descriptor['Length'].value == 1000
@@ -0,0 +1,96 @@
+import struct
+import threading
+import time
+from pathlib import Path
+from wav_to_aaf import GrowingWavFollower, MemoryGovernor, WAVsToAAFProcessor
+
+CHANNELS, WIDTH, RATE = 2, 3, 48000
+BLOCK_ALIGN = CHANNELS * WIDTH
+
+
+def _fmt_chunk() -> bytes:
+    return b'fmt ' + struct.pack('<IHHIIHH', 16, 1, CHANNELS, RATE, RATE * BLOCK_ALIGN, BLOCK_ALIGN, WIDTH * 8)
+
+
+def _record(path: Path, pcm: bytes, pieces: int, patch: bool, trailer: bytes = b''):
+    """Write a WAV like a recorder: placeholder sizes, audio in pieces, then optionally patch and close"""
+    with open(path, 'wb') as fh:
+        fh.write(b'RIFF' + struct.pack('<I', 0xFFFFFFFF) + b'WAVE' + _fmt_chunk() + b'data' + struct.pack('<I', 0))
+        fh.flush()
+        step = len(pcm) // pieces
+        for n in range(pieces):
+            fh.write(pcm[n * step:] if n == pieces - 1 else pcm[n * step:(n + 1) * step])
+            fh.flush()
+            time.sleep(0.05)
+        if patch:
+            fh.write(trailer)
+            riff_size = fh.tell() - 8
+            fh.seek(4)
+            fh.write(struct.pack('<I', riff_size))
+            fh.seek(40)
+            fh.write(struct.pack('<I', len(pcm)))
+
+
+def _follow(path: Path, pcm: bytes, pieces: int, patch: bool, trailer: bytes = b'', **kwargs):
+    path.write_bytes(b'')
+    follower = GrowingWavFollower(path, poll_interval=0.02, holdback=BLOCK_ALIGN * 100, **kwargs)
+    writer = threading.Thread(target=_record, args=(path, pcm, pieces, patch, trailer))
+    writer.start()
+    assert follower.wait_for_header(timeout=5) is not None
+    received = b''.join(bytes(block) for block in follower.blocks(block_size=1000))
+    writer.join()
+    return follower, received
+
+
+def test_follower_streams_audio_and_stops_at_closed_header(tmp_path: Path):
+    frames = 12000
+    pcm = bytes((n * 11) % 251 for n in range(frames * BLOCK_ALIGN))
+    # LIST chunk appended at close must not be taken for audio
+    trailer = b'LIST' + struct.pack('<I', 12) + b'INFOICMT' + struct.pack('<I', 0)
+    follower, received = _follow(tmp_path / 'take1.wav', pcm, 8, True, trailer, settle_seconds=30)
+    assert follower.reason == 'closed'
+    assert follower.frames == frames
+    assert received == pcm
+    # Turnaround is bounded by polling, not by the settle time
+    assert time.monotonic() - follower.finished_at < 5
+
+
+def test_unpatched_recording_settles_with_final_length(tmp_path: Path):
+    frames = 5000
+    pcm = bytes((n * 7) % 253 for n in range(frames * BLOCK_ALIGN))
+    follower, received = _follow(tmp_path / 'crash.wav', pcm, 4, False, settle_seconds=0.3)
+    assert follower.reason == 'settled'
+    assert follower.frames == frames
+    assert received == pcm
+
+    record = WAVsToAAFProcessor()._growing_record(follower)
+    assert record['wav_metadata']['frames'] == frames
+    assert record['wav_metadata']['channels'] == CHANNELS
+    assert abs(record['wav_metadata']['duration_seconds'] - frames / RATE) < 1e-9
+
+
+def test_watcher_follows_a_bounded_number_of_files_through_the_governor(tmp_path: Path, monkeypatch):
+    src = tmp_path / 'rec'
+    src.mkdir()
+    pcm = bytes(BLOCK_ALIGN * 480)
+    for n in range(5):
+        (src / f'take{n}.wav').write_bytes(b'RIFF' + struct.pack('<I', 36 + len(pcm)) + b'WAVE' + _fmt_chunk()
+                                           + b'data' + struct.pack('<I', len(pcm)) + pcm)
+    proc = WAVsToAAFProcessor()
+    proc.memory_governor = MemoryGovernor(1 << 40)
+    lock = threading.Lock()
+    active, peak = [0], [0]
+
+    def fake_follow(wav_file, output_file, **kwargs):
+        with lock:
+            active[0] += 1
+            peak[0] = max(peak[0], active[0])
+        time.sleep(0.2)
+        with lock:
+            active[0] -= 1
+        return 0
+    monkeypatch.setattr(proc, 'follow_file', fake_follow)
+    assert proc.process_growing(str(src), str(tmp_path / 'out'), idle_exit=0.1, workers=2) == 0
+    assert peak[0] == 2
+    assert proc.memory_governor.stats['admitted'] == 5
+    assert proc.memory_governor.in_use == 0 and proc.memory_governor.running == 0
@@ -0,0 +1,40 @@
+from pathlib import Path
+import aaf2
+from wav_to_aaf import WAVsToAAFProcessor
+
+
+def _source_clip(segment):
+    # Pan wraps the master clip in an OperationGroup
+    return segment if type(segment).__name__ == 'SourceClip' else list(segment.segments)[0]
+
+
+def test_interleaved_embed_selects_each_channel(tiny_wav_stereo: Path, tmp_outdir: Path):
+    out = tmp_outdir / 'interleaved.aaf'
+    proc = WAVsToAAFProcessor()
+    proc.generator.interleaved_embed = True
+    assert proc.process_single_file(str(tiny_wav_stereo), str(out), embed_audio=True) == 0
+
+    with aaf2.open(str(out), 'r') as f:
+        master = next(m for m in f.content.mobs if type(m).__name__ == 'MasterMob')
+        clips = [_source_clip(slot.segment) for slot in master.slots]
+        assert len(clips) == 2
+        assert len({str(clip['SourceID'].value) for clip in clips}) == 1
+        assert [list(clip['ChannelIDs'].value) for clip in clips] == [[1], [2]]
+        source = next(m for m in f.content.mobs if m.mob_id == clips[0]['SourceID'].value)
+        assert source.descriptor['Channels'].value == 2
+
+
+def test_channel_ids_probed_once_per_generator(capsys):
+    created = []
+
+    class _File:
+        class create:
+            @staticmethod
+            def SourceClip():
+                created.append(1)
+                return {}  # no ChannelIDs
+
+    generator = WAVsToAAFProcessor().generator
+    assert not any(generator._channel_ids_supported(_File()) for _ in range(3))
+    assert len(created) == 1
+    assert capsys.readouterr().out.count('ChannelIDs not available') == 1
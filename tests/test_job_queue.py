@@ -0,0 +1,98 @@
+import json
+import threading
+import time
+from pathlib import Path
+from wav_to_aaf_gui import JobQueue
+
+
+def _wait_for(predicate, timeout: float = 5.0):
+    deadline = time.monotonic() + timeout
+    while not predicate():
+        assert time.monotonic() < deadline, "timed out"
+        time.sleep(0.01)
+
+
+class _Runner:
+    """Stand-in for run_conversion_job: blocks until released or cancelled"""
+
+    def __init__(self):
+        self.release = threading.Event()
+        self.started = []
+
+    def __call__(self, job, cancel_event, pause_event, progress):
+        self.started.append(job['input'])
+        progress(0, 1)
+        while not self.release.is_set() and not cancel_event.is_set():
+            time.sleep(0.01)
+        progress(1, 1)
+        return 0
+
+
+def test_jobs_persist_and_running_ones_requeue_after_shutdown(tmp_path: Path):
+    state = tmp_path / 'queue.json'
+    runner = _Runner()
+    queue = JobQueue(state, max_workers=1, runner=runner)
+    first = queue.add_job('/in/a', '/out', {'fps': 25})
+    second = queue.add_job('/in/b', '', {})
+    queue.start()
+    _wait_for(lambda: first['status'] == 'running')
+    queue.shutdown()
+    _wait_for(lambda: first['id'] not in queue._submitted)
+    assert first['status'] == 'running' and second['status'] == 'queued'
+
+    saved = json.loads(state.read_text())
+    assert [j['input'] for j in saved['jobs']] == ['/in/a', '/in/b']
+    restored = JobQueue(state, runner=_Runner())
+    assert [(j['id'], j['status'], j['options']) for j in restored.jobs] == [
+        (first['id'], 'queued', {'fps': 25}), (second['id'], 'queued', {})]
+
+
+def test_cancel_running_and_queued_jobs(tmp_path: Path):
+    runner = _Runner()
+    queue = JobQueue(tmp_path / 'queue.json', max_workers=1, runner=runner)
+    running = queue.add_job('/in/a', '', {})
+    waiting = queue.add_job('/in/b', '', {})
+    queue.start()
+    _wait_for(lambda: running['status'] == 'running')
+    queue.cancel_job(waiting['id'])
+    queue.cancel_job(running['id'])
+    _wait_for(lambda: not queue._submitted)
+    assert running['status'] == waiting['status'] == 'cancelled'
+    assert runner.started == ['/in/a']
+
+
+def test_paused_job_does_not_hold_a_worker(tmp_path: Path):
+    runner = _Runner()
+    runner.release.set()
+    queue = JobQueue(tmp_path / 'queue.json', max_workers=1, runner=runner)
+    paused = queue.add_job('/in/a', '', {})
+    queue.toggle_pause(paused['id'])
+    other = queue.add_job('/in/b', '', {})
+    queue.start()
+    _wait_for(lambda: other['status'] == 'done')
+    assert paused['status'] == 'paused' and runner.started == ['/in/b']
+    queue.toggle_pause(paused['id'])
+    _wait_for(lambda: paused['status'] == 'done')
+    assert runner.started == ['/in/b', '/in/a']
+
+
+def test_concurrent_saves_leave_a_valid_state_file(tmp_path: Path):
+    state = tmp_path / 'queue.json'
+    queue = JobQueue(state, runner=_Runner())
+    for n in range(20):
+        queue.add_job(f'/in/{n}', '', {})
+    errors = []
+
+    def save_many():
+        try:
+            for _ in range(50):
+                queue.save()
+        except Exception as e:
+            errors.append(e)
+    threads = [threading.Thread(target=save_many) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert not errors
+    assert len(json.loads(state.read_text())['jobs']) == 20
@@ -0,0 +1,33 @@
+from pathlib import Path
+import pytest
+from wav_to_aaf import build_locator_urls, parse_locator_remap, load_locator_remap_file, remap_locator_path
+
+
+def test_remap_uses_longest_prefix_on_path_boundaries():
+    remaps = [parse_locator_remap('/Volumes/SFX=/mnt/sfx'), parse_locator_remap('/Volumes/SFX/Foley=Z:\\Foley')]
+    assert remap_locator_path('/Volumes/SFX/Amb/rain.wav', remaps) == '/mnt/sfx/Amb/rain.wav'
+    assert remap_locator_path('/Volumes/SFX/Foley/step.wav', remaps) == 'Z:/Foley/step.wav'
+    # '/Volumes/SFX2' is not under '/Volumes/SFX'
+    assert remap_locator_path('/Volumes/SFX2/a.wav', remaps) == '/Volumes/SFX2/a.wav'
+    with pytest.raises(ValueError):
+        parse_locator_remap('/Volumes/SFX')
+
+
+def test_locator_sets(tmp_path):
+    wav = Path('/Volumes/SFX/Amb/city rain.wav')
+    remaps = [('/Volumes/SFX', '//nas/sfx')]
+
+    everything = build_locator_urls(wav)
+    assert everything == ['file:///Macintosh%20HD/Volumes/SFX/Amb/city%20rain.wav',
+                          'file:///Volumes/SFX/Amb/city%20rain.wav',
+                          'file://localhost/Volumes/SFX/Amb/city%20rain.wav',
+                          '/Volumes/SFX/Amb/city rain.wav', 'city rain.wav']
+    assert build_locator_urls(wav, relative=True) == ['./city rain.wav']
+    assert build_locator_urls(wav, remaps=remaps, locator_set='windows') == ['file://nas/sfx/Amb/city%20rain.wav']
+    assert build_locator_urls(wav, remaps=[('/Volumes/SFX', 'Z:/')], locator_set='windows') == ['file:///Z:/Amb/city%20rain.wav']
+    assert build_locator_urls(wav, remaps=[('/Volumes/SFX', '/mnt/sfx')], locator_set='posix') == ['/mnt/sfx/Amb/city rain.wav']
+    assert build_locator_urls(wav, locator_set='mac') == ['file:///Volumes/SFX/Amb/city%20rain.wav']
+
+    table = tmp_path / 'remap.txt'
+    table.write_text('# studio share\n/Volumes/SFX=//nas/sfx\n\n')
+    assert load_locator_remap_file(str(table)) == remaps
@@ -0,0 +1,72 @@
+import struct
+from pathlib import Path
+from wav_to_aaf import WAVMetadataExtractor, WAVsToAAFProcessor
+
+
+def _chunk(chunk_id: bytes, payload: bytes) -> bytes:
+    return chunk_id + struct.pack('<I', len(payload)) + payload + (b'\x00' if len(payload) % 2 else b'')
+
+
+def _write_marked_wav(path: Path, frames: int, cues, labels=(), ltxt=(), ixml: str = ''):
+    fmt = struct.pack('<HHIIHH', 1, 1, 48000, 96000, 2, 16)
+    cue = struct.pack('<I', len(cues)) + b''.join(
+        struct.pack('<II4sIII', cue_id, pos, b'data', 0, 0, pos) for cue_id, pos in cues)
+    adtl = b'adtl' + b''.join(_chunk(b'labl', struct.pack('<I', cue_id) + text.encode() + b'\x00')
+                              for cue_id, text in labels)
+    adtl += b''.join(_chunk(b'ltxt', struct.pack('<II4sHHHH', cue_id, length, b'rgn ', 0, 0, 0, 0))
+                     for cue_id, length in ltxt)
+    body = _chunk(b'fmt ', fmt) + _chunk(b'data', b'\x00' * frames * 2) + _chunk(b'cue ', cue) + _chunk(b'LIST', adtl)
+    if ixml:
+        body += _chunk(b'iXML', ixml.encode())
+    path.write_bytes(b'RIFF' + struct.pack('<I', 4 + len(body)) + b'WAVE' + body)
+
+
+def test_cue_regions_and_point_markers(tmp_path):
+    extractor = WAVMetadataExtractor()
+    regions_wav = tmp_path / 'regions.wav'
+    _write_marked_wav(regions_wav, 1000, cues=[(1, 100), (2, 600)],
+                      labels=[(1, 'Take A'), (2, 'Take B')], ltxt=[(1, 200), (2, 900)])
+    regions = extractor.extract_regions(str(regions_wav))
+    assert [(r['name'], r['start'], r['length']) for r in regions] == [('Take A', 100, 200), ('Take B', 600, 400)]
+    assert regions[0]['sample_rate'] == 48000
+
+    # Point markers only: spans run to the next marker / end of file
+    points_wav = tmp_path / 'points.wav'
+    _write_marked_wav(points_wav, 1000, cues=[(1, 0), (2, 250)], labels=[(2, 'Slate')])
+    regions = extractor.extract_regions(str(points_wav))
+    assert [(r['name'], r['start'], r['length']) for r in regions] == [('Region 01', 0, 250), ('Slate', 250, 750)]
+
+
+def test_ixml_sync_points_and_processor_attach(tmp_path):
+    ixml = ('<?xml version="1.0" encoding="UTF-8"?><BWFXML><SYNC_POINT_LIST>'
+            '<SYNC_POINT><SYNC_POINT_TYPE>ABSOLUTE</SYNC_POINT_TYPE><SYNC_POINT_FUNCTION>SLATE_GENERIC</SYNC_POINT_FUNCTION>'
+            '<SYNC_POINT_COMMENT>Clap</SYNC_POINT_COMMENT><SYNC_POINT_LOW>48300</SYNC_POINT_LOW>'
+            '<SYNC_POINT_HIGH>0</SYNC_POINT_HIGH><SYNC_POINT_EVENT_DURATION>200</SYNC_POINT_EVENT_DURATION></SYNC_POINT>'
+            '</SYNC_POINT_LIST></BWFXML>')
+    wav = tmp_path / 'ixml.wav'
+    _write_marked_wav(wav, 1000, cues=[], ixml=ixml)
+    markers = WAVMetadataExtractor().extract_markers(str(wav), time_reference=48000)
+    assert markers == [{'name': 'Clap', 'start': 300, 'length': 200, 'comment': 'SLATE_GENERIC', 'source': 'ixml'}]
+
+    proc = WAVsToAAFProcessor()
+    meta = {'filename': wav.name}
+    proc._attach_regions(meta, wav, {'time_reference': 48000})
+    assert 'regions' not in meta
+    proc.subclips = True
+    proc._attach_regions(meta, wav, {'time_reference': 48000})
+    assert [(r['start'], r['length']) for r in meta['regions']] == [(300, 200)]
+
+
+def test_subclip_ids_survive_added_markers(tmp_path):
+    from wav_to_aaf import AAFGenerator
+    extractor = WAVMetadataExtractor()
+    before_wav = tmp_path / 'before.wav'
+    _write_marked_wav(before_wav, 1000, cues=[(1, 100), (2, 600)],
+                      labels=[(1, 'Take A'), (2, 'Take B')], ltxt=[(1, 200), (2, 900)])
+    after_wav = tmp_path / 'after.wav'
+    _write_marked_wav(after_wav, 1000, cues=[(3, 0), (1, 100), (2, 600)],
+                      labels=[(3, 'Slate'), (1, 'Take A'), (2, 'Take B')], ltxt=[(3, 50), (1, 200), (2, 900)])
+    before = [AAFGenerator._region_umid_key(r) for r in extractor.extract_regions(str(before_wav))]
+    after = [AAFGenerator._region_umid_key(r) for r in extractor.extract_regions(str(after_wav))]
+    # A region inserted ahead of the others leaves their keys (and so their subclip mob IDs) alone
+    assert len(set(after)) == 3 and after[1:] == before
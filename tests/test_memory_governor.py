@@ -0,0 +1,98 @@
+import shutil
+import threading
+import time
+from pathlib import Path
+from wav_to_aaf import MemoryGovernor, WAVsToAAFProcessor
+
+
+def test_estimate_grows_with_essence_and_channels():
+    gov = MemoryGovernor(1024 ** 3)
+    small = {'channels': 1, 'data_size': 10 * 1024 ** 2}
+    big = {'channels': 8, 'data_size': 8 * 1024 ** 3}
+    assert gov.estimate(big, embed_audio=False) == gov.estimate(small, embed_audio=False) == MemoryGovernor.BASE_BYTES
+    assert gov.estimate(big, True) > gov.estimate(small, True) > MemoryGovernor.BASE_BYTES
+    assert gov.estimate(big, True, sector_size=4096) < gov.estimate(big, True, sector_size=512)
+    assert gov.estimate(big, True, interleaved=True) < gov.estimate(big, True)
+
+
+def test_admission_respects_budget_and_serializes_oversize():
+    gov = MemoryGovernor(100)
+    active, peak = [0], [0]
+    lock = threading.Lock()
+
+    def job(cost):
+        gov.acquire(cost)
+        with lock:
+            active[0] += cost
+            peak[0] = max(peak[0], active[0])
+        time.sleep(0.02)
+        with lock:
+            active[0] -= cost
+        gov.release(cost)
+
+    threads = [threading.Thread(target=job, args=(cost,)) for cost in (60, 60, 30, 150, 10)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert gov.in_use == 0 and gov.running == 0
+    assert gov.stats['admitted'] == 5 and gov.stats['serialized'] == 1
+    # Only the oversize file ever pushed the total over the budget, and it ran alone
+    assert peak[0] <= 150 and gov.stats['peak_bytes'] <= 150
+
+
+def test_directory_workers_process_every_file(tmp_path, tiny_wav_stereo: Path, monkeypatch):
+    src = tmp_path / 'src'
+    src.mkdir()
+    for n in range(6):
+        shutil.copyfile(str(tiny_wav_stereo), str(src / f'clip_{n}.wav'))
+    proc = WAVsToAAFProcessor()
+    proc.memory_governor = MemoryGovernor(MemoryGovernor.BASE_BYTES * 2)
+    written = []
+
+    def fake_create(wav_metadata, bext, info, xml, ucs, out_file, **kwargs):
+        written.append(Path(out_file).name)
+        Path(out_file).write_bytes(b'aaf')
+        return out_file
+    monkeypatch.setattr(proc.generator, 'create_aaf_file', fake_create)
+
+    assert proc.process_directory(str(src), str(tmp_path / 'out'), embed_audio=True, workers=3) == 0
+    assert sorted(written) == [f'clip_{n}.aaf' for n in range(6)]
+    assert proc.last_run_stats['files'] == 6
+    assert proc.memory_governor.running == 0 and proc.memory_governor.stats['admitted'] == 6
+
+
+def test_workers_emit_ale_rows_in_discovery_order(tmp_path, tiny_wav_stereo: Path, monkeypatch):
+    src = tmp_path / 'src'
+    src.mkdir()
+    for n in range(6):
+        shutil.copyfile(str(tiny_wav_stereo), str(src / f'clip_{n}.wav'))
+    proc = WAVsToAAFProcessor()
+
+    def fake_create(wav_metadata, bext, info, xml, ucs, out_file, **kwargs):
+        # Later clips finish first
+        time.sleep(0.05 * (6 - int(Path(out_file).stem.split('_')[1])))
+        Path(out_file).write_bytes(b'aaf')
+        return out_file
+    monkeypatch.setattr(proc.generator, 'create_aaf_file', fake_create)
+
+    out = tmp_path / 'out'
+    assert proc.process_directory(str(src), str(out), embed_audio=True, emit_ale=True, workers=6) == 0
+    ale = (out / 'batch.ale').read_text()
+    positions = [ale.index(wav.name) for wav in proc.discover_wav_files(src)]
+    assert positions == sorted(positions)
+
+
+def test_essence_writer_stats_are_thread_safe():
+    from wav_to_aaf import EssenceWriter
+    writer = EssenceWriter()
+
+    def count():
+        for _ in range(20000):
+            writer._count(bytes=2, writes=1)
+    threads = [threading.Thread(target=count) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert writer.stats['writes'] == 80000 and writer.stats['bytes'] == 160000
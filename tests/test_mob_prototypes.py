@@ -0,0 +1,67 @@
+"""
+Cloned prototype mob chains must be indistinguishable from chains built clip by clip.
+"""
+import wave
+from pathlib import Path
+import pytest
+import aaf2
+from wav_to_aaf import WAVsToAAFProcessor
+
+# Set per write, so they differ between any two files
+VOLATILE = {'CreationTime', 'LastModified', 'CreationDate', 'LastModifiedDate'}
+
+
+def _write_wav(path: Path, channels: int, frames: int):
+    with wave.open(str(path), 'wb') as w:
+        w.setnchannels(channels)
+        w.setsampwidth(2)
+        w.setframerate(48000)
+        w.writeframes(b'\0\0' * channels * frames)
+
+
+def _dump(value):
+    """Plain-data form of a property value; definitions by name, objects recursively"""
+    if isinstance(value, aaf2.core.AAFObject):
+        if isinstance(value, aaf2.dictionary.DefinitionObject):
+            return ('def', value.name)
+        return (type(value).__name__,
+                sorted((p.name, _dump(p.value)) for p in value.properties() if p.name not in VOLATILE))
+    if isinstance(value, (list, tuple)) or type(value).__name__.endswith('Iter'):
+        return [_dump(v) for v in value]
+    return repr(value)
+
+
+def _mobs(path: Path):
+    with aaf2.open(str(path), 'r') as f:
+        return sorted((str(mob.mob_id), _dump(mob)) for mob in f.content.mobs)
+
+
+@pytest.mark.parametrize('tape_mode', [False, True])
+def test_cloned_chains_match_built_chains(tmp_path: Path, tape_mode: bool):
+    src = tmp_path / 'Roll_A'
+    src.mkdir()
+    # Three clips per shape so the prototype is cloned more than once; lengths all differ
+    for n in range(3):
+        _write_wav(src / f'mono_{n}.wav', 1, 4800 * (n + 2))
+        _write_wav(src / f'stereo_{n}.wav', 2, 4800 * (n + 5))
+    proc = WAVsToAAFProcessor()
+    entries = []
+    for wav in sorted(src.glob('*.wav')):
+        entry = proc._extract_file_record(wav)
+        entry['ucs_metadata'] = {}
+        entries.append(entry)
+
+    dumps = {}
+    for prototypes in (True, False):
+        proc.generator.mob_prototypes = prototypes
+        out = tmp_path / f'batch_{prototypes}.aaf'
+        if tape_mode:
+            proc.generator.create_multi_tape_aaf(entries, str(out), fps=25)
+        else:
+            proc.generator.create_multi_aaf(entries, str(out), fps=25)
+        dumps[prototypes] = _mobs(out)
+
+    # UMIDs, SourceIDs, lengths, pan PointList times, locators and comments all compare equal
+    assert [mob_id for mob_id, _ in dumps[True]] == [mob_id for mob_id, _ in dumps[False]]
+    for (mob_id, cloned), (_, built) in zip(dumps[True], dumps[False]):
+        assert cloned == built, mob_id
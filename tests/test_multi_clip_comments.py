@@ -0,0 +1,27 @@
+from pathlib import Path
+from wav_to_aaf import AAFGenerator, create_deterministic_umid, create_deterministic_umids
+
+
+def test_clip_comments_in_write_order(tmp_path: Path):
+    wav_meta = {'filename': 'door.wav', 'channels': 2, 'sample_rate': 48000, 'sample_width': 3,
+                'frames': 96000, 'sync_group': 'SG20240501-0001'}
+    bext = {'description': 'Door close', 'time_reference': 480000}
+    info = {'INAM': 'Door', 'ICMT': 'note'}
+    ucs = {'primary_category': {'id': 'DOORWood', 'category': 'DOORS', 'subcategory': 'WOOD',
+                                'full_name': 'DOORS-WOOD', 'score': 100.0}}
+    comments = AAFGenerator._clip_comments(wav_meta, bext, info, ucs, tmp_path / 'door.wav', 'ROLL1')
+    keys = list(comments)
+    assert keys[:2] == ['BEXT_Description', 'BEXT_Time_Reference']
+    assert comments['Description'] == 'Door close' and comments['INFO_Title'] == 'Door'
+    assert comments['Tracks'] == 'A1A2' and comments['BitDepth'] == '24' and comments['Duration'] == '2.000'
+    assert comments['Tape'] == 'ROLL1' and comments['SyncGroup'] == 'SG20240501-0001' and keys[-1] == 'SyncGroup'
+
+
+def test_umids_share_one_seed(tmp_path: Path):
+    wav = tmp_path / 'a.wav'
+    wav.write_bytes(b'RIFF0000WAVE')
+    together = create_deterministic_umids(wav, ['import', 'wave', 'master'])
+    assert [str(u) for u in together] == [str(create_deterministic_umid(wav, t)) for t in ('import', 'wave', 'master')]
+    tape = create_deterministic_umids(wav, ['tape', 'master'], tape_mode=True)
+    assert str(tape[1]) == str(create_deterministic_umid(wav, 'master', tape_mode=True))
+
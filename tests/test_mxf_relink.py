@@ -0,0 +1,50 @@
+"""
+MXF media written for --link-mode mxf must carry the package UIDs the AAF's mobs point at,
+as pyaaf2's own MXF reader decodes them.
+"""
+import wave
+from pathlib import Path
+import aaf2
+from wav_to_aaf import WAVsToAAFProcessor
+
+
+def _write_wav(path: Path, channels: int, frames: int = 4800):
+    with wave.open(str(path), 'wb') as w:
+        w.setnchannels(channels)
+        w.setsampwidth(3)
+        w.setframerate(48000)
+        w.writeframes(bytes((n * 7) % 251 for n in range(frames * channels * 3)))
+
+
+def _mxf_package_ids(mxf_path: Path, scratch: Path):
+    """(material package UID, file package UID) of one OP-Atom file, via pyaaf2's MXF reader"""
+    import aaf2.mxf
+    assert aaf2.mxf.MXFFile(str(mxf_path)).operation_pattern == 'OPAtom'
+    with aaf2.open(str(scratch), 'w') as f:
+        f.content.link_external_mxf(str(mxf_path))
+        masters = [str(mob.mob_id) for mob in f.content.mastermobs()]
+        sources = [str(mob.mob_id) for mob in f.content.sourcemobs()]
+    assert len(masters) == 1 and len(sources) == 1, (masters, sources)
+    return masters[0], sources[0]
+
+
+def test_mxf_package_uids_match_aaf_mob_ids(tmp_path: Path):
+    wav = tmp_path / 'door close.wav'
+    _write_wav(wav, channels=2)
+    out = tmp_path / 'AAFs' / 'door close.aaf'
+    out.parent.mkdir()
+    assert WAVsToAAFProcessor().process_single_file(str(wav), str(out), link_mode='mxf') == 0
+
+    mxf_files = sorted((tmp_path / 'AAFs' / 'Avid MediaFiles' / 'MXF' / '1').glob('*.mxf'))
+    assert len(mxf_files) == 2
+    with aaf2.open(str(out), 'r') as f:
+        master_ids = {str(mob.mob_id) for mob in f.content.mastermobs()}
+        source_ids = {str(mob.mob_id) for mob in f.content.sourcemobs()}
+
+    file_ids = set()
+    for n, mxf_path in enumerate(mxf_files):
+        material_id, file_id = _mxf_package_ids(mxf_path, tmp_path / f'scratch{n}.aaf')
+        assert material_id in master_ids
+        file_ids.add(file_id)
+    # One file SourceMob per channel, each the file package of its own MXF
+    assert len(file_ids) == 2 and file_ids <= source_ids
@@ -0,0 +1,108 @@
+import struct
+import wave
+from pathlib import Path
+from wav_to_aaf import (OPAtomWriter, MXF_OP_ATOM, MXF_BWF_CLIP_ELEMENT, MXF_LOCAL_TAGS,
+                        deterministic_umid_bytes, umid_urn)
+
+
+def _read_klvs(data: bytes):
+    """Walk a whole MXF file as KLV triplets: [(offset, key, value)]"""
+    klvs, pos = [], 0
+    while pos < len(data):
+        key = data[pos:pos + 16]
+        first = data[pos + 16]
+        if first < 0x80:
+            length, header = first, 17
+        else:
+            n = first & 0x7f
+            length, header = int.from_bytes(data[pos + 17:pos + 17 + n], 'big'), 17 + n
+        klvs.append((pos, key, data[pos + header:pos + header + length]))
+        pos += header + length
+    assert pos == len(data)
+    return klvs
+
+
+def _local_set(value: bytes):
+    items, pos = {}, 0
+    while pos < len(value):
+        tag, length = struct.unpack('>HH', value[pos:pos + 4])
+        items[tag] = value[pos + 4:pos + 4 + length]
+        pos += 4 + length
+    return items
+
+
+def _set_kind(key: bytes):
+    if key[:14] == bytes.fromhex('060e2b34025301010d0101010101'):
+        return key[14]
+    return None
+
+
+def test_op_atom_files_round_trip(tmp_path: Path):
+    wav = tmp_path / 'door close.wav'
+    frames = 3000
+    with wave.open(str(wav), 'wb') as w:
+        w.setnchannels(2)
+        w.setsampwidth(3)
+        w.setframerate(48000)
+        w.writeframes(bytes((n * 7) % 251 for n in range(frames * 6)))
+    pcm = wav.read_bytes()[44:]
+
+    material = deterministic_umid_bytes(wav, 'master')
+    file_umids = [deterministic_umid_bytes(wav, f"mxf{ch}") for ch in (1, 2)]
+    writer = OPAtomWriter(block_size=1000)  # several blocks, not a multiple of block_align
+    files = writer.write_files(wav, tmp_path / 'MXF' / '1', wav.stem, material, file_umids)
+    assert [f['file_umid'] for f in files] == file_umids
+    assert writer.stats['bytes'] == frames * 6
+
+    for ch, info in enumerate(files):
+        data = Path(info['path']).read_bytes()
+        klvs = _read_klvs(data)
+        partitions = [(pos, key, value) for pos, key, value in klvs
+                      if key[:13] == bytes.fromhex('060e2b34020501010d01020101') and key[13] in (2, 3, 4)]
+        assert [key[13] for _, key, _ in partitions] == [2, 3, 4]
+        footer_offset = partitions[2][0]
+        for pos, key, value in partitions:
+            assert key[14] == 0x04  # closed and complete
+            this, _previous, footer = struct.unpack('>QQQ', value[8:32])
+            assert this == pos and footer == footer_offset
+            assert value[64:80] == MXF_OP_ATOM
+
+        # Random index pack at the end points at every partition
+        rip = klvs[-1][2]
+        entries = [struct.unpack('>IQ', rip[i:i + 12]) for i in range(0, len(rip) - 4, 12)]
+        assert [offset for _, offset in entries] == [pos for pos, _, _ in partitions]
+        assert struct.unpack('>I', rip[-4:])[0] == len(data) - klvs[-1][0]
+
+        # Every local tag used is declared in the primer
+        primer = next(value for _, key, value in klvs if key[13:15] == b'\x05\x01')
+        count, size = struct.unpack('>II', primer[:8])
+        declared = {struct.unpack('>H', primer[8 + i * size:10 + i * size])[0] for i in range(count)}
+        sets = [(_set_kind(key), _local_set(value)) for _, key, value in klvs if _set_kind(key)]
+        assert {tag for _, items in sets for tag in items} <= declared == set(MXF_LOCAL_TAGS)
+
+        packages = {kind: items for kind, items in sets if kind in (0x36, 0x37)}
+        assert packages[0x36][0x4401] == material
+        assert packages[0x37][0x4401] == file_umids[ch]
+        clips = [items for kind, items in sets if kind == 0x11]
+        assert clips[0][0x1101] == file_umids[ch]
+        assert struct.unpack('>I', clips[0][0x1102])[0] == 1
+
+        descriptor = next(items for kind, items in sets if kind == 0x48)
+        assert struct.unpack('>I', descriptor[0x3D07])[0] == 1
+        assert struct.unpack('>I', descriptor[0x3D01])[0] == 24
+        assert struct.unpack('>ii', descriptor[0x3D03]) == (48000, 1)
+        assert struct.unpack('>q', descriptor[0x3002])[0] == frames
+
+        essence = next(value for _, key, value in klvs if key == MXF_BWF_CLIP_ELEMENT)
+        expected = b''.join(pcm[n * 6 + ch * 3:n * 6 + ch * 3 + 3] for n in range(frames))
+        assert essence == expected
+
+
+def test_umid_urn_matches_bytes(tmp_path: Path):
+    wav = tmp_path / 'x.wav'
+    wav.write_bytes(b'RIFF')
+    umid = deterministic_umid_bytes(wav, 'mxf1')
+    urn = umid_urn(umid)
+    assert urn.startswith('urn:smpte:umid:060a2b34.')
+    assert bytes.fromhex(urn[len('urn:smpte:umid:'):].replace('.', '')) == umid
+    assert deterministic_umid_bytes(wav, 'mxf1') == umid != deterministic_umid_bytes(wav, 'mxf2')
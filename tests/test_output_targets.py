@@ -0,0 +1,70 @@
+import shutil
+import threading
+from pathlib import Path
+import pytest
+from wav_to_aaf import WAVsToAAFProcessor, parse_output_target
+
+
+def test_parse_output_target_options(tmp_path):
+    t = parse_output_target('linked:aafs/25,fps=25,link=pcm,tape,ale', str(tmp_path))
+    assert t['kind'] == 'linked' and t['output'] == str(tmp_path / 'aafs' / '25')
+    assert (t['fps'], t['link_mode'], t['tape_mode'], t['emit_ale']) == (25.0, 'pcm', True, True)
+    assert parse_output_target('ale:/tmp/x')['emit_ale']
+    for bad in ('aaf:/tmp/x', 'linked:', 'linked:/tmp/x,fps=fast', 'linked:/tmp/x,bit-depth=24',
+                'embedded:/tmp/x,one-aaf', 'embedded:/tmp/x,colour=blue'):
+        with pytest.raises(ValueError):
+            parse_output_target(bad)
+
+
+def test_targets_share_one_metadata_pass(tmp_path, tiny_wav_mono: Path, monkeypatch):
+    src = tmp_path / 'src'
+    (src / 'sub').mkdir(parents=True)
+    for name in ('sub/door_close.wav', 'AMBMisc_hotel.wav'):
+        shutil.copyfile(str(tiny_wav_mono), str(src / name))
+
+    proc = WAVsToAAFProcessor()
+    reads = []
+    real_chunks = proc.extractor.extract_all_metadata_chunks
+    monkeypatch.setattr(proc.extractor, 'extract_all_metadata_chunks', lambda p: reads.append(p) or real_chunks(p))
+    written = []
+
+    def fake_create(wav_metadata, bext, info, xml, ucs, out_file, fps=24, embed_audio=False, **kwargs):
+        written.append((out_file, fps, embed_audio, ucs['primary_category']['id']))
+        Path(out_file).write_bytes(b'aaf')
+        return out_file
+    monkeypatch.setattr(proc.generator, 'create_aaf_file', fake_create)
+
+    targets = [parse_output_target(spec, str(tmp_path / 'out')) for spec in
+               ('embedded:emb', 'linked:lnk24', 'linked:lnk25,fps=25', 'ale:ale,fps=25')]
+    assert proc.process_targets(str(src), targets) == 0
+
+    assert len(reads) == 2  # each file parsed once for all four targets
+    assert len(written) == 6
+    assert {(Path(o).relative_to(tmp_path / 'out').parts[0], fps, embed) for o, fps, embed, _ in written} == {
+        ('emb', 24.0, True), ('lnk24', 24.0, False), ('lnk25', 25.0, False)}
+    assert (tmp_path / 'out' / 'lnk25' / 'sub' / 'door_close.aaf').exists()
+    assert {ucs for out, _, _, ucs in written if 'AMBMisc' in out} == {'AMBMisc'}
+    ale = (tmp_path / 'out' / 'ale' / 'batch.ale').read_text()
+    assert 'FPS\t25' in ale and 'door_close.wav' in ale and 'AMBMisc_hotel.wav' in ale
+
+
+def test_cancelled_targets_leave_batch_outputs(tmp_path, tiny_wav_mono: Path, monkeypatch):
+    src = tmp_path / 'src'
+    src.mkdir()
+    for name in ('a.wav', 'b.wav', 'c.wav'):
+        shutil.copyfile(str(tiny_wav_mono), str(src / name))
+    proc = WAVsToAAFProcessor()
+    cancel = threading.Event()
+    real_extract = proc._extract_file_record
+    monkeypatch.setattr(proc, '_extract_file_record', lambda wav: cancel.set() or real_extract(wav))
+    multi = []
+    monkeypatch.setattr(proc.generator, 'create_multi_aaf', lambda entries, out_file, **kwargs: multi.append(out_file))
+    ale = tmp_path / 'out' / 'ale' / 'batch.ale'
+    ale.parent.mkdir(parents=True)
+    ale.write_text('previous run')
+
+    targets = [parse_output_target(spec, str(tmp_path / 'out')) for spec in ('linked:lnk,one-aaf', 'ale:ale')]
+    assert proc.process_targets(str(src), targets, cancel_event=cancel) == 0
+    assert multi == []
+    assert not (tmp_path / 'out' / 'lnk' / 'batch.aaf').exists()
+    assert ale.read_text() == 'previous run'
@@ -0,0 +1,58 @@
+import os
+import shutil
+import time
+from pathlib import Path
+from wav_to_aaf import WAVsToAAFProcessor, ThroughputModel
+
+
+def test_plan_reads_headers_and_counts_actions(tmp_path, tiny_wav_mono: Path, tiny_wav_stereo: Path):
+    src_dir = tmp_path / 'src'
+    out_dir = tmp_path / 'out'
+    (src_dir / 'sub').mkdir(parents=True)
+    shutil.copyfile(str(tiny_wav_mono), str(src_dir / 'mono.wav'))
+    shutil.copyfile(str(tiny_wav_stereo), str(src_dir / 'sub' / 'stereo.wav'))
+
+    # An AAF newer than its WAV counts as up to date
+    (out_dir / 'sub').mkdir(parents=True)
+    up_to_date = out_dir / 'sub' / 'stereo.aaf'
+    up_to_date.write_bytes(b'')
+    later = time.time() + 10
+    os.utime(str(up_to_date), (later, later))
+
+    proc = WAVsToAAFProcessor()
+    header = proc.extractor.read_riff_header(str(src_dir / 'mono.wav'))
+    assert header['channels'] == 1 and header['sample_rate'] == 48000
+    assert header['frames'] == 480
+    assert b'data' in header['metadata_bytes'] and len(header['metadata_bytes']) < header['file_size']
+
+    model = ThroughputModel(path=tmp_path / 'throughput.json', host='test')
+    plan = proc.plan_directory(str(src_dir), str(out_dir), embed_audio=True, skip_up_to_date=True, model=model)
+    assert plan['actions'] == {'embedded': 1, 'up to date': 1}
+    assert plan['essence_bytes'] == 480 * 2
+    assert plan['output_files'] == 1
+
+    plan = proc.plan_directory(str(src_dir), str(out_dir), embed_audio=True, sample_rate=96000, model=model)
+    assert plan['actions'] == {'needs conversion': 2}
+    assert plan['essence_bytes'] == 960 * 2 + 960 * 2 * 2
+
+    plan = proc.plan_directory(str(src_dir), str(out_dir), embed_audio=False, model=model)
+    assert plan['actions'] == {'linked': 2}
+    assert plan['essence_bytes'] == 0
+    assert not any(out_dir.rglob('*.ale'))
+
+
+def test_throughput_model_calibrates_from_profile_samples(tmp_path):
+    model = ThroughputModel(path=tmp_path / 'throughput.json', host='test')
+    assert 'defaults' in model.describe('linked')
+    assert model.record({'mode': 'linked', 'files': 100, 'output_bytes': 100 * 50000, 'seconds': 2.0})
+    assert model.record({'mode': 'embedded', 'files': 10, 'essence_bytes': 400_000_000, 'seconds': 2.5})
+    model.save()
+
+    reloaded = ThroughputModel(path=tmp_path / 'throughput.json', host='test')
+    assert reloaded.per_file_seconds('linked') == 0.02
+    assert reloaded.overhead_bytes('linked') == 50000
+    # 2.5s minus the embedded per-file default (10 x 0.05s) leaves 2s for 400MB of essence
+    assert abs(reloaded.essence_bytes_per_sec() - 200_000_000) < 1
+    assert abs(reloaded.estimate_seconds('linked', 50) - 1.0) < 1e-9
+    # Samples are per host
+    assert ThroughputModel(path=tmp_path / 'throughput.json', host='other').samples == []
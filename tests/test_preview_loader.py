@@ -0,0 +1,55 @@
+import wave
+from pathlib import Path
+from wav_to_aaf_gui import PreviewLoader, compute_preview_view
+
+
+def _write_wav(path: Path, channels: int = 1, frames: int = 48000):
+    with wave.open(str(path), 'wb') as w:
+        w.setnchannels(channels)
+        w.setsampwidth(2)
+        w.setframerate(48000)
+        w.writeframes(b'\0\0' * channels * frames)
+
+
+def _row(name, score, category='', ucs_id='', description=''):
+    return {'name': name, 'description': description, 'category': category, 'ucs_id': ucs_id,
+            'score': score, 'channels': 1, 'sample_rate': 48000, 'duration': 1.0}
+
+
+def test_loader_reads_rows_and_skips_bad_files(tmp_path: Path, monkeypatch):
+    _write_wav(tmp_path / 'DOORWood_Close.wav')
+    _write_wav(tmp_path / 'rain_loop.wav', channels=2, frames=96000)
+    _write_wav(tmp_path / 'explodes.wav')
+    (tmp_path / 'garbage.wav').write_bytes(b'not a riff file at all')
+    loader = PreviewLoader(str(tmp_path))
+    resolve = loader.processor._resolve_ucs_metadata
+
+    def flaky_resolve(filename, *args, **kwargs):
+        if filename == 'explodes.wav':
+            raise ValueError('bad metadata')
+        return resolve(filename, *args, **kwargs)
+    monkeypatch.setattr(loader.processor, '_resolve_ucs_metadata', flaky_resolve)
+
+    loader._run()
+    assert loader.error is None and loader.done
+    rows = {row['name']: row for row in loader.loaded_rows()}
+    assert sorted(rows) == ['DOORWood_Close.wav', 'rain_loop.wav']
+    assert loader.skipped == 2 and loader.total == 4
+    assert rows['rain_loop.wav']['channels'] == 2 and rows['rain_loop.wav']['duration'] == 2.0
+    # Every row has been through the batch guess, so none is left unresolved
+    assert all(row['ucs_id'] is not None for row in rows.values())
+
+
+def test_compute_view_filters_and_sorts():
+    rows = [_row('b_rain.wav', 80, 'Rain', 'RAINNatr'), _row('a_door.wav', 20, 'Doors', 'DOORWood'),
+            _row('c_wind.wav', 50, description='Gusty wind')]
+    assert [r['name'] for r in compute_preview_view(rows, ('', 0, 100, None, False))] == \
+        ['b_rain.wav', 'a_door.wav', 'c_wind.wav']
+    assert [r['name'] for r in compute_preview_view(rows, ('', 0, 100, 'name', False))] == \
+        ['a_door.wav', 'b_rain.wav', 'c_wind.wav']
+    assert [r['name'] for r in compute_preview_view(rows, ('', 0, 100, 'score', True))] == \
+        ['b_rain.wav', 'c_wind.wav', 'a_door.wav']
+    assert [r['name'] for r in compute_preview_view(rows, ('', 30, 100, None, False))] == \
+        ['b_rain.wav', 'c_wind.wav']
+    assert [r['name'] for r in compute_preview_view(rows, ('doorwood', 0, 100, None, False))] == ['a_door.wav']
+    assert [r['name'] for r in compute_preview_view(rows, ('gusty', 0, 100, None, False))] == ['c_wind.wav']
@@ -0,0 +1,46 @@
+import wav_to_aaf
+from wav_to_aaf import AAFGenerator
+
+
+def test_open_passes_sector_size_only_when_chosen(monkeypatch):
+    calls = []
+
+    def fake_open(path=None, mode='r', sector_size=4096, extensions=True):
+        return path
+
+    def spy(path, mode, **kwargs):
+        calls.append(kwargs.get('sector_size'))
+        return path
+    spy.__signature__ = wav_to_aaf.inspect.signature(fake_open)
+    monkeypatch.setattr(wav_to_aaf.aaf2, 'open', spy)
+    gen = AAFGenerator()
+    gen._open_aaf_for_write('default.aaf')
+    gen.sector_size = 512
+    gen._open_aaf_for_write('small.aaf')
+    gen.sector_size = 4096
+    gen._open_aaf_for_write('large.aaf')
+    assert calls == [None, 512, 4096]
+
+
+def test_open_without_sector_size_option_does_not_retry_errors(monkeypatch, capsys):
+    calls = []
+
+    def old_open(path, mode='r'):
+        calls.append(path)
+        if path == 'bad.aaf':
+            raise TypeError('real bug inside aaf2.open')
+        return path
+    monkeypatch.setattr(wav_to_aaf.aaf2, 'open', old_open)
+    assert wav_to_aaf.aaf_open_sector_size_default() is None
+    gen = AAFGenerator()
+    gen.sector_size = 4096
+    assert gen._open_aaf_for_write('a.aaf') == 'a.aaf'
+    assert gen._open_aaf_for_write('b.aaf') == 'b.aaf'
+    assert capsys.readouterr().out.count('no sector_size option') == 1
+    try:
+        gen._open_aaf_for_write('bad.aaf')
+    except TypeError:
+        pass
+    else:
+        raise AssertionError('TypeError from aaf2.open was swallowed')
+    assert calls == ['a.aaf', 'b.aaf', 'bad.aaf']
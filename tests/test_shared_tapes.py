@@ -0,0 +1,67 @@
+from wav_to_aaf import AAFGenerator
+
+
+def _entry(path, time_reference=0, seconds=2.0, originator_reference='', xml=None):
+    return {
+        'wav_metadata': {'filepath': path, 'sample_rate': 48000, 'frames': int(seconds * 48000)},
+        'bext_metadata': {'originator_reference': originator_reference, 'time_reference': time_reference},
+        'xml_metadata': xml or {},
+    }
+
+
+def test_tape_name_precedence():
+    assert AAFGenerator.tape_name_for(_entry('/rec/Roll_A/t1.wav')) == 'Roll_A'
+    assert AAFGenerator.tape_name_for(_entry('/rec/Roll_A/t1.wav', originator_reference='REF9')) == 'REF9'
+    assert AAFGenerator.tape_name_for(_entry('/rec/Roll_A/t1.wav', originator_reference='REF9',
+                                             xml={'xml_TAPE': 'T004'})) == 'T004'
+
+
+def test_clips_share_one_tape_with_timecode_offsets():
+    hour = 3600 * 48000
+    entries = [
+        _entry('/rec/Roll_A/t2.wav', time_reference=hour + 48000 * 10),  # 01:00:10:00
+        _entry('/rec/Roll_A/t1.wav', time_reference=hour),               # 01:00:00:00
+        _entry('/rec/Roll_B/t1.wav', time_reference=48000, seconds=1.0),
+    ]
+    tapes = AAFGenerator.group_tapes(entries, fps=25)
+    assert sorted(tapes) == ['Roll_A', 'Roll_B']
+    roll_a = tapes['Roll_A']
+    assert roll_a['start'] == 3600 * 25
+    assert roll_a['length'] == 10 * 25 + 2 * 25
+    assert [(e['wav_metadata']['filepath'], offset, length) for e, offset, length in roll_a['clips']] == [
+        ('/rec/Roll_A/t2.wav', 250, 50), ('/rec/Roll_A/t1.wav', 0, 50)]
+    assert tapes['Roll_B'] == {'start': 25, 'length': 25, 'clips': [(entries[2], 0, 25)]}
+
+
+def test_clips_without_time_reference_keep_their_own_tape():
+    entries = [
+        _entry('/rec/Roll_A/t1.wav', time_reference=3600 * 48000),
+        _entry('/rec/Roll_A/t2.wav'),
+        _entry('/rec/Roll_A/t3.wav', xml={'xml_TAPE': 'T004'}),
+    ]
+    tapes = AAFGenerator.group_tapes(entries, fps=25)
+    assert list(tapes) == ['Roll_A']
+    assert [e for e, _, _ in tapes['Roll_A']['clips']] == [entries[0]]
+
+
+def test_same_tape_name_in_other_libraries_gets_its_own_identity():
+    def tape(path, date='2024-05-01', originator='Recorder A'):
+        entry = _entry(path, time_reference=48000)
+        entry['bext_metadata'].update(origination_date=date, originator=originator)
+        return AAFGenerator.group_tapes([entry], fps=25)['Audio']
+
+    here = AAFGenerator.tape_identity(tape('/libs/one/Audio/t1.wav'))
+    assert AAFGenerator.tape_identity(tape('/libs/one/Audio/t1.wav')) == here
+    assert AAFGenerator.tape_identity(tape('/libs/two/Audio/t1.wav')) != here
+    assert AAFGenerator.tape_identity(tape('/libs/one/Audio/t1.wav', date='2024-05-02')) != here
+    assert AAFGenerator.tape_identity(tape('/libs/one/Audio/t1.wav', originator='Recorder B')) != here
+
+
+def test_tape_identity_uses_common_folder_and_earliest_clip():
+    early = _entry('/rec/Day1/a/t1.wav', time_reference=48000)
+    early['bext_metadata'].update(origination_date='2024-05-01', originator='Early')
+    late = _entry('/rec/Day1/b/t2.wav', time_reference=480000)
+    late['bext_metadata'].update(origination_date='2024-05-02', originator='Late')
+    late['xml_metadata'] = early['xml_metadata'] = {'xml_TAPE': 'Day1'}
+    tape = AAFGenerator.group_tapes([late, early], fps=25)['Day1']
+    assert AAFGenerator.tape_identity(tape) == ('/rec/Day1', '2024-05-01', 'Early')
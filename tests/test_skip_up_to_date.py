@@ -0,0 +1,28 @@
+import os
+import wave
+from pathlib import Path
+from wav_to_aaf import WAVsToAAFProcessor
+
+
+def _write_wav(path: Path, channels: int, frames: int = 4800):
+    with wave.open(str(path), 'wb') as w:
+        w.setnchannels(channels)
+        w.setsampwidth(2)
+        w.setframerate(48000)
+        w.writeframes(b'\0\0' * channels * frames)
+
+
+def test_up_to_date_clips_keep_their_ale_rows(tmp_path: Path):
+    src, out = tmp_path / 'src', tmp_path / 'out'
+    src.mkdir()
+    out.mkdir()
+    for name, channels in (('rain', 1), ('door', 2)):
+        _write_wav(src / f'{name}.wav', channels)
+        (out / f'{name}.aaf').write_bytes(b'')
+        os.utime(out / f'{name}.aaf', (os.path.getmtime(src / f'{name}.wav') + 10,) * 2)
+    proc = WAVsToAAFProcessor()
+    assert proc.process_directory(str(src), str(out), emit_ale=True, skip_up_to_date=True) == 0
+    assert all((out / f'{name}.aaf').stat().st_size == 0 for name in ('rain', 'door'))
+    ale = (out / 'batch.ale').read_text()
+    assert 'rain.wav' in ale and 'door.wav' in ale
+    assert 'A1A2' in ale
@@ -0,0 +1,58 @@
+import struct
+from pathlib import Path
+from wav_to_aaf import SyncGroupIndex, WAVsToAAFProcessor
+
+
+def _meta(start_s, seconds, rate=48000, day='2024-05-01'):
+    return {'sample_rate': rate, 'frames': int(seconds * rate)}, {'time_reference': int(start_s * rate),
+                                                                  'origination_date': day}
+
+
+def test_overlapping_recordings_share_a_group():
+    index = SyncGroupIndex()
+    items = {
+        'a_cam': _meta(100, 30),                # 100-130
+        'b_cam': _meta(120, 5, rate=44100),     # inside a_cam, other sample rate
+        'c_cam': _meta(129, 10),                # chains onto a_cam's group
+        'later': _meta(200, 10),
+        'next_day': _meta(120, 5, day='2024-05-02'),
+    }
+    for name, (wav_meta, bext_meta) in items.items():
+        assert index.add(name, wav_meta, bext_meta)
+    assert not index.add('untimed', {'sample_rate': 48000, 'frames': 10}, {'time_reference': 0})
+    groups = dict(index.assign())
+    assert groups['a_cam'] == groups['b_cam'] == groups['c_cam'] == 'SG20240501-0001'
+    assert groups['later'] == 'SG20240501-0002'
+    assert groups['next_day'] == 'SG20240502-0001'
+
+    gapped = SyncGroupIndex(gap_seconds=80)
+    for name, (wav_meta, bext_meta) in items.items():
+        gapped.add(name, wav_meta, bext_meta)
+    assert dict(gapped.assign())['later'] == 'SG20240501-0001'
+
+
+def _write_bwf(path: Path, start_s: float, seconds: float, rate: int = 48000):
+    bext = bytearray(602)
+    bext[320:330] = b'2024-05-01'
+    bext[338:346] = struct.pack('<Q', int(start_s * rate))
+    fmt = struct.pack('<HHIIHH', 1, 1, rate, rate * 2, 2, 16)
+    data = bytes(int(seconds * rate) * 2)
+    body = (b'WAVE' + b'fmt ' + struct.pack('<I', len(fmt)) + fmt + b'bext' + struct.pack('<I', len(bext)) + bext
+            + b'data' + struct.pack('<I', len(data)) + data)
+    path.write_bytes(b'RIFF' + struct.pack('<I', len(body)) + body)
+
+
+def test_ale_only_run_writes_sync_group_column(tmp_path: Path):
+    src = tmp_path / 'src'
+    src.mkdir()
+    _write_bwf(src / 'recA_001.wav', 3600, 0.5)
+    _write_bwf(src / 'recB_001.wav', 3600.25, 0.5)
+    _write_bwf(src / 'recA_002.wav', 3700, 0.5)
+    proc = WAVsToAAFProcessor()
+    proc.sync_groups = True
+    assert proc.process_directory(str(src), str(tmp_path / 'out'), ale_only=True) == 0
+    lines = (tmp_path / 'out' / 'batch.ale').read_text().splitlines()
+    cols = lines[lines.index('Column') + 1].split('\t')
+    rows = {r.split('\t')[0]: dict(zip(cols, r.split('\t'))) for r in lines[lines.index('Data') + 1:]}
+    assert rows['recA_001']['SyncGroup'] == rows['recB_001']['SyncGroup'] == 'SG20240501-0001'
+    assert rows['recA_002']['SyncGroup'] == 'SG20240501-0002'
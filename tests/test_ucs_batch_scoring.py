@@ -0,0 +1,51 @@
+import shutil
+from pathlib import Path
+from wav_to_aaf import UCSProcessor, WAVsToAAFProcessor
+
+
+def _corpus(u: UCSProcessor):
+    items = [
+        ('chicken_cackle_01.wav', 'Animals, birds, chicken cackle'),
+        ('door_wood_close.wav', ''),
+        ('TOONAnml_chicken_cackle.wav', 'Animals, birds, chicken cackle'),
+        ('gunshot rifle distant.WAV', 'Weapons firearm'),
+        ('Metal-impact.heavy_clang.wav', 'IMPACT METAL'),
+        ('vehicle car pass by fast', 'car'),
+        ('ab.wav', 'xy'),
+        ('zzzz.wav', ''),
+    ]
+    # Every 10th category: keyword-style names and subcategory-style names
+    for n, info in enumerate(list(u.ucs_data.values())[::10]):
+        keywords = '_'.join(k.replace(' ', '_') for k in info['keywords'][:3])
+        items.append((f"{keywords}_{n:02d}.wav", info['full_name'].lower()))
+        items.append((f"{info['subcategory']} Close.wav", ''))
+    return items
+
+
+def test_batch_scores_match_scalar_scorer():
+    u = UCSProcessor()
+    items = _corpus(u)
+    batch = u.categorize_batch(items)
+    for (filename, description), result in zip(items, batch):
+        assert result == u.categorize_sound(filename, description), filename
+
+    exact_only = u.categorize_batch(items, allow_guess=False)
+    for (filename, description), result in zip(items, exact_only):
+        assert result == u.categorize_sound(filename, description, allow_guess=False), filename
+
+
+def test_ale_only_run_batch_scores_low_confidence_report(tmp_path, tiny_wav_mono: Path):
+    src_dir = tmp_path / 'src'
+    out_dir = tmp_path / 'out'
+    src_dir.mkdir()
+    for name in ('fx_door_close.wav', 'TOONAnml_chicken.wav'):
+        shutil.copyfile(str(tiny_wav_mono), str(src_dir / name))
+
+    proc = WAVsToAAFProcessor()
+    proc._ucs_min_score = 999.0
+    ret = proc.process_directory(str(src_dir), str(out_dir), ale_only=True)
+    assert ret == 0
+    report = (out_dir / 'ucs_low_confidence.csv').read_text()
+    # Fuzzy guess is reported; the exact-ID clip (score 100) is not
+    assert 'fx_door_close.wav' in report
+    assert 'TOONAnml_chicken.wav' not in report
@@ -0,0 +1,33 @@
+import json
+import sys
+from pathlib import Path
+from wav_to_aaf import UCSProcessor
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / 'dev'))
+from eval_ucs_matching import DEFAULT_BASELINE, DEFAULT_CORPUS, evaluate, load_corpus  # noqa: E402
+
+
+def test_scorers_agree_and_meet_baseline_accuracy():
+    u = UCSProcessor()
+    corpus = load_corpus(DEFAULT_CORPUS)
+    assert corpus and all(expected in u.ucs_data for _, _, expected in corpus)
+    baseline = json.loads(DEFAULT_BASELINE.read_text())
+    assert baseline['queries'] == len(corpus)
+
+    scalar = evaluate(u, corpus, 'scalar')
+    for name in ('batch', 'batch-all'):
+        report = evaluate(u, corpus, name)
+        assert report['results'] == scalar['results'], name
+    assert scalar['top1'] >= baseline['top1'] and scalar['top5'] >= baseline['top5']
+    assert scalar['top1'] <= scalar['top5']
+    assert scalar['p50_us'] <= scalar['p90_us'] <= scalar['p99_us'] <= scalar['max_us']
+
+
+def test_low_confidence_rate_follows_min_score():
+    u = UCSProcessor()
+    corpus = load_corpus(DEFAULT_CORPUS)
+    assert evaluate(u, corpus, 'batch-all', min_score=0.0)['low_confidence'] == 0.0
+    # Exact UCS ID prefixes score 100 and are never low confidence
+    everything = evaluate(u, corpus, 'batch-all', min_score=100.0)['low_confidence']
+    exact = sum(1 for filename, _, expected in corpus if filename.startswith(expected))
+    assert 0 < everything <= 1 - exact / len(corpus)
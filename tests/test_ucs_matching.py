@@ -19,3 +19,17 @@ def test_ucs_exact_only_mode():
     res2 = u.categorize_sound('TOONAnml_chicken_cackle.wav', 'Animals, birds, chicken cackle', allow_guess=False)
     assert res2 and 'primary_category' in res2
     assert res2['primary_category']['id'] == 'TOONAnml'
+
+
+def test_ucs_typo_tolerant_matching():
+    u = UCSProcessor()
+    # "helecopter" is one edit away from the HELICOPTER subcategory
+    res = u.categorize_sound('helecopter_hover_close.wav')
+    assert res['primary_category']['id'] == 'AEROHeli'
+    partial, fuzzy = u._word_matches('helecopter')
+    assert 'helicopter' in fuzzy
+
+    u.set_max_edit_distance(0)
+    assert u._word_matches('helecopter')[1] == frozenset()
+    res = u.categorize_sound('helecopter_hover_close.wav')
+    assert res['primary_category']['id'] != 'AEROHeli'
@@ -0,0 +1,74 @@
+import os
+import shutil
+from pathlib import Path
+import pytest
+from wav_to_aaf import WAVMetadataExtractor, WAVsToAAFProcessor, XattrChunkCache
+
+
+def _cached_copy(src: Path, dst: Path) -> str:
+    shutil.copyfile(str(src), str(dst))
+    cache = XattrChunkCache()
+    try:
+        cache._setxattr(str(dst), cache.ATTR_NAME, b'probe')
+    except (OSError, TypeError):
+        pytest.skip('user extended attributes not supported here')
+    return str(dst)
+
+
+def test_xattr_cache_serves_second_read_without_parsing(tmp_path, tiny_wav_stereo: Path, monkeypatch):
+    wav = _cached_copy(tiny_wav_stereo, tmp_path / 'door_close.wav')
+    proc = WAVsToAAFProcessor()
+    proc.extractor.xattr_cache = XattrChunkCache()
+    basic = proc.extractor.extract_basic_info(wav)
+    chunks = proc.extractor.extract_all_metadata_chunks(wav)
+    ucs = proc._resolve_ucs_metadata('door_close.wav', '', {}, {}, wav_path=wav)
+    assert proc.extractor.xattr_cache.stats['writes'] >= 3
+
+    # A fresh extractor (another machine, same file) reads the xattr instead of parsing
+    fresh = WAVsToAAFProcessor()
+    fresh.extractor.xattr_cache = XattrChunkCache()
+    monkeypatch.setattr('wave.open', lambda *a, **k: pytest.fail('basic info parsed again'))
+    monkeypatch.setattr(WAVMetadataExtractor, 'read_riff_header', lambda *a: pytest.fail('chunks parsed again'))
+    monkeypatch.setattr(fresh, '_resolve_ucs_uncached', lambda *a, **k: pytest.fail('UCS scored again'))
+    # (creation_time is the ctime, which the xattr write itself bumps)
+    again = fresh.extractor.extract_basic_info(wav)
+    assert {k: v for k, v in again.items() if k != 'creation_time'} == \
+        {k: v for k, v in basic.items() if k != 'creation_time'}
+    assert fresh.extractor.extract_all_metadata_chunks(wav) == chunks
+    assert fresh._resolve_ucs_metadata('door_close.wav', '', {}, {}, wav_path=wav) == ucs
+    # Markers, regions and header-only reads use the cached chunk table
+    header = fresh.extractor.chunk_header(wav)
+    assert [c[0] for c in header['chunks']] == ['fmt ', 'data']
+    assert header['channels'] == 2 and 'metadata_bytes' not in header
+    assert fresh.extractor.extract_regions(wav) == []
+    assert fresh._header_basic_info(wav)['frames'] == basic['frames']
+
+
+def test_cached_ucs_results_go_stale_with_the_ucs_table(tmp_path, tiny_wav_mono: Path, monkeypatch):
+    wav = _cached_copy(tiny_wav_mono, tmp_path / 'door_close.wav')
+    proc = WAVsToAAFProcessor()
+    proc.extractor.xattr_cache = XattrChunkCache()
+    proc._resolve_ucs_metadata('door_close.wav', '', {}, {}, wav_path=wav)
+
+    # Same file and options, different UCS list: scored again instead of served from the xattr
+    fresh = WAVsToAAFProcessor()
+    fresh.extractor.xattr_cache = XattrChunkCache()
+    fresh.ucs_processor.table_hash = 'another-list'
+    monkeypatch.setattr(fresh, '_resolve_ucs_uncached', lambda *a, **k: {'rescored': True})
+    assert fresh._resolve_ucs_metadata('door_close.wav', '', {}, {}, wav_path=wav) == {'rescored': True}
+
+
+def test_xattr_cache_invalidated_when_file_changes(tmp_path, tiny_wav_mono: Path, tiny_wav_stereo: Path):
+    wav = _cached_copy(tiny_wav_mono, tmp_path / 'clip.wav')
+    extractor = WAVMetadataExtractor()
+    extractor.xattr_cache = XattrChunkCache()
+    assert extractor.extract_basic_info(wav)['channels'] == 1
+
+    # Same path, different content: size/mtime/header checksum no longer match
+    with open(str(tiny_wav_stereo), 'rb') as src, open(wav, 'r+b') as dst:
+        dst.write(src.read())
+    os.utime(wav, ns=(0, 10 ** 18))
+    fresh = WAVMetadataExtractor()
+    fresh.xattr_cache = XattrChunkCache()
+    assert fresh.extract_basic_info(wav)['channels'] == 2
+    assert fresh.xattr_cache.stats['misses'] == 1
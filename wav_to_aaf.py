@@ -41,16 +41,26 @@ import argparse
 import csv
 import re
 import io
+import string
 import hashlib
+import zlib
+import zipfile
+import tarfile
 import threading
+import weakref
+import time
 import subprocess
 import tempfile
 import shutil
 import webbrowser
 import logging
+import json
+import platform
+import inspect
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
 from datetime import datetime
-from typing import Any, Dict, List, Optional, Tuple
+from typing import Any, Callable, Dict, List, Optional, Tuple
 import xml.etree.ElementTree as ET
 import aaf2
 import aaf2.auid
@@ -69,6 +79,56 @@ AAF_PARAMETERDEF_PAN = aaf2.auid.AUID("e4962322-2267-11d3-8a4c-0050040ef7d2")
 AAF_OPERATIONDEF_MONOAUDIOPAN = aaf2.auid.AUID("9d2ea893-0968-11d3-8a38-0050040ef7d2")
 
 
+# ParameterDef / InterpolationDef / OperationDef of the pan effect per open AAF file, so clips
+# built one by one don't re-create and re-register (and fail to register) them per channel
+_pan_defs_cache = weakref.WeakKeyDictionary()
+
+
+def _pan_defs(f) -> Tuple:
+    try:
+        cached = _pan_defs_cache.get(f)
+    except TypeError:
+        cached = None
+    if cached is not None:
+        return cached
+    # Register ParameterDef for Pan
+    typedef = f.dictionary.lookup_typedef("Rational")
+    param_def = f.create.ParameterDef(AAF_PARAMETERDEF_PAN, "Pan", "Pan", typedef)
+    try:
+        f.dictionary.register_def(param_def)
+    except Exception as e:
+        # Already registered
+        logger.debug(f"ParameterDef already registered: {e}")
+        param_def = f.dictionary.lookup_def(AAF_PARAMETERDEF_PAN)
+    
+    # Register InterpolationDef
+    try:
+        interp_def = f.create.InterpolationDef(
+            aaf2.misc.LinearInterp, "LinearInterp", "LinearInterp"
+        )
+        f.dictionary.register_def(interp_def)
+    except Exception as e:
+        logger.debug(f"InterpolationDef already registered: {e}")
+        interp_def = f.dictionary.lookup_def(aaf2.misc.LinearInterp)
+    
+    # Register OperationDef for MonoAudioPan
+    try:
+        opdef = f.create.OperationDef(AAF_OPERATIONDEF_MONOAUDIOPAN, "Audio Pan")
+        opdef.media_kind = "sound"
+        opdef["NumberInputs"].value = 1
+        f.dictionary.register_def(opdef)
+    except Exception as e:
+        logger.debug(f"OperationDef already registered: {e}")
+        opdef = f.dictionary.lookup_def(AAF_OPERATIONDEF_MONOAUDIOPAN)
+    
+    defs = (param_def, interp_def, opdef)
+    try:
+        _pan_defs_cache[f] = defs
+    except TypeError:
+        pass
+    return defs
+
+
 def _apply_pan_to_slot(f, mslot, mclip, pan_value: float, length_val: int):
     """
     Add pan control to a master timeline slot using OperationGroup with VaryingValue.
@@ -81,35 +141,7 @@ def _apply_pan_to_slot(f, mslot, mclip, pan_value: float, length_val: int):
         length_val: Length in samples/frames
     """
     try:
-        # Register ParameterDef for Pan
-        typedef = f.dictionary.lookup_typedef("Rational")
-        param_def = f.create.ParameterDef(AAF_PARAMETERDEF_PAN, "Pan", "Pan", typedef)
-        try:
-            f.dictionary.register_def(param_def)
-        except Exception as e:
-            # Already registered
-            logger.debug(f"ParameterDef already registered: {e}")
-            param_def = f.dictionary.lookup_def(AAF_PARAMETERDEF_PAN)
-        
-        # Register InterpolationDef
-        try:
-            interp_def = f.create.InterpolationDef(
-                aaf2.misc.LinearInterp, "LinearInterp", "LinearInterp"
-            )
-            f.dictionary.register_def(interp_def)
-        except Exception as e:
-            logger.debug(f"InterpolationDef already registered: {e}")
-            interp_def = f.dictionary.lookup_def(aaf2.misc.LinearInterp)
-        
-        # Register OperationDef for MonoAudioPan
-        try:
-            opdef = f.create.OperationDef(AAF_OPERATIONDEF_MONOAUDIOPAN, "Audio Pan")
-            opdef.media_kind = "sound"
-            opdef["NumberInputs"].value = 1
-            f.dictionary.register_def(opdef)
-        except Exception as e:
-            logger.debug(f"OperationDef already registered: {e}")
-            opdef = f.dictionary.lookup_def(AAF_OPERATIONDEF_MONOAUDIOPAN)
+        param_def, interp_def, opdef = _pan_defs(f)
         
         # Create OperationGroup
         opgroup = f.create.OperationGroup(opdef)
@@ -259,6 +291,38 @@ def convert_to_wav(src_path: str, dst_path: str, samplerate: int = 48000, bits:
         raise RuntimeError(error_msg)
 
 
+def _umid_seed(wav_path: Path) -> str:
+    """Stable per-file seed of the deterministic UMIDs: hash of path, size and whole-second mtime"""
+    abs_path = str(wav_path.resolve())
+    try:
+        st = wav_path.stat()
+        file_size, mod_time = st.st_size, int(st.st_mtime)
+    except OSError:
+        file_size = mod_time = 0
+    return hashlib.sha256(f"{abs_path}|{file_size}|{mod_time}".encode('utf-8')).hexdigest()
+
+
+def deterministic_umid_bytes(wav_path: Path, mob_type: str = "master", tape_mode: bool = False,
+                             seed: Optional[str] = None) -> bytes:
+    """32-byte basic UMID derived from the file's path, size and modification time.
+
+    The label/length/instance half is fixed (Avid-style 01010f10 prefix in tape mode, 01010f20
+    otherwise); the material number is the first 16 bytes of a hash that includes mob_type.
+    seed is _umid_seed(wav_path), passed in when several UMIDs of one file are made at once.
+    """
+    base_hash = seed or _umid_seed(wav_path)
+    # Add mob type differentiation
+    mob_hash = hashlib.sha256(f"{base_hash}|{mob_type}".encode('utf-8')).digest()
+    prefix = "060a2b340101010501010f1013000000" if tape_mode else "060a2b340101010501010f2013000000"
+    return bytes.fromhex(prefix) + mob_hash[:16]
+
+
+def umid_urn(umid: bytes) -> str:
+    """SMPTE URN for a 32-byte UMID, in the byte order MXF stores it"""
+    groups = [umid[i:i + 4].hex() for i in range(0, 32, 4)]
+    return "urn:smpte:umid:" + ".".join(groups)
+
+
 def create_deterministic_umid(wav_path: Path, mob_type: str = "master", tape_mode: bool = False) -> aaf2.mobid.MobID:
     """
     Create a deterministic UMID based on file path, size, and modification time.
@@ -272,40 +336,8 @@ def create_deterministic_umid(wav_path: Path, mob_type: str = "master", tape_mod
         Deterministic MobID that will be the same across runs for the same file
     """
     try:
-        # Create a stable seed from file properties
-        abs_path = str(wav_path.resolve())
-        file_size = wav_path.stat().st_size if wav_path.exists() else 0
-        mod_time = int(wav_path.stat().st_mtime) if wav_path.exists() else 0
-        
-        # Create base hash from file properties
-        base_data = f"{abs_path}|{file_size}|{mod_time}".encode('utf-8')
-        base_hash = hashlib.sha256(base_data).hexdigest()
-        
-        # Add mob type differentiation
-        mob_data = f"{base_hash}|{mob_type}".encode('utf-8')
-        mob_hash = hashlib.sha256(mob_data).digest()
-        
-        # Create SMPTE UMID URN string from hash
-        # Choose UMID prefix based on mode
-        if tape_mode:
-            # Avid-style prefix from ALE-exported AAFs: 01010f10
-            prefix = "060a2b34.01010105.01010f10.13000000"
-        else:
-            # Standard prefix: 01010f20  
-            prefix = "060a2b34.01010105.01010f20.13000000"
-        
-        # Use first 16 bytes of hash to create the instance part (4 groups of 8 hex chars)
-        instance_bytes = mob_hash[:16]
-        instance_parts = []
-        for i in range(0, 16, 4):
-            hex_part = instance_bytes[i:i+4].hex()
-            instance_parts.append(hex_part)
-        
-        instance_str = ".".join(instance_parts)
-        urn = f"urn:smpte:umid:{prefix}.{instance_str}"
-        
         # Create MobID from URN string
-        return aaf2.mobid.MobID(urn)
+        return aaf2.mobid.MobID(umid_urn(deterministic_umid_bytes(wav_path, mob_type, tape_mode)))
         
     except Exception as e:
         print(f"Warning: Could not create deterministic UMID for {wav_path}: {e}")
@@ -313,14 +345,360 @@ def create_deterministic_umid(wav_path: Path, mob_type: str = "master", tape_mod
         return aaf2.mobid.MobID()
 
 
+def create_deterministic_umids(wav_path: Path, mob_types: List[str], tape_mode: bool = False) -> List:
+    """create_deterministic_umid for several mob types of one file, resolving and stat-ing it once"""
+    try:
+        seed = _umid_seed(wav_path)
+        return [aaf2.mobid.MobID(umid_urn(deterministic_umid_bytes(wav_path, mob_type, tape_mode, seed)))
+                for mob_type in mob_types]
+    except Exception:
+        return [create_deterministic_umid(wav_path, mob_type, tape_mode) for mob_type in mob_types]
+
+
+def create_tape_umid(tape_name: str, identity: Tuple[str, ...] = ()) -> aaf2.mobid.MobID:
+    """Deterministic Avid-style (01010f10) UMID for a shared tape SourceMob.
+
+    Tape names often fall back to generic folder names ("Audio", "Day1"), so the seed also takes
+    identity (see AAFGenerator.tape_identity); unrelated libraries then get different tape UMIDs.
+    """
+    try:
+        seed = "|".join(("tape", tape_name) + tuple(identity))
+        material = hashlib.sha256(seed.encode('utf-8')).digest()[:16]
+        return aaf2.mobid.MobID(umid_urn(bytes.fromhex("060a2b340101010501010f1013000000") + material))
+    except Exception as e:
+        print(f"Warning: Could not create deterministic UMID for tape {tape_name}: {e}")
+        return aaf2.mobid.MobID()
+
+
+LOCATOR_SETS = ('all', 'mac', 'windows', 'posix')
+
+
+def parse_locator_remap(spec: str) -> Tuple[str, str]:
+    """Parse an 'OLD=NEW' path-prefix remap (e.g. '/Volumes/SFX=//nas/sfx')"""
+    old, sep, new = spec.partition('=')
+    old, new = old.strip(), new.strip()
+    if not sep or not old or not new:
+        raise ValueError(f"Locator remap must look like OLD=NEW: {spec}")
+    return old, new
+
+
+def load_locator_remap_file(path: str) -> List[Tuple[str, str]]:
+    """Read OLD=NEW remap lines from a text file ('#' comments and blank lines are ignored)"""
+    remaps = []
+    with open(path, 'r', encoding='utf-8') as fh:
+        for line in fh:
+            line = line.strip()
+            if line and not line.startswith('#'):
+                remaps.append(parse_locator_remap(line))
+    return remaps
+
+
+def remap_locator_path(path: str, remaps: List[Tuple[str, str]]) -> str:
+    """Replace the longest matching OLD prefix of a forward-slash path with its NEW prefix"""
+    path = path.replace('\\', '/')
+    for old, new in sorted(remaps, key=lambda item: len(item[0]), reverse=True):
+        old = old.replace('\\', '/').rstrip('/')
+        if path == old or path.startswith(old + '/'):
+            return new.replace('\\', '/').rstrip('/') + path[len(old):]
+    return path
+
+
+def _file_url(path: str) -> str:
+    """file:// URL for a forward-slash POSIX, drive-letter ('Z:/...') or UNC ('//server/share/...') path"""
+    from urllib.parse import quote
+    if path.startswith('//'):
+        return f"file:{quote(path)}"
+    if re.match(r'^[A-Za-z]:/', path):
+        return f"file:///{path[:2]}{quote(path[2:])}"
+    return f"file://{quote(path)}"
+
+
+def build_locator_urls(wav_path: Path, relative: bool = False, remaps: Optional[List[Tuple[str, str]]] = None,
+                       locator_set: str = 'all', avid_volume_url: bool = True) -> List[str]:
+    """Locator URLs for a linked WAV after applying the path-prefix remap table.
+
+    'all' writes every variant Media Composer may try (Avid volume URL, file:// and file://localhost
+    URLs, absolute path, bare filename). 'mac' and 'windows' write only the file:// URL of the
+    remapped path, 'posix' only the absolute path, so the first locator MC tries already resolves.
+    """
+    if relative:
+        return [f"./{wav_path.name}"]
+    path = remap_locator_path(wav_path.as_posix(), remaps or [])
+    if locator_set in ('mac', 'windows'):
+        return [_file_url(path)]
+    if locator_set == 'posix':
+        return [path]
+    from urllib.parse import quote
+    local = path.startswith('/') and not path.startswith('//')
+    urls = [f"file:///Macintosh%20HD{quote(path)}"] if avid_volume_url and local else []
+    urls += [_file_url(path), f"file://localhost{quote(path)}", path, wav_path.name]
+    return urls
+
+
+class XattrChunkCache:
+    """Parsed chunk data kept in an extended attribute on each WAV, so it travels with the file.
+
+    The attribute holds zlib-compressed JSON: the RIFF chunk table and fmt/data fields of
+    read_riff_header, extract_basic_info fields, the decoded BEXT/INFO/XML chunks and resolved
+    UCS results. A record is only used while the file's
+    size, mtime and a CRC of its first HEADER_BYTES bytes still match; otherwise it is rebuilt.
+    Without xattr support (platform, filesystem or a read-only share) files are simply parsed.
+    """
+
+    VERSION = 2
+    HEADER_BYTES = 4096
+    ATTR_NAME = 'user.wavstoaaf.chunks' if sys.platform.startswith('linux') else 'com.wavstoaaf.chunks'
+
+    def __init__(self):
+        self.stats = {'hits': 0, 'misses': 0, 'writes': 0, 'errors': 0}
+        # Record of the file being processed, keyed by path with its (size, mtime_ns)
+        self._memo: Dict[str, Tuple[Tuple, Dict]] = {}
+        self._getxattr, self._setxattr = self._backend()
+
+    @staticmethod
+    def _backend() -> Tuple[Optional[Callable], Optional[Callable]]:
+        if hasattr(os, 'getxattr'):
+            return os.getxattr, os.setxattr
+        try:
+            import xattr  # macOS has no os.getxattr; the optional 'xattr' package provides it
+            return xattr.getxattr, xattr.setxattr
+        except ImportError:
+            return None, None
+
+    @property
+    def available(self) -> bool:
+        return self._getxattr is not None
+
+    def load(self, wav_path: str) -> Dict:
+        """Return the valid record for wav_path (a fresh, empty one if missing or stale)"""
+        if not self.available:
+            return {}
+        key = os.path.abspath(wav_path)
+        try:
+            st = os.stat(wav_path)
+            memo = self._memo.get(key)
+            if memo and memo[0] == (st.st_size, st.st_mtime_ns):
+                return memo[1]
+            with open(wav_path, 'rb') as fh:
+                signature = [st.st_size, st.st_mtime_ns, zlib.crc32(fh.read(self.HEADER_BYTES))]
+        except OSError:
+            return {}
+        record = None
+        try:
+            data = json.loads(zlib.decompress(self._getxattr(wav_path, self.ATTR_NAME)).decode('utf-8'))
+            if data.get('v') == self.VERSION and data.get('sig') == signature:
+                record = data
+        except (OSError, ValueError, zlib.error):
+            pass
+        if record is None:
+            record = {'v': self.VERSION, 'sig': signature}
+        self._memo = {key: ((st.st_size, st.st_mtime_ns), record)}
+        return record
+
+    def get(self, wav_path: str, field: str):
+        value = self.load(wav_path).get(field)
+        self.stats['hits' if value is not None else 'misses'] += 1
+        return value
+
+    def update(self, wav_path: str, **fields):
+        """Merge fields into the record and write it back to the file's xattr"""
+        record = self.load(wav_path)
+        if not record:
+            return
+        for name, value in fields.items():
+            if name == 'ucs' and isinstance(record.get(name), dict):
+                # UCS results are keyed by matching options; keep the other keys
+                record[name].update(value)
+            else:
+                record[name] = value
+        try:
+            payload = zlib.compress(json.dumps(record, separators=(',', ':'), default=str).encode('utf-8'))
+            self._setxattr(wav_path, self.ATTR_NAME, payload)
+            self.stats['writes'] += 1
+        except OSError as e:
+            # Read-only share, no user xattrs, or the record is over the filesystem's size limit
+            self.stats['errors'] += 1
+            logger.debug(f"Could not write chunk cache xattr on {wav_path}: {e}")
+
+
+class RangeFile:
+    """Read-only, seekable view of bytes [offset, offset + size) of another file.
+
+    Lets the RIFF chunk walker and the essence writer read a stored archive member in place:
+    seeks are relative to the member, reads stop at its end, and readinto() goes straight to
+    the underlying unbuffered file.
+    """
+
+    def __init__(self, fh, offset: int, size: int, name: str = ''):
+        self._fh = fh
+        self.offset = offset
+        self.size = size
+        self.name = name
+        self._pos = 0
+
+    def seek(self, pos: int, whence: int = 0) -> int:
+        base = {0: 0, 1: self._pos, 2: self.size}[whence]
+        self._pos = max(0, base + pos)
+        return self._pos
+
+    def tell(self) -> int:
+        return self._pos
+
+    def read(self, n: int = -1) -> bytes:
+        remaining = max(0, self.size - self._pos)
+        n = remaining if n is None or n < 0 else min(n, remaining)
+        if n == 0:
+            return b''
+        self._fh.seek(self.offset + self._pos)
+        data = self._fh.read(n)
+        self._pos += len(data)
+        return data
+
+    def readinto(self, buf) -> int:
+        view = memoryview(buf)
+        n = min(len(view), max(0, self.size - self._pos))
+        if n == 0:
+            return 0
+        self._fh.seek(self.offset + self._pos)
+        got = self._fh.readinto(view[:n]) or 0
+        self._pos += got
+        return got
+
+    def close(self):
+        self._fh.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+class ArchiveMember:
+    """A WAV stored uncompressed inside a ZIP or TAR archive, addressed by byte range.
+
+    Stands in for a WAV path wherever the file is only read through open_wav_source()
+    (RIFF header walk, essence streaming). str() is 'archive/member' for messages and UMID seeds.
+    """
+
+    def __init__(self, archive: Path, name: str, offset: int, size: int, mtime: float = 0.0):
+        self.archive = Path(archive)
+        self.name = name
+        self.offset = offset
+        self.size = size
+        self.mtime = mtime
+
+    @property
+    def path(self) -> Path:
+        return self.archive / self.name
+
+    def open(self, buffering: int = -1) -> RangeFile:
+        return RangeFile(open(self.archive, 'rb', buffering=buffering), self.offset, self.size, str(self))
+
+    def __str__(self) -> str:
+        return str(self.path)
+
+    def __repr__(self) -> str:
+        return f"ArchiveMember({self.archive.name}!{self.name}, offset={self.offset}, size={self.size})"
+
+
+def open_wav_source(source, buffering: int = -1):
+    """Open a WAV path or ArchiveMember for binary reading"""
+    if isinstance(source, ArchiveMember):
+        return source.open(buffering)
+    return open(source, 'rb', buffering=buffering)
+
+
+def is_archive(path) -> bool:
+    path = Path(path)
+    if not path.is_file():
+        return False
+    try:
+        return zipfile.is_zipfile(path) or tarfile.is_tarfile(path)
+    except OSError:
+        return False
+
+
+def is_safe_member_name(name: str) -> bool:
+    """False for archive member names that would resolve outside the output directory
+    (absolute paths, drive letters, '..' segments)"""
+    parts = name.replace('\\', '/').split('/')
+    if name.startswith(('/', '\\')) or re.match(r'^[A-Za-z]:', name):
+        return False
+    return '..' not in parts
+
+
+def list_archive_wavs(archive_path) -> Tuple[List[ArchiveMember], List[Tuple[str, str]]]:
+    """Stored WAV members of a ZIP or uncompressed TAR, in archive order.
+
+    Returns (members, skipped) where skipped lists (member name, reason) for WAVs that can't be
+    read in place (compressed, encrypted or sparse members) or whose names are unsafe as output
+    paths (absolute, drive letter or '..'). A compressed TAR raises ValueError.
+    """
+    archive_path = Path(archive_path)
+    members: List[ArchiveMember] = []
+    skipped: List[Tuple[str, str]] = []
+    is_wav = lambda name: Path(name).suffix.lower() in ('.wav', '.wave') and not Path(name).name.startswith('._')
+    if zipfile.is_zipfile(archive_path):
+        with zipfile.ZipFile(archive_path) as zf, open(archive_path, 'rb') as fh:
+            for info in zf.infolist():
+                if info.is_dir() or not is_wav(info.filename):
+                    continue
+                if not is_safe_member_name(info.filename):
+                    skipped.append((info.filename, 'unsafe path'))
+                    continue
+                if info.flag_bits & 0x1:
+                    skipped.append((info.filename, 'encrypted'))
+                    continue
+                if info.compress_type != zipfile.ZIP_STORED:
+                    skipped.append((info.filename, 'compressed (only stored members can be read in place)'))
+                    continue
+                # Data starts after the local header, whose name/extra lengths can differ from the central directory
+                fh.seek(info.header_offset)
+                local = fh.read(30)
+                if len(local) < 30 or local[:4] != b'PK\x03\x04':
+                    skipped.append((info.filename, 'bad local header'))
+                    continue
+                name_len, extra_len = struct.unpack('<HH', local[26:30])
+                offset = info.header_offset + 30 + name_len + extra_len
+                mtime = datetime(*info.date_time).timestamp()
+                members.append(ArchiveMember(archive_path, info.filename, offset, info.file_size, mtime))
+        return members, skipped
+    try:
+        tf = tarfile.open(archive_path, 'r:')
+    except tarfile.ReadError:
+        raise ValueError(f"{archive_path.name} is not a ZIP or uncompressed TAR archive "
+                         f"(compressed TARs can't be read in place)")
+    with tf:
+        for info in tf:
+            if not info.isfile() or not is_wav(info.name):
+                continue
+            if not is_safe_member_name(info.name):
+                skipped.append((info.name, 'unsafe path'))
+                continue
+            if info.issparse():
+                skipped.append((info.name, 'sparse member'))
+                continue
+            members.append(ArchiveMember(archive_path, info.name, info.offset_data, info.size, info.mtime))
+    return members, skipped
+
+
 class WAVMetadataExtractor:
     """Extract metadata from WAV files including BEXT chunk data"""
     
     def __init__(self):
         self.supported_formats = ['.wav', '.wave']
+        # Optional XattrChunkCache; when set, parsed results are read from / written to the files
+        self.xattr_cache: Optional[XattrChunkCache] = None
     
     def extract_basic_info(self, wav_path: str, allow_fallback: bool = True) -> Dict:
         """Extract basic audio information from WAV file"""
+        cached = self.xattr_cache.get(wav_path, 'basic') if self.xattr_cache else None
+        if cached:
+            return dict(cached, filename=Path(wav_path).name, filepath=wav_path,
+                        file_size=os.path.getsize(wav_path),
+                        creation_time=datetime.fromtimestamp(os.path.getctime(wav_path)).isoformat(),
+                        modification_time=datetime.fromtimestamp(os.path.getmtime(wav_path)).isoformat())
         try:
             with wave.open(wav_path, 'rb') as wav_file:
                 frames = wav_file.getnframes()
@@ -329,19 +707,20 @@ class WAVMetadataExtractor:
                 sample_width = wav_file.getsampwidth()
                 duration = frames / sample_rate if sample_rate > 0 else 0
                 
-                return {
-                    'filename': Path(wav_path).name,
-                    'filepath': wav_path,
+                basic = {
                     'frames': frames,
                     'sample_rate': sample_rate,
                     'channels': channels,
                     'sample_width': sample_width,
                     'duration_seconds': duration,
                     'duration_timecode': self._seconds_to_timecode(duration),
-                    'file_size': os.path.getsize(wav_path),
-                    'creation_time': datetime.fromtimestamp(os.path.getctime(wav_path)).isoformat(),
-                    'modification_time': datetime.fromtimestamp(os.path.getmtime(wav_path)).isoformat()
                 }
+            if self.xattr_cache:
+                self.xattr_cache.update(wav_path, basic=basic)
+            return dict(basic, filename=Path(wav_path).name, filepath=wav_path,
+                        file_size=os.path.getsize(wav_path),
+                        creation_time=datetime.fromtimestamp(os.path.getctime(wav_path)).isoformat(),
+                        modification_time=datetime.fromtimestamp(os.path.getmtime(wav_path)).isoformat())
         except Exception as e:
             wave_info = self._describe_wave_file(wav_path)
             if allow_fallback and ffmpeg_available():
@@ -434,25 +813,220 @@ class WAVMetadataExtractor:
         
         return bext_data
     
+    def read_riff_header(self, wav_path: str) -> Dict:
+        """Walk the RIFF chunk list without reading the audio payload.
+
+        Returns fmt fields, the data chunk offset/size, the chunk list and 'metadata_bytes'
+        (the file with the data payload left out, for the BEXT/INFO/XML parsers).
+        Returns {} if the file is not RIFF/WAVE. wav_path may also be an ArchiveMember.
+        """
+        with open_wav_source(wav_path) as f:
+            file_size = f.size if isinstance(f, RangeFile) else os.fstat(f.fileno()).st_size
+            riff = f.read(12)
+            if len(riff) < 12 or riff[:4] != b'RIFF' or riff[8:12] != b'WAVE':
+                return {}
+            header = {'file_size': file_size, 'chunks': [], 'data_offset': None, 'data_size': 0}
+            parts = [riff]
+            offset = 12
+            while offset + 8 <= file_size:
+                f.seek(offset)
+                chunk_header = f.read(8)
+                if len(chunk_header) < 8:
+                    break
+                chunk_id = chunk_header[:4]
+                chunk_size = struct.unpack('<I', chunk_header[4:8])[0]
+                header['chunks'].append((chunk_id.decode('ascii', errors='replace'), offset, chunk_size))
+                if chunk_id == b'data':
+                    # Audio payload: record where it is, never read it
+                    header['data_offset'] = offset + 8
+                    header['data_size'] = min(chunk_size, file_size - offset - 8)
+                    parts.append(chunk_header)
+                else:
+                    payload = f.read(chunk_size + (chunk_size % 2))
+                    parts.append(chunk_header + payload)
+                    if chunk_id == b'fmt ' and len(payload) >= 16:
+                        audio_format, channels, sample_rate, _, block_align, bits = struct.unpack('<HHIIHH', payload[:16])
+                        if audio_format == 0xFFFE and len(payload) >= 26:
+                            # WAVE_FORMAT_EXTENSIBLE: the real format is the first field of the SubFormat GUID
+                            audio_format = struct.unpack('<H', payload[24:26])[0]
+                        header.update({'audio_format': audio_format, 'channels': channels,
+                                       'sample_rate': sample_rate, 'block_align': block_align,
+                                       'bits_per_sample': bits})
+                offset += 8 + chunk_size + (chunk_size % 2)
+            header['metadata_bytes'] = b''.join(parts)
+            block_align = header.get('block_align') or 0
+            header['frames'] = header['data_size'] // block_align if block_align else 0
+            return header
+
+    def chunk_header(self, wav_path) -> Dict:
+        """read_riff_header without 'metadata_bytes', served from the xattr cache when it is valid.
+
+        For the callers that only need the chunk table and fmt/data fields (markers, regions,
+        plan and memory estimates). Archive members are always walked.
+        """
+        cache = self.xattr_cache if isinstance(wav_path, (str, Path)) else None
+        cached = cache.get(str(wav_path), 'header') if cache else None
+        if cached:
+            return dict(cached, chunks=[tuple(chunk) for chunk in cached['chunks']])
+        header = self.read_riff_header(wav_path)
+        header.pop('metadata_bytes', None)
+        if cache and header:
+            cache.update(str(wav_path), header=header)
+        return header
+
     def extract_all_metadata_chunks(self, wav_path: str) -> Dict:
         """Extract all metadata chunks from WAV file (BEXT, LIST-INFO, XML)"""
         all_metadata = {}
+        cached = self.xattr_cache.get(wav_path, 'metadata') if self.xattr_cache else None
+        if cached is not None:
+            return dict(cached)
         
         try:
-            # Read entire file into memory for efficient chunk parsing
-            with open(wav_path, 'rb') as f:
-                data = f.read()
+            # Only the chunk headers and metadata payloads are read; audio data is skipped
+            header = self.read_riff_header(wav_path)
+            data = header.get('metadata_bytes')
+            if data is None:
+                # Not a RIFF/WAVE file: fall back to scanning the whole file
+                with open(wav_path, 'rb') as f:
+                    data = f.read()
             
-            # Parse different chunk types
-            all_metadata.update(self._parse_bext_chunk_from_data(data))
-            all_metadata.update(self._parse_info_chunks(data))
-            all_metadata.update(self._parse_xml_chunks(data))
+            all_metadata = self.parse_metadata_bytes(data)
+            if self.xattr_cache:
+                fields = {'metadata': all_metadata}
+                if header:
+                    fields['header'] = {k: v for k, v in header.items() if k != 'metadata_bytes'}
+                self.xattr_cache.update(wav_path, **fields)
             
         except Exception as e:
             print(f"Error reading metadata chunks from {wav_path}: {e}")
         
         return all_metadata
     
+    def parse_metadata_bytes(self, data: bytes) -> Dict:
+        """BEXT, LIST-INFO and XML metadata from a read_riff_header 'metadata_bytes' blob"""
+        all_metadata = {}
+        all_metadata.update(self._parse_bext_chunk_from_data(data))
+        all_metadata.update(self._parse_info_chunks(data))
+        all_metadata.update(self._parse_xml_chunks(data))
+        return all_metadata
+
+    def basic_info_from_header(self, header: Dict, name: str, filepath: str) -> Dict:
+        """extract_basic_info-shaped dict built from a read_riff_header result (no wave module read)"""
+        channels = int(header.get('channels') or 0)
+        sample_rate = int(header.get('sample_rate') or 0)
+        if not channels or not sample_rate or header.get('data_offset') is None:
+            return {}
+        if header.get('audio_format') not in (1, None):
+            return {}
+        duration = header['frames'] / sample_rate
+        return {
+            'frames': header['frames'],
+            'sample_rate': sample_rate,
+            'channels': channels,
+            'sample_width': header['block_align'] // channels,
+            'duration_seconds': duration,
+            'duration_timecode': self._seconds_to_timecode(duration),
+            'filename': Path(name).name,
+            'filepath': filepath,
+            'file_size': header.get('file_size', 0),
+        }
+
+    def extract_markers(self, wav_path: str, time_reference: int = 0, header: Optional[Dict] = None) -> List[Dict]:
+        """Read cue points (cue + LIST/adtl labl, note, ltxt) and iXML sync points.
+
+        Returns dicts with 'name', 'start' and 'length' in sample frames of this file, plus 'comment'
+        and 'source' ('cue' or 'ixml'); cue markers also carry their 'cue_id'. Length 0 means a point marker; ltxt lengths and iXML event
+        durations make regions. ABSOLUTE iXML sync points are made file-relative with time_reference.
+        """
+        header = header or self.chunk_header(wav_path)
+        if not header:
+            return []
+        payloads = {'cue ': [], 'LIST': [], 'iXML': []}
+        with open(wav_path, 'rb') as fh:
+            for chunk_id, offset, size in header['chunks']:
+                if chunk_id in payloads:
+                    fh.seek(offset + 8)
+                    payload = fh.read(size)
+                    if chunk_id != 'LIST' or payload[:4] == b'adtl':
+                        payloads[chunk_id].append(payload)
+
+        def text(raw: bytes) -> str:
+            return self._sanitize_string(raw.split(b'\x00')[0].decode('utf-8', errors='replace'))
+
+        cues = {}
+        for payload in payloads['cue ']:
+            count = struct.unpack('<I', payload[:4])[0] if len(payload) >= 4 else 0
+            for pos in range(4, min(len(payload) - 23, 4 + count * 24), 24):
+                cue_id, position, _, _, _, sample_offset = struct.unpack('<II4sIII', payload[pos:pos + 24])
+                cues[cue_id] = {'name': '', 'start': sample_offset or position, 'length': 0,
+                                'comment': '', 'source': 'cue', 'cue_id': cue_id}
+        for payload in payloads['LIST']:
+            pos = 4
+            while pos + 8 <= len(payload):
+                sub_id = payload[pos:pos + 4]
+                sub_size = struct.unpack('<I', payload[pos + 4:pos + 8])[0]
+                body = payload[pos + 8:pos + 8 + sub_size]
+                cue = cues.get(struct.unpack('<I', body[:4])[0]) if len(body) >= 4 else None
+                if cue is not None:
+                    if sub_id == b'labl':
+                        cue['name'] = text(body[4:])
+                    elif sub_id == b'note':
+                        cue['comment'] = text(body[4:])
+                    elif sub_id == b'ltxt' and len(body) >= 20:
+                        # cue id, sample length, purpose, country, language, dialect, code page, text
+                        cue['length'] = struct.unpack('<I', body[4:8])[0]
+                        if not cue['name']:
+                            cue['name'] = text(body[20:])
+                pos += 8 + sub_size + (sub_size % 2)
+        markers = list(cues.values())
+
+        for payload in payloads['iXML']:
+            try:
+                root = ET.fromstring(payload.rstrip(b'\x00 \r\n\t'))
+            except ET.ParseError as e:
+                logger.debug(f"iXML not parseable for sync points in {wav_path}: {e}")
+                continue
+            for sync_point in root.iter('SYNC_POINT'):
+                def field(tag: str) -> str:
+                    return (sync_point.findtext(tag) or '').strip()
+                try:
+                    start = (int(field('SYNC_POINT_HIGH') or 0) << 32) | int(field('SYNC_POINT_LOW') or 0)
+                    length = int(field('SYNC_POINT_EVENT_DURATION') or 0)
+                except ValueError:
+                    continue
+                if field('SYNC_POINT_TYPE').upper() == 'ABSOLUTE':
+                    start -= int(time_reference or 0)
+                if start < 0:
+                    continue
+                markers.append({'name': self._sanitize_string(field('SYNC_POINT_COMMENT') or field('SYNC_POINT_FUNCTION')),
+                                'start': start, 'length': max(0, length),
+                                'comment': field('SYNC_POINT_FUNCTION'), 'source': 'ixml'})
+        return sorted(markers, key=lambda m: (m['start'], m['source']))
+
+    def extract_regions(self, wav_path: str, time_reference: int = 0) -> List[Dict]:
+        """Subclip regions for a WAV: its labeled regions, or else the spans between point markers.
+
+        Regions are in sample frames at the file's own rate ('sample_rate' is included so the
+        generator can rescale after sample-rate conversion).
+        """
+        header = self.chunk_header(wav_path)
+        total = header.get('frames', 0) if header else 0
+        markers = self.extract_markers(wav_path, time_reference, header) if total else []
+        regions = [dict(m) for m in markers if m['length'] > 0 and m['start'] < total]
+        if not regions:
+            starts = sorted({m['start'] for m in markers if 0 <= m['start'] < total})
+            by_start = {}
+            for m in markers:
+                by_start.setdefault(m['start'], m)
+            for n, start in enumerate(starts):
+                end = starts[n + 1] if n + 1 < len(starts) else total
+                regions.append(dict(by_start[start], length=end - start))
+        for n, region in enumerate(regions, start=1):
+            region['length'] = min(region['length'], total - region['start'])
+            region['name'] = region['name'] or f"Region {n:02d}"
+            region['sample_rate'] = header['sample_rate']
+        return regions
+
     def _parse_bext_chunk_from_data(self, data: bytes) -> Dict:
         """Parse BEXT chunk from raw file data"""
         bext_metadata = {}
@@ -771,10 +1345,17 @@ class WAVMetadataExtractor:
 
 class UCSProcessor:
     """Process Universal Category System (UCS) data for sound categorization"""
+
+    # A text word within max_edit_distance of a category term ("helecopter" → HELICOPTER)
+    # earns this fraction of what the correctly spelled term is worth in that category
+    FUZZY_MATCH_WEIGHT = 0.5
     
-    def __init__(self):
+    def __init__(self, max_edit_distance: int = 1):
         self.ucs_data = {}
         self.ucs_loaded = False
+        # Digest of the loaded categories, so cached UCS results go stale with the UCS list
+        self.table_hash = ''
+        self.max_edit_distance = max_edit_distance
         self.load_ucs_data()
     
     def load_ucs_data(self):
@@ -813,6 +1394,9 @@ class UCSProcessor:
                                     'keywords': [k.strip() for k in keywords_str.split(',') if k.strip()] if keywords_str else []
                                 }
                     self.ucs_loaded = True
+                    self.table_hash = hashlib.sha1(
+                        json.dumps(self.ucs_data, sort_keys=True).encode('utf-8')).hexdigest()[:16]
+                    self._build_token_index()
                     print(f"Loaded {len(self.ucs_data)} UCS categories from {ucs_file.name}")
                     break
                 except Exception as e:
@@ -821,6 +1405,117 @@ class UCSProcessor:
         if not self.ucs_loaded:
             print("Warning: No UCS file found. UCS categorization will be disabled.")
     
+    def _build_token_index(self):
+        """Word-level lookup tables built once per UCS list.
+
+        - per category: its long (4+ char) name words and its vocabulary terms, each with the
+          weight an exact hit earns (subcategory 7, category 5, whole keyword 3, name word 2,
+          any other word 1.5)
+        - every 4+ char substring of every long name word, so partial word matches are
+          dictionary lookups instead of a loop over all name words
+        - a symmetric-deletion index over the vocabulary for typo-tolerant lookups
+        """
+        def words(value: str) -> List[str]:
+            return re.sub(r'[^\w\s]|_', ' ', value.lower()).split()
+
+        self._category_terms: Dict[str, Tuple[set, Dict[str, float]]] = {}
+        self._long_name_words: Dict[str, List[str]] = {}
+        self._name_word_substrings: Dict[str, set] = {}
+        self._vocab_categories: Dict[str, List[Tuple[str, float]]] = {}
+        for ucs_id, info in self.ucs_data.items():
+            long_name_words = {w for w in info['full_name'].lower().split() if len(w) > 3}
+            vocab: Dict[str, float] = {}
+
+            def credit(term_words: List[str], weight: float, whole_only: bool = False):
+                if whole_only and len(term_words) != 1:
+                    return
+                for word in term_words:
+                    if len(word) > 3:
+                        vocab[word] = max(vocab.get(word, 0.0), weight)
+
+            credit(words(' '.join([info['category'], info['subcategory']] + info['keywords'])), 1.5)
+            credit(words(info['full_name']), 2.0)
+            for keyword in info['keywords']:
+                credit(words(keyword), 3.0, whole_only=True)
+            credit(words(info['category']), 5.0, whole_only=True)
+            credit(words(info['subcategory']), 7.0, whole_only=True)
+
+            self._category_terms[ucs_id] = (long_name_words, vocab)
+            for name_word in long_name_words:
+                self._long_name_words.setdefault(name_word, []).append(ucs_id)
+            for word, weight in vocab.items():
+                self._vocab_categories.setdefault(word, []).append((ucs_id, weight))
+        for name_word in self._long_name_words:
+            for i in range(len(name_word)):
+                for j in range(i + 4, len(name_word) + 1):
+                    self._name_word_substrings.setdefault(name_word[i:j], set()).add(name_word)
+        self._max_name_word_len = max((len(w) for w in self._long_name_words), default=0)
+        self.set_max_edit_distance(self.max_edit_distance)
+
+    def set_max_edit_distance(self, max_edit_distance: int):
+        """Rebuild the typo index for a new maximum edit distance (0 disables fuzzy matching)"""
+        self.max_edit_distance = max(0, int(max_edit_distance))
+        self._deletion_index: Dict[str, set] = {}
+        if self.max_edit_distance:
+            for word in self._vocab_categories:
+                for variant in self._deletion_variants(word, self.max_edit_distance):
+                    self._deletion_index.setdefault(variant, set()).add(word)
+        self._word_match_cache: Dict[str, Tuple[frozenset, frozenset]] = {}
+        self._batch_index = None
+
+    @staticmethod
+    def _deletion_variants(word: str, max_distance: int) -> set:
+        variants = {word}
+        frontier = {word}
+        for _ in range(max_distance):
+            frontier = {w[:i] + w[i + 1:] for w in frontier for i in range(len(w))}
+            variants |= frontier
+        return variants
+
+    @staticmethod
+    def _edit_distance(a: str, b: str) -> int:
+        """Optimal string alignment distance (Levenshtein plus adjacent transpositions)"""
+        prev2 = None
+        prev = list(range(len(b) + 1))
+        for i in range(1, len(a) + 1):
+            cur = [i] + [0] * len(b)
+            for j in range(1, len(b) + 1):
+                cost = 0 if a[i - 1] == b[j - 1] else 1
+                cur[j] = min(prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + cost)
+                if prev2 is not None and i > 1 and j > 1 and a[i - 1] == b[j - 2] and a[i - 2] == b[j - 1]:
+                    cur[j] = min(cur[j], prev2[j - 2] + 1)
+            prev2, prev = prev, cur
+        return prev[len(b)]
+
+    def _word_matches(self, word: str) -> Tuple[frozenset, frozenset]:
+        """(long name words that contain / are contained in word, vocabulary terms within
+        max_edit_distance of word) for one text word; cached per word"""
+        cached = self._word_match_cache.get(word)
+        if cached is not None:
+            return cached
+        partial = set()
+        if len(word) > 3:
+            partial.update(self._name_word_substrings.get(word, ()))
+            for i in range(len(word)):
+                for j in range(i + 4, min(len(word), i + self._max_name_word_len) + 1):
+                    if word[i:j] in self._long_name_words:
+                        partial.add(word[i:j])
+        fuzzy = set()
+        distance = self.max_edit_distance
+        clean = word.strip(string.punctuation)
+        # Short words are too ambiguous for typo matching; exact vocabulary words need none
+        if distance and len(clean) >= 3 + 2 * distance and clean not in self._vocab_categories:
+            for variant in self._deletion_variants(clean, distance):
+                for term in self._deletion_index.get(variant, ()):
+                    if term not in fuzzy and abs(len(term) - len(clean)) <= distance and \
+                            self._edit_distance(clean, term) <= distance:
+                        fuzzy.add(term)
+        if len(self._word_match_cache) > 200000:
+            self._word_match_cache.clear()
+        result = (frozenset(partial), frozenset(fuzzy))
+        self._word_match_cache[word] = result
+        return result
+
     def categorize_sound(self, filename: str, description: str = "", allow_guess: bool = True) -> Dict:
         """Categorize sound based on filename and description"""
         if not self.ucs_loaded:
@@ -866,7 +1561,10 @@ class UCSProcessor:
         
         # Sort by score and return top matches
         best_matches.sort(reverse=True, key=lambda x: x[0])
-        
+        return self._build_category_result(best_matches)
+
+    def _build_category_result(self, best_matches: List[Tuple[float, str, Dict]]) -> Dict:
+        """Shape score-sorted (score, ucs_id, ucs_info) matches into a categorize_sound result"""
         if best_matches:
             # Return best match and alternatives
             best_score, best_id, best_info = best_matches[0]
@@ -940,26 +1638,1057 @@ class UCSProcessor:
                 elif word in subcategory_words:
                     score += 1.5
         
-        # Partial word matches
+        # Partial word matches (+0.5 per long name word containing / contained in a text
+        # word) and typo-tolerant matches, both via the precomputed token index
+        terms = self._category_terms.get(ucs_info.get('id'))
+        if terms is None:
+            terms = ({w for w in name_words if len(w) > 3}, {})
+        long_name_words, vocab = terms
         for text_word in text_words:
             if len(text_word) > 3:
-                for name_word in name_words:
-                    if len(name_word) > 3 and (text_word in name_word or name_word in text_word):
-                        score += 0.5
+                partial, fuzzy = self._word_matches(text_word)
+                score += 0.5 * len(partial & long_name_words)
+                if fuzzy:
+                    best = max((vocab[t] for t in fuzzy if t in vocab), default=0.0)
+                    score += self.FUZZY_MATCH_WEIGHT * best
         
         return score
 
+    def _build_batch_index(self):
+        """Precompute, for all categories at once, the weights _calculate_match_score applies
+        to one category at a time:
+
+        - phrase rows: substring features (full name +10, category +5, subcategory +7,
+          each keyword +3), matched per text with an Aho-Corasick automaton
+        - word rows: exact word features (+2 name / +1.5 category / +1.5 subcategory)
+        - partial (+0.5) and typo (FUZZY_MATCH_WEIGHT) word matches come from the shared
+          token index built in load_ucs_data
+        """
+        ids = list(self.ucs_data.keys())
+        phrase_rows: Dict[str, Dict[int, float]] = {}
+        word_rows: Dict[str, Dict[int, float]] = {}
+
+        def add(table, key, idx, weight):
+            row = table.setdefault(key, {})
+            row[idx] = row.get(idx, 0.0) + weight
+
+        for idx, ucs_id in enumerate(ids):
+            info = self.ucs_data[ucs_id]
+            full_name = info['full_name'].lower()
+            category = info['category'].lower()
+            subcategory = info['subcategory'].lower()
+            add(phrase_rows, full_name, idx, 10.0)
+            add(phrase_rows, category, idx, 5.0)
+            add(phrase_rows, subcategory, idx, 7.0)
+            for keyword in info['keywords']:
+                keyword = keyword.strip().lower()
+                if keyword:
+                    add(phrase_rows, keyword, idx, 3.0)
+
+            name_words = set(full_name.split())
+            category_words = set(category.split())
+            subcategory_words = set(subcategory.split())
+            for word in name_words | category_words | subcategory_words:
+                if len(word) > 2:
+                    add(word_rows, word, idx, 2.0 if word in name_words else 1.5)
+
+        # An empty phrase is "in" every text
+        baseline = phrase_rows.pop('', {})
+
+        # Aho-Corasick automaton over the remaining phrases
+        phrases = list(phrase_rows.keys())
+        goto: List[Dict[str, int]] = [{}]
+        fail = [0]
+        out: List[List[int]] = [[]]
+        for pid, phrase in enumerate(phrases):
+            node = 0
+            for ch in phrase:
+                nxt = goto[node].get(ch)
+                if nxt is None:
+                    nxt = len(goto)
+                    goto[node][ch] = nxt
+                    goto.append({})
+                    fail.append(0)
+                    out.append([])
+                node = nxt
+            out[node].append(pid)
+        queue = list(goto[0].values())  # depth-1 nodes fail to the root
+        for node in queue:
+            for ch, nxt in goto[node].items():
+                queue.append(nxt)
+                f = fail[node]
+                while f and ch not in goto[f]:
+                    f = fail[f]
+                fail[nxt] = goto[f].get(ch, 0)
+                out[nxt] = out[nxt] + out[fail[nxt]]
+
+        id_positions = {ucs_id: idx for idx, ucs_id in enumerate(ids)}
+        self._batch_index = {
+            'ids': ids,
+            'id_positions': id_positions,
+            'id_lengths': sorted({len(ucs_id) for ucs_id in ids}),
+            'baseline': baseline,
+            'phrase_rows': [phrase_rows[p] for p in phrases],
+            'goto': goto,
+            'fail': fail,
+            'out': out,
+            'word_rows': word_rows,
+            'name_word_cats': {w: [id_positions[i] for i in cats] for w, cats in self._long_name_words.items()},
+            'vocab_cats': {w: [(id_positions[i], weight) for i, weight in cats]
+                           for w, cats in self._vocab_categories.items()},
+            'word_cache': {},
+        }
+        return self._batch_index
+
+    def _batch_word_row(self, word: str) -> Dict[int, float]:
+        """Exact + partial word weights of one text word across all categories (cached)"""
+        index = self._batch_index
+        cached = index['word_cache'].get(word)
+        if cached is not None:
+            return cached
+        row = dict(index['word_rows'].get(word, {})) if len(word) > 2 else {}
+        if len(word) > 3:
+            partial, fuzzy = self._word_matches(word)
+            for name_word in partial:
+                for idx in index['name_word_cats'][name_word]:
+                    row[idx] = row.get(idx, 0.0) + 0.5
+            best: Dict[int, float] = {}
+            for term in fuzzy:
+                for idx, weight in index['vocab_cats'][term]:
+                    if weight > best.get(idx, 0.0):
+                        best[idx] = weight
+            for idx, weight in best.items():
+                row[idx] = row.get(idx, 0.0) + self.FUZZY_MATCH_WEIGHT * weight
+        index['word_cache'][word] = row
+        return row
+
+    def _batch_scores(self, text: str) -> Dict[int, float]:
+        """Sparse score vector of one normalized text: sum of matched phrase rows and word rows"""
+        index = self._batch_index
+        scores = dict(index['baseline'])
+        goto, fail, out = index['goto'], index['fail'], index['out']
+        matched = set()
+        node = 0
+        for ch in text:
+            while node and ch not in goto[node]:
+                node = fail[node]
+            node = goto[node].get(ch, 0)
+            if out[node]:
+                matched.update(out[node])
+        phrase_rows = index['phrase_rows']
+        for pid in matched:
+            for idx, weight in phrase_rows[pid].items():
+                scores[idx] = scores.get(idx, 0.0) + weight
+        for word in set(text.split()):
+            for idx, weight in self._batch_word_row(word).items():
+                scores[idx] = scores.get(idx, 0.0) + weight
+        return scores
+
+    def categorize_batch(self, items: List[Tuple[str, str]], allow_guess: bool = True) -> List[Dict]:
+        """Categorize many (filename, description) pairs at once.
+
+        Returns one categorize_sound-shaped result per item with identical scores and
+        ordering, but scores every text against all categories through a shared sparse
+        index instead of looping over categories per file. Identical texts are scored once.
+        """
+        if not self.ucs_loaded:
+            return [{} for _ in items]
+        index = getattr(self, '_batch_index', None) or self._build_batch_index()
+        ids, id_positions = index['ids'], index['id_positions']
+        results: List[Dict] = []
+        text_results: Dict[str, Dict] = {}
+        for filename, description in items:
+            filename_no_ext = re.sub(r'\.(wav|wave)$', '', filename, flags=re.IGNORECASE)
+            exact = [id_positions[filename_no_ext[:n]] for n in index['id_lengths']
+                     if len(filename_no_ext) >= n and filename_no_ext[:n] in id_positions]
+            if exact:
+                ucs_id = ids[min(exact)]
+                ucs_info = self.ucs_data[ucs_id]
+                results.append({
+                    'primary_category': {
+                        'id': ucs_id,
+                        'full_name': ucs_info['full_name'],
+                        'category': ucs_info['category'],
+                        'subcategory': ucs_info['subcategory'],
+                        'score': 100.0
+                    }
+                })
+                continue
+            if not allow_guess:
+                results.append({})
+                continue
+
+            text = f"{filename} {description}".lower()
+            text = re.sub(r'\.(wav|wave)$', '', text)
+            text = re.sub(r'[_\-\.]', ' ', text)
+            result = text_results.get(text)
+            if result is None:
+                ranked = sorted(((score, idx) for idx, score in self._batch_scores(text).items() if score > 0),
+                                key=lambda x: (-x[0], x[1]))[:6]
+                result = self._build_category_result([(score, ids[idx], self.ucs_data[ids[idx]])
+                                                      for score, idx in ranked])
+                text_results[text] = result
+            results.append(result)
+        return results
+
+ESSENCE_BLOCK_SIZE = 4 * 1024 * 1024
+# Recordings followed at once by process_growing (more queue until a follower finishes)
+FOLLOW_WORKERS = 8
+
+
+def aaf_open_sector_size_default() -> Optional[int]:
+    """Default of aaf2.open's sector_size option, or None if this pyaaf2 has no such option"""
+    try:
+        param = inspect.signature(aaf2.open).parameters.get('sector_size')
+    except (TypeError, ValueError):
+        return None
+    if param is None or not isinstance(param.default, int):
+        return None
+    return param.default
+
+
+def parse_byte_size(value: str) -> int:
+    """Parse '4M', '256K', '1G' or a plain byte count"""
+    text = str(value).strip().upper().rstrip('B')
+    scale = {'K': 1024, 'M': 1024 ** 2, 'G': 1024 ** 3}.get(text[-1:], 1)
+    if scale != 1:
+        text = text[:-1]
+    size = int(float(text) * scale)
+    if size <= 0:
+        raise ValueError(f"size must be positive: {value}")
+    return size
+
+
+class EssenceWriter:
+    """Move PCM from a WAV's data chunk into AAF essence in large blocks.
+
+    mode 'stream' reads the data chunk with readinto() in block_size pieces and writes each
+    block straight into the SourceMob essence stream (de-interleaved per block for per-channel
+    mobs), so no temp files are written and the file is never held in memory. Streams are
+    preallocated to frames × block_align when the stream supports truncate().
+    mode 'import' (the default) keeps pyaaf2's import_audio_essence; multi-channel files are still
+    split into per-channel temp WAVs block by block. 'stream' builds the PCMDescriptor and essence
+    slot itself, so it stays opt-in until tests/test_essence_roundtrip.py and the
+    dev/bench_essence_writer.py sweep have been run against pyaaf2. fsync='close' flushes each
+    finished AAF to disk.
+    """
+
+    MODES = ('stream', 'import')
+    FSYNC_POLICIES = ('none', 'close')
+
+    def __init__(self, block_size: int = ESSENCE_BLOCK_SIZE, preallocate: bool = True,
+                 fsync: str = 'none', mode: str = 'import'):
+        if mode not in self.MODES:
+            raise ValueError(f"Unknown essence writer mode: {mode}")
+        if fsync not in self.FSYNC_POLICIES:
+            raise ValueError(f"Unknown fsync policy: {fsync}")
+        self.block_size = max(1, int(block_size))
+        self.preallocate = preallocate
+        self.fsync = fsync
+        self.mode = mode
+        self.stats = {'bytes': 0, 'writes': 0, 'preallocated': 0, 'seconds': 0.0}
+        # One writer is shared by the clips of a --workers run
+        self._stats_lock = threading.Lock()
+        self._extractor = WAVMetadataExtractor()
+
+    def _count(self, **deltas):
+        with self._stats_lock:
+            for key, value in deltas.items():
+                self.stats[key] += value
+
+    def _source(self, wav_path: Path) -> Dict:
+        header = self._extractor.read_riff_header(wav_path)
+        if not header or header.get('data_offset') is None or not header.get('block_align'):
+            raise Exception(f"Could not locate PCM data in {wav_path}")
+        header['sample_width'] = header['block_align'] // max(1, header['channels'])
+        return header
+
+    def _blocks(self, wav_path: Path, header: Dict):
+        """Yield the data chunk in block_align-multiple blocks.
+
+        Raw reads (FileIO, network shares, RangeFile) may return part of a frame; the partial
+        frame is carried into the next block. The yielded buffer is reused by the next block.
+        Raises if the file ends before the header's frame count, since the descriptor Length
+        is already set from it.
+        """
+        block_align = header['block_align']
+        block = max(block_align, self.block_size - self.block_size % block_align)
+        remaining = header['frames'] * block_align
+        buf = bytearray(block)
+        view = memoryview(buf)
+        filled = 0
+        with open_wav_source(wav_path, buffering=0) as fh:
+            fh.seek(header['data_offset'])
+            while remaining > 0:
+                n = fh.readinto(view[filled:min(block, filled + remaining)])
+                if not n:
+                    raise Exception(f"{Path(str(wav_path)).name}: audio data ends {remaining} bytes short of the "
+                                    f"{header['frames']} frames in its header (truncated or still being written?)")
+                filled += n
+                remaining -= n
+                usable = filled - filled % block_align
+                if not usable:
+                    continue
+                yield buf if usable == block else bytearray(view[:usable])
+                tail = filled - usable
+                if tail:
+                    buf[:tail] = buf[usable:filled]
+                filled = tail
+
+    @staticmethod
+    def _split_block(block: bytearray, channels: int, sample_width: int) -> List[bytearray]:
+        """De-interleave one block of frames into per-channel sample bytes"""
+        block_align = channels * sample_width
+        frames = len(block) // block_align
+        outs = []
+        for c in range(channels):
+            out = bytearray(frames * sample_width)
+            for k in range(sample_width):
+                out[k::sample_width] = block[c * sample_width + k::block_align]
+            outs.append(out)
+        return outs
+
+    def _preallocate_stream(self, stream, size: int):
+        truncate = getattr(stream, 'truncate', None)
+        if not self.preallocate or truncate is None or size <= 0:
+            return
+        try:
+            truncate(size)
+            stream.seek(0)
+            self._count(preallocated=size)
+        except Exception as e:
+            logger.debug(f"Essence stream preallocation unavailable: {e}")
+
+    def _open_essence(self, f, mob, channels: int, sample_rate: int, sample_width: int,
+                      frames: int, edit_rate: int):
+        """PCMDescriptor + essence stream + sound slot on mob (what import_audio_essence sets up)"""
+        descriptor = f.create.PCMDescriptor()
+        descriptor['Channels'].value = channels
+        descriptor['BlockAlign'].value = channels * sample_width
+        descriptor['SampleRate'].value = sample_rate
+        descriptor['AverageBPS'].value = sample_rate * channels * sample_width
+        descriptor['QuantizationBits'].value = sample_width * 8
+        descriptor['AudioSamplingRate'].value = sample_rate
+        descriptor['Length'].value = frames
+        try:
+            descriptor['ContainerFormat'].value = f.dictionary.lookup_containerdef('AAF')
+        except Exception as e:
+            logger.debug(f"AAF container definition not found: {e}")
+        mob.descriptor = descriptor
+
+        slot_count = len(list(mob.slots))
+        stream = mob.create_essence(edit_rate, 'sound')
+        slots = list(mob.slots)
+        # create_essence adds the essence slot itself; older pyaaf2 leaves it to the caller
+        slot = slots[-1] if len(slots) > slot_count else mob.create_empty_slot(edit_rate, media_kind='sound')
+        slot.segment.length = frames
+        self._preallocate_stream(stream, frames * channels * sample_width)
+        return stream
+
+    def _write(self, stream, data):
+        stream.write(data)
+        self._count(bytes=len(data), writes=1)
+
+    def _followed_source(self, wav_path: Path, follower: Optional['GrowingWavFollower']) -> Dict:
+        """Header to embed from: the follower's (length still open) or the finished file's"""
+        if follower is None:
+            return self._source(wav_path)
+        if self.mode == 'import':
+            # import_audio_essence needs the whole file: wait for the recording to finish
+            follower.wait()
+            return dict(self._source(wav_path), frames=follower.frames)
+        if follower.header is None and follower.wait_for_header() is None:
+            raise Exception(f"No WAV header in {wav_path}")
+        return dict(follower.header, frames=0)
+
+    @staticmethod
+    def _set_essence_length(mob, frames: int):
+        """Final length of a followed recording on its descriptor and essence slot"""
+        mob.descriptor['Length'].value = frames
+        for slot in mob.slots:
+            slot.segment.length = frames
+
+    def embed_into(self, f, mob, wav_path: Path, edit_rate: int,
+                   follower: Optional['GrowingWavFollower'] = None):
+        """Embed all channels of wav_path into one existing SourceMob.
+
+        With a follower, audio is streamed while the file is still being written and the
+        lengths are set once it has finished.
+        """
+        start = time.perf_counter()
+        try:
+            if self.mode == 'import':
+                self._followed_source(wav_path, follower)
+                mob.import_audio_essence(str(wav_path), edit_rate=edit_rate)
+                self._count(bytes=os.path.getsize(wav_path))
+                return mob
+            header = self._followed_source(wav_path, follower)
+            stream = self._open_essence(f, mob, header['channels'], header['sample_rate'],
+                                        header['sample_width'], header['frames'], edit_rate)
+            blocks = follower.blocks(self.block_size) if follower else self._blocks(wav_path, header)
+            for block in blocks:
+                self._write(stream, block)
+            if follower is not None:
+                self._set_essence_length(mob, follower.frames)
+            return mob
+        finally:
+            self._count(seconds=time.perf_counter() - start)
+
+    def embed_channels(self, f, wav_path: Path, name: str, edit_rate: int,
+                       follower: Optional['GrowingWavFollower'] = None) -> List:
+        """Embed each channel of wav_path into its own mono SourceMob ('<name>.PHYS.chN')"""
+        start = time.perf_counter()
+        try:
+            header = self._followed_source(wav_path, follower)
+            channels, sample_width = header['channels'], header['sample_width']
+            mobs = [f.create.SourceMob(f"{name}.PHYS.ch{idx}") for idx in range(1, channels + 1)]
+            if self.mode == 'import':
+                self._import_channels(mobs, wav_path, header, edit_rate)
+                return mobs
+            streams = [self._open_essence(f, mob, 1, header['sample_rate'], sample_width,
+                                          header['frames'], edit_rate) for mob in mobs]
+            blocks = follower.blocks(self.block_size) if follower else self._blocks(wav_path, header)
+            for block in blocks:
+                for stream, data in zip(streams, self._split_block(block, channels, sample_width)):
+                    self._write(stream, data)
+            if follower is not None:
+                for mob in mobs:
+                    self._set_essence_length(mob, follower.frames)
+            return mobs
+        finally:
+            self._count(seconds=time.perf_counter() - start)
+
+    def _import_channels(self, mobs: List, wav_path: Path, header: Dict, edit_rate: int):
+        channels, sample_width = header['channels'], header['sample_width']
+        tmp_paths = []
+        writers = []
+        try:
+            for idx in range(1, channels + 1):
+                tmp = tempfile.NamedTemporaryFile(prefix=f"{wav_path.stem}_ch{idx}_", suffix='.wav', delete=False)
+                tmp.close()
+                tmp_paths.append(tmp.name)
+                w = wave.open(tmp.name, 'wb')
+                w.setnchannels(1)
+                w.setsampwidth(sample_width)
+                w.setframerate(header['sample_rate'])
+                w.setnframes(header['frames'])
+                writers.append(w)
+            for block in self._blocks(wav_path, header):
+                for w, data in zip(writers, self._split_block(block, channels, sample_width)):
+                    w.writeframesraw(data)
+            for w in writers:
+                w.close()
+            writers = []
+            for mob, tmp_path in zip(mobs, tmp_paths):
+                mob.import_audio_essence(tmp_path, edit_rate=edit_rate)
+                self._count(bytes=header['frames'] * sample_width)
+        finally:
+            for w in writers:
+                try:
+                    w.close()
+                except Exception:
+                    pass
+            for tmp_path in tmp_paths:
+                try:
+                    os.unlink(tmp_path)
+                except Exception:
+                    pass
+
+    def finalize(self, output_path: str):
+        """Apply the fsync policy to a finished output file"""
+        if self.fsync != 'close' or not output_path:
+            return
+        try:
+            fd = os.open(output_path, os.O_RDWR if os.name == 'nt' else os.O_RDONLY)
+            try:
+                os.fsync(fd)
+            finally:
+                os.close(fd)
+        except OSError as e:
+            logger.debug(f"fsync failed for {output_path}: {e}")
+
+
+class GrowingWavFollower:
+    """Follow a WAV that is still being recorded or copied and hand out its audio as it lands.
+
+    Recorders write the RIFF header with a placeholder data size (0 or 0xFFFFFFFF), append audio,
+    then patch the sizes and often append bext/iXML/LIST chunks when they close the file. blocks()
+    yields block_align-multiple pieces of the data chunk as soon as they are on disk, holding the
+    last `holdback` bytes back until the end is known so trailing metadata is never taken for audio.
+
+    The recording is finished ('closed') once the declared data and RIFF sizes are patched and fit
+    the file, and either chunks follow the audio or the size held for close_grace; or ('settled')
+    once the size hasn't changed for settle_seconds (writers that never patch the header). frames is
+    then the final length, and final_record() returns refresh(self) once: the caller's re-read of
+    header-derived metadata.
+    """
+
+    PLACEHOLDER_SIZES = (0, 0xFFFFFFFF)
+
+    def __init__(self, wav_path, settle_seconds: float = 5.0, poll_interval: float = 0.25,
+                 close_grace: float = 1.0, holdback: int = 256 * 1024,
+                 cancel_event: Optional[threading.Event] = None,
+                 refresh: Optional[Callable[['GrowingWavFollower'], Optional[Dict]]] = None):
+        self.path = Path(wav_path)
+        self.settle_seconds = max(0.0, float(settle_seconds))
+        self.poll_interval = max(0.01, float(poll_interval))
+        self.close_grace = min(self.settle_seconds, max(0.0, float(close_grace)))
+        self.holdback = max(0, int(holdback))
+        self.cancel_event = cancel_event
+        self.refresh = refresh
+        self.header: Optional[Dict] = None
+        self.finished = False
+        self.reason = ''
+        self.data_end: Optional[int] = None
+        self.frames = 0
+        self.finished_at: Optional[float] = None
+        self._last_size = -1
+        self._declared_end: Optional[int] = None
+        self._last_change = time.monotonic()
+        self._record = None
+        self._extractor = WAVMetadataExtractor()
+
+    def _cancelled(self) -> bool:
+        return bool(self.cancel_event and self.cancel_event.is_set())
+
+    def wait_for_header(self, timeout: Optional[float] = None) -> Optional[Dict]:
+        """Block until the fmt and data chunk headers are on disk; None if cancelled or timed out"""
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while not self._cancelled():
+            try:
+                header = self._extractor.read_riff_header(self.path)
+            except OSError:
+                header = {}
+            if header and header.get('data_offset') is not None and header.get('block_align'):
+                header['sample_width'] = header['block_align'] // max(1, header['channels'])
+                self.header = header
+                return header
+            if deadline is not None and time.monotonic() >= deadline:
+                return None
+            time.sleep(self.poll_interval)
+        return None
+
+    def _read_sizes(self, fh) -> Tuple[int, int]:
+        """(declared RIFF size, declared data size) as currently on disk"""
+        fh.seek(4)
+        riff_size = struct.unpack('<I', fh.read(4))[0]
+        fh.seek(self.header['data_offset'] - 4)
+        data_size = struct.unpack('<I', fh.read(4))[0]
+        return riff_size, data_size
+
+    def poll(self, fh) -> Optional[int]:
+        """Check the file once; returns the final data end offset when the recording has finished"""
+        if self.finished:
+            return self.data_end
+        size = os.fstat(fh.fileno()).st_size
+        now = time.monotonic()
+        steady = size == self._last_size
+        if not steady:
+            self._last_size, self._last_change = size, now
+        data_offset, block_align = self.header['data_offset'], self.header['block_align']
+        riff_size, data_size = self._read_sizes(fh)
+        # A copied (offloaded) file already carries its final sizes: audio is safe up to them
+        self._declared_end = None if data_size in self.PLACEHOLDER_SIZES else data_offset + data_size
+        end = None
+        patched = data_size not in self.PLACEHOLDER_SIZES and riff_size + 8 == size \
+            and data_offset + data_size <= size
+        # Chunks after the audio are written at close; otherwise the patched sizes must hold for
+        # close_grace, since some recorders rewrite them periodically while still recording
+        if patched and steady and (data_offset + data_size < size or now - self._last_change >= self.close_grace):
+            end, self.reason = data_offset + data_size, 'closed'
+        elif now - self._last_change >= self.settle_seconds and size > data_offset:
+            # Header never patched: everything after the data chunk header is audio
+            end = data_offset + (data_size if data_size not in self.PLACEHOLDER_SIZES
+                                 and data_offset + data_size <= size else size - data_offset)
+            self.reason = 'settled'
+        if end is not None:
+            self.frames = (end - data_offset) // block_align
+            self.data_end = data_offset + self.frames * block_align
+            self.finished = True
+            self.finished_at = now
+        return self.data_end
+
+    def blocks(self, block_size: int = ESSENCE_BLOCK_SIZE):
+        """Yield the data chunk in block_align-multiple blocks until the recording has finished.
+
+        Full blocks are the same bytearray each time, overwritten by the next read: consumers
+        that keep a block past the next iteration must copy it (bytes(block)).
+        """
+        if self.header is None and self.wait_for_header() is None:
+            raise Exception(f"No WAV header in {self.path}")
+        block_align = self.header['block_align']
+        block = max(block_align, block_size - block_size % block_align)
+        buf = bytearray(block)
+        view = memoryview(buf)
+        pos = self.header['data_offset']
+        with open(self.path, 'rb', buffering=0) as fh:
+            while True:
+                end = self.poll(fh)
+                if end is None:
+                    available = self._last_size - self.holdback
+                    if self._declared_end is not None:
+                        available = max(available, min(self._last_size, self._declared_end))
+                    available -= (available - pos) % block_align
+                else:
+                    available = end
+                while pos < available:
+                    fh.seek(pos)
+                    n = fh.readinto(view[:min(block, available - pos)])
+                    if not n:
+                        break
+                    n -= n % block_align
+                    if not n:
+                        break
+                    pos += n
+                    yield buf if n == block else bytearray(view[:n])
+                if end is not None and pos >= end:
+                    return
+                if self._cancelled():
+                    raise Exception(f"Cancelled while following {self.path.name}")
+                time.sleep(self.poll_interval)
+
+    def wait(self) -> int:
+        """Block until the recording has finished without reading audio; returns the final frames"""
+        if self.header is None and self.wait_for_header() is None:
+            raise Exception(f"No WAV header in {self.path}")
+        with open(self.path, 'rb', buffering=0) as fh:
+            while self.poll(fh) is None:
+                if self._cancelled():
+                    raise Exception(f"Cancelled while following {self.path.name}")
+                time.sleep(self.poll_interval)
+        return self.frames
+
+    def final_record(self) -> Optional[Dict]:
+        """The refresh callback's record for the finished file (computed once)"""
+        if self._record is None and self.refresh is not None:
+            self._record = self.refresh(self) or {}
+        return self._record
+
+
+class MobPrototypeCache:
+    """Build one mob chain per clip shape and hand out deep copies of it.
+
+    Multi-clip AAFs repeat the same graph (slots, clips, descriptors, pan operation groups) for every
+    clip of a given channel count / rate / mode. The first clip of a shape is built with build(length)
+    and kept as an unattached prototype; later clips get prototype.copy() and the caller patches UMIDs,
+    lengths, names, locators and comments (AAFGenerator._retarget_mob_chain). If pyaaf2 cannot copy
+    the objects, every clip falls back to build(length).
+    """
+
+    # Prototype clip length; any length > 1 works because every length-derived value is patched
+    PROTOTYPE_LENGTH = 2
+
+    def __init__(self, enabled: bool = True):
+        self.enabled = enabled
+        self.stats = {'built': 0, 'cloned': 0}
+        self._prototypes: Dict[Tuple, Tuple] = {}
+
+    def chain(self, shape: Tuple, length: int, build: Callable[[int], Tuple]) -> Tuple:
+        if self.enabled and length > 1:
+            prototype = self._prototypes.get(shape)
+            if prototype is None:
+                prototype = self._prototypes[shape] = build(self.PROTOTYPE_LENGTH)
+            try:
+                mobs = tuple(mob.copy() for mob in prototype)
+                self.stats['cloned'] += 1
+                return mobs
+            except Exception as e:
+                logger.warning(f"Mob prototype cloning unavailable, building clips directly: {e}")
+                self.enabled = False
+        self.stats['built'] += 1
+        return build(length)
+
+
+def default_memory_budget() -> int:
+    """Half of physical RAM (2 GB where that can't be read)"""
+    try:
+        return os.sysconf('SC_PHYS_PAGES') * os.sysconf('SC_PAGE_SIZE') // 2
+    except (AttributeError, ValueError, OSError):
+        return 2 * 1024 ** 3
+
+
+class MemoryGovernor:
+    """Admit per-file jobs while their estimated peak working sets fit in a memory budget.
+
+    estimate() prices a file from its RIFF header and the embed settings; acquire() blocks until
+    the cost fits next to the jobs already running. A file that alone exceeds the budget is
+    admitted only when nothing else runs, so oversize files are serialized rather than refused.
+    One governor can be shared by several processors (the GUI job queue does this).
+    """
+
+    # Neither constant has been measured against pyaaf2 yet; both are deliberately high guesses.
+    # Calibrate them from tracemalloc peaks of real embeds before lowering them.
+    # AAF object graph, parsed metadata and interpreter overhead per open AAF
+    BASE_BYTES = 48 * 1024 ** 2
+    # pyaaf2 keeps allocation-table entries (and per-stream sector chains) for every essence sector
+    FAT_BYTES_PER_SECTOR = 40
+
+    def __init__(self, budget_bytes: int):
+        self.budget = max(1, int(budget_bytes))
+        self.in_use = 0
+        self.running = 0
+        self.stats = {'admitted': 0, 'waited': 0, 'serialized': 0, 'peak_bytes': 0}
+        self._cond = threading.Condition()
+
+    def estimate(self, header: Dict, embed_audio: bool, block_size: int = ESSENCE_BLOCK_SIZE,
+                 sector_size: int = 512, interleaved: bool = False) -> int:
+        """Peak bytes for writing one AAF from a WAV with this header"""
+        if not embed_audio or not header:
+            return self.BASE_BYTES
+        channels = max(1, int(header.get('channels') or 1))
+        # Read buffer, plus its de-interleaved copy when channels become separate mobs
+        buffers = block_size * (1 if interleaved or channels == 1 else 2)
+        sectors = int(header.get('data_size') or 0) // max(1, sector_size)
+        return self.BASE_BYTES + buffers + sectors * self.FAT_BYTES_PER_SECTOR
+
+    def acquire(self, cost: int) -> int:
+        with self._cond:
+            if self.running and self.in_use + cost > self.budget:
+                self.stats['waited'] += 1
+                while self.running and self.in_use + cost > self.budget:
+                    self._cond.wait()
+            if cost > self.budget:
+                self.stats['serialized'] += 1
+            self.in_use += cost
+            self.running += 1
+            self.stats['admitted'] += 1
+            self.stats['peak_bytes'] = max(self.stats['peak_bytes'], self.in_use)
+        return cost
+
+    def release(self, cost: int):
+        with self._cond:
+            self.in_use -= cost
+            self.running -= 1
+            self._cond.notify_all()
+
+
+# --- OP-Atom MXF (SMPTE 377M file format, 390M OP-Atom, 382M BWF mapping) -----------------
+
+def _ul(text: str) -> bytes:
+    return bytes.fromhex(text.replace('.', ''))
+
+
+MXF_PARTITION_KEY = _ul('06.0e.2b.34.02.05.01.01.0d.01.02.01.01.00.00.00')  # byte 13 kind, byte 14 status
+MXF_PRIMER_KEY = _ul('06.0e.2b.34.02.05.01.01.0d.01.02.01.01.05.01.00')
+MXF_RIP_KEY = _ul('06.0e.2b.34.02.05.01.01.0d.01.02.01.01.11.01.00')
+MXF_INDEX_KEY = _ul('06.0e.2b.34.02.53.01.01.0d.01.02.01.01.10.01.00')
+MXF_OP_ATOM = _ul('06.0e.2b.34.04.01.01.02.0d.01.02.01.10.00.00.00')
+MXF_BWF_CLIP_WRAPPED = _ul('06.0e.2b.34.04.01.01.01.0d.01.03.01.02.06.02.00')
+MXF_BWF_CLIP_ELEMENT = _ul('06.0e.2b.34.01.02.01.01.0d.01.03.01.16.01.02.01')
+MXF_SOUND_DATADEF = _ul('06.0e.2b.34.04.01.01.01.01.03.02.02.02.00.00.00')
+MXF_PARTITION_HEADER, MXF_PARTITION_BODY, MXF_PARTITION_FOOTER = 0x02, 0x03, 0x04
+MXF_CLOSED_COMPLETE = 0x04
+# Header metadata set keys differ only in byte 13
+MXF_SETS = {'preface': 0x2f, 'identification': 0x30, 'content_storage': 0x18, 'essence_data': 0x23,
+            'material_package': 0x36, 'source_package': 0x37, 'track': 0x3b, 'sequence': 0x0f,
+            'source_clip': 0x11, 'wave_descriptor': 0x48}
+
+# Local tag → property UL, written to the primer pack of every file
+MXF_LOCAL_TAGS = {
+    0x3C0A: '06.0e.2b.34.01.01.01.01.01.01.15.02.00.00.00.00',  # InstanceUID
+    0x3B02: '06.0e.2b.34.01.01.01.02.07.02.01.10.02.04.00.00',  # Preface LastModifiedDate
+    0x3B05: '06.0e.2b.34.01.01.01.02.03.01.02.01.05.00.00.00',  # Version
+    0x3B06: '06.0e.2b.34.01.01.01.02.06.01.01.04.06.04.00.00',  # Identifications
+    0x3B03: '06.0e.2b.34.01.01.01.02.06.01.01.04.02.01.00.00',  # ContentStorage
+    0x3B09: '06.0e.2b.34.01.01.01.05.01.02.02.03.00.00.00.00',  # OperationalPattern
+    0x3B0A: '06.0e.2b.34.01.01.01.05.01.02.02.10.02.01.00.00',  # EssenceContainers
+    0x3B0B: '06.0e.2b.34.01.01.01.05.01.02.02.10.02.02.00.00',  # DMSchemes
+    0x3C09: '06.0e.2b.34.01.01.01.02.05.20.07.01.01.00.00.00',  # ThisGenerationUID
+    0x3C01: '06.0e.2b.34.01.01.01.02.05.20.07.01.02.01.00.00',  # CompanyName
+    0x3C02: '06.0e.2b.34.01.01.01.02.05.20.07.01.03.01.00.00',  # ProductName
+    0x3C04: '06.0e.2b.34.01.01.01.02.05.20.07.01.05.01.00.00',  # VersionString
+    0x3C05: '06.0e.2b.34.01.01.01.02.05.20.07.01.07.00.00.00',  # ProductUID
+    0x3C06: '06.0e.2b.34.01.01.01.02.07.02.01.10.02.03.00.00',  # ModificationDate
+    0x1901: '06.0e.2b.34.01.01.01.02.06.01.01.04.05.01.00.00',  # Packages
+    0x1902: '06.0e.2b.34.01.01.01.02.06.01.01.04.05.02.00.00',  # EssenceContainerData
+    0x2701: '06.0e.2b.34.01.01.01.02.06.01.01.06.01.00.00.00',  # LinkedPackageUID
+    0x3F06: '06.0e.2b.34.01.01.01.04.01.03.04.05.00.00.00.00',  # IndexSID
+    0x3F07: '06.0e.2b.34.01.01.01.04.01.03.04.04.00.00.00.00',  # BodySID
+    0x4401: '06.0e.2b.34.01.01.01.01.01.01.15.10.00.00.00.00',  # PackageUID
+    0x4402: '06.0e.2b.34.01.01.01.01.01.03.03.02.01.00.00.00',  # Name
+    0x4405: '06.0e.2b.34.01.01.01.02.07.02.01.10.01.03.00.00',  # PackageCreationDate
+    0x4404: '06.0e.2b.34.01.01.01.02.07.02.01.10.02.05.00.00',  # PackageModifiedDate
+    0x4403: '06.0e.2b.34.01.01.01.02.06.01.01.04.06.05.00.00',  # Tracks
+    0x4701: '06.0e.2b.34.01.01.01.02.06.01.01.04.02.03.00.00',  # Descriptor
+    0x4801: '06.0e.2b.34.01.01.01.02.01.07.01.01.00.00.00.00',  # TrackID
+    0x4804: '06.0e.2b.34.01.01.01.02.01.04.01.03.00.00.00.00',  # TrackNumber
+    0x4B01: '06.0e.2b.34.01.01.01.02.05.30.04.05.00.00.00.00',  # EditRate
+    0x4B02: '06.0e.2b.34.01.01.01.02.07.02.01.03.01.03.00.00',  # Origin
+    0x4803: '06.0e.2b.34.01.01.01.02.06.01.01.04.02.04.00.00',  # Sequence
+    0x0201: '06.0e.2b.34.01.01.01.02.04.07.01.00.00.00.00.00',  # DataDefinition
+    0x0202: '06.0e.2b.34.01.01.01.02.07.02.02.01.01.00.00.00',  # Duration
+    0x1001: '06.0e.2b.34.01.01.01.02.06.01.01.04.06.09.00.00',  # StructuralComponents
+    0x1201: '06.0e.2b.34.01.01.01.02.07.02.01.03.01.04.00.00',  # StartPosition
+    0x1101: '06.0e.2b.34.01.01.01.02.06.01.01.03.01.00.00.00',  # SourcePackageID
+    0x1102: '06.0e.2b.34.01.01.01.02.06.01.01.03.02.00.00.00',  # SourceTrackID
+    0x3006: '06.0e.2b.34.01.01.01.05.06.01.01.03.05.00.00.00',  # LinkedTrackID
+    0x3001: '06.0e.2b.34.01.01.01.01.04.06.01.01.00.00.00.00',  # SampleRate
+    0x3002: '06.0e.2b.34.01.01.01.01.04.06.01.02.00.00.00.00',  # ContainerDuration
+    0x3004: '06.0e.2b.34.01.01.01.02.06.01.01.04.01.02.00.00',  # EssenceContainer
+    0x3D03: '06.0e.2b.34.01.01.01.05.04.02.03.01.01.01.00.00',  # AudioSamplingRate
+    0x3D02: '06.0e.2b.34.01.01.01.04.04.02.03.01.04.00.00.00',  # Locked
+    0x3D07: '06.0e.2b.34.01.01.01.05.04.02.01.01.04.00.00.00',  # ChannelCount
+    0x3D01: '06.0e.2b.34.01.01.01.04.04.02.03.03.04.00.00.00',  # QuantizationBits
+    0x3D0A: '06.0e.2b.34.01.01.01.05.04.02.03.02.01.00.00.00',  # BlockAlign
+    0x3D09: '06.0e.2b.34.01.01.01.05.04.02.03.03.05.00.00.00',  # AvgBytesPerSecond
+    0x3F0B: '06.0e.2b.34.01.01.01.05.05.30.04.06.00.00.00.00',  # IndexEditRate
+    0x3F0C: '06.0e.2b.34.01.01.01.05.07.02.01.03.01.0a.00.00',  # IndexStartPosition
+    0x3F0D: '06.0e.2b.34.01.01.01.05.07.02.02.01.01.02.00.00',  # IndexDuration
+    0x3F05: '06.0e.2b.34.01.01.01.04.04.06.02.01.00.00.00.00',  # EditUnitByteCount
+}
+
+
+def _ber(length: int) -> bytes:
+    # Fixed-width BER lengths keep every KLV header a predictable size
+    if length < 1 << 24:
+        return b'\x83' + length.to_bytes(3, 'big')
+    return b'\x88' + length.to_bytes(8, 'big')
+
+
+def _klv(key: bytes, value: bytes) -> bytes:
+    return key + _ber(len(value)) + value
+
+
+def _mxf_batch(items: List[bytes], item_size: int) -> bytes:
+    return struct.pack('>II', len(items), item_size) + b''.join(items)
+
+
+def _mxf_local_set(key: bytes, items: List[Tuple[int, bytes]]) -> bytes:
+    return _klv(key, b''.join(struct.pack('>HH', tag, len(value)) + value for tag, value in items))
+
+
+def _mxf_timestamp(when: datetime) -> bytes:
+    return struct.pack('>HBBBBBB', when.year, when.month, when.day, when.hour, when.minute, when.second,
+                       when.microsecond // 4000)
+
+
+class OPAtomWriter(EssenceWriter):
+    """Write each channel of a WAV as an Avid-style OP-Atom MXF file (clip-wrapped BWF PCM).
+
+    Every file holds a header partition (material package + file source package + WAVE
+    descriptor), a body partition with the channel's samples in one essence element and a
+    footer partition with a constant-rate index table, followed by a random index pack. The
+    data chunk is read once in block_size blocks and de-interleaved into all channel files, so
+    nothing larger than one block is held in memory. Sizes are known from the WAV header, so
+    every partition is written closed and complete in a single pass.
+    """
+
+    PARTITION_PACK_BYTES = 16 + 4 + 104
+    ESSENCE_KL_BYTES = 16 + 9
+    BODY_SID, INDEX_SID = 1, 2
+
+    def write_files(self, wav_path: Path, media_dir: Path, name: str, material_umid: bytes,
+                    file_umids: List[bytes]) -> List[Dict]:
+        """Write one MXF per channel into media_dir; returns [{'path', 'file_umid', 'frames'}] per channel"""
+        start = time.perf_counter()
+        header = self._source(wav_path)
+        channels, width, frames = header['channels'], header['sample_width'], header['frames']
+        if len(file_umids) != channels:
+            raise ValueError(f"need {channels} file package UMIDs, got {len(file_umids)}")
+        media_dir.mkdir(parents=True, exist_ok=True)
+        safe_name = re.sub(r'[^A-Za-z0-9._-]+', '_', name)[:48] or 'clip'
+        now = datetime.now()
+        results, handles = [], []
+        try:
+            for ch, file_umid in enumerate(file_umids):
+                path = media_dir / f"{safe_name}.A{ch + 1:02d}.{file_umid[-4:].hex()}.mxf"
+                fh = open(path, 'wb')
+                handles.append(fh)
+                metadata = self._header_metadata(header, ch, name, material_umid, file_umid, now)
+                fh.write(self._file_prefix(header, metadata))
+                results.append({'path': path, 'file_umid': file_umid, 'frames': frames,
+                                'header_bytes': len(metadata)})
+            for block in self._blocks(wav_path, header):
+                parts = [block] if channels == 1 else self._split_block(block, channels, width)
+                for fh, part in zip(handles, parts):
+                    self._write(fh, part)
+            for ch, fh in enumerate(handles):
+                fh.write(self._file_suffix(header, results[ch]['header_bytes'], file_umids[ch]))
+                if self.fsync == 'close':
+                    fh.flush()
+                    os.fsync(fh.fileno())
+        finally:
+            for fh in handles:
+                fh.close()
+            self._count(seconds=time.perf_counter() - start)
+        return results
+
+    # --- layout -------------------------------------------------------------------------
+    def _offsets(self, header: Dict, header_bytes: int) -> Dict[str, int]:
+        body = self.PARTITION_PACK_BYTES + header_bytes
+        footer = body + self.PARTITION_PACK_BYTES + self.ESSENCE_KL_BYTES + header['frames'] * header['sample_width']
+        return {'body': body, 'footer': footer}
+
+    def _partition(self, kind: int, this: int, previous: int, footer: int, header_bytes: int = 0,
+                   index_bytes: int = 0, index_sid: int = 0, body_sid: int = 0) -> bytes:
+        key = bytearray(MXF_PARTITION_KEY)
+        key[13], key[14] = kind, MXF_CLOSED_COMPLETE
+        value = struct.pack('>HHIQQQQQIQI', 1, 3, 1, this, previous, footer, header_bytes, index_bytes,
+                            index_sid, 0, body_sid)
+        value += MXF_OP_ATOM + _mxf_batch([MXF_BWF_CLIP_WRAPPED], 16)
+        return _klv(bytes(key), value)
+
+    def _file_prefix(self, header: Dict, metadata: bytes) -> bytes:
+        """Header partition + metadata, body partition pack and the essence element's key/length"""
+        offsets = self._offsets(header, len(metadata))
+        essence_bytes = header['frames'] * header['sample_width']
+        return (self._partition(MXF_PARTITION_HEADER, 0, 0, offsets['footer'], header_bytes=len(metadata))
+                + metadata
+                + self._partition(MXF_PARTITION_BODY, offsets['body'], 0, offsets['footer'], body_sid=self.BODY_SID)
+                + MXF_BWF_CLIP_ELEMENT + b'\x88' + essence_bytes.to_bytes(8, 'big'))
+
+    def _file_suffix(self, header: Dict, header_bytes: int, file_umid: bytes) -> bytes:
+        """Footer partition with the index table segment, then the random index pack"""
+        offsets = self._offsets(header, header_bytes)
+        uid = self._instance_uid(file_umid, 0xff)
+        index = _mxf_local_set(MXF_INDEX_KEY, [
+            (0x3C0A, uid),
+            (0x3F0B, struct.pack('>ii', header['sample_rate'], 1)),
+            (0x3F0C, struct.pack('>q', 0)),
+            (0x3F0D, struct.pack('>q', header['frames'])),
+            (0x3F05, struct.pack('>I', header['sample_width'])),
+            (0x3F06, struct.pack('>I', self.INDEX_SID)),
+            (0x3F07, struct.pack('>I', self.BODY_SID)),
+        ])
+        footer = self._partition(MXF_PARTITION_FOOTER, offsets['footer'], offsets['body'], offsets['footer'],
+                                 index_bytes=len(index), index_sid=self.INDEX_SID)
+        entries = [(0, 0), (self.BODY_SID, offsets['body']), (0, offsets['footer'])]
+        rip_value = b''.join(struct.pack('>IQ', sid, offset) for sid, offset in entries)
+        rip_length = 16 + 4 + len(rip_value) + 4
+        return footer + index + _klv(MXF_RIP_KEY, rip_value + struct.pack('>I', rip_length))
+
+    @staticmethod
+    def _instance_uid(file_umid: bytes, n: int) -> bytes:
+        # Deterministic per file, so rewriting the same WAV yields identical MXF bytes
+        return hashlib.sha1(file_umid + bytes([n])).digest()[:16]
+
+    def _header_metadata(self, header: Dict, ch: int, name: str, material_umid: bytes, file_umid: bytes,
+                         now: datetime) -> bytes:
+        """Primer pack and header metadata sets for one channel file"""
+        rate, width, frames = header['sample_rate'], header['sample_width'], header['frames']
+        uid = lambda n: self._instance_uid(file_umid, n)
+        stamp = _mxf_timestamp(now)
+        edit_rate = struct.pack('>ii', rate, 1)
+        set_key = lambda kind: _ul(f"06.0e.2b.34.02.53.01.01.0d.01.01.01.01.01.{MXF_SETS[kind]:02x}.00")
+        (preface, ident, storage, ecd, mp, mp_track, mp_seq, mp_clip,
+         fp, fp_track, fp_seq, fp_clip, descriptor) = (uid(n) for n in range(1, 14))
+
+        def track(instance, track_id, number, sequence):
+            return _mxf_local_set(set_key('track'), [
+                (0x3C0A, instance), (0x4801, struct.pack('>I', track_id)), (0x4804, struct.pack('>I', number)),
+                (0x4B01, edit_rate), (0x4B02, struct.pack('>q', 0)), (0x4803, sequence)])
+
+        def sequence(instance, clip):
+            return _mxf_local_set(set_key('sequence'), [
+                (0x3C0A, instance), (0x0201, MXF_SOUND_DATADEF), (0x0202, struct.pack('>q', frames)),
+                (0x1001, _mxf_batch([clip], 16))])
+
+        def source_clip(instance, package, track_id):
+            return _mxf_local_set(set_key('source_clip'), [
+                (0x3C0A, instance), (0x0201, MXF_SOUND_DATADEF), (0x0202, struct.pack('>q', frames)),
+                (0x1201, struct.pack('>q', 0)), (0x1101, package), (0x1102, struct.pack('>I', track_id))])
+
+        label = f"{name} A{ch + 1}".encode('utf-16-be')
+        element_number = int.from_bytes(MXF_BWF_CLIP_ELEMENT[12:16], 'big')
+        sets = [
+            _mxf_local_set(set_key('preface'), [
+                (0x3C0A, preface), (0x3B02, stamp), (0x3B05, struct.pack('>H', 0x0102)),
+                (0x3B06, _mxf_batch([ident], 16)), (0x3B03, storage), (0x3B09, MXF_OP_ATOM),
+                (0x3B0A, _mxf_batch([MXF_BWF_CLIP_WRAPPED], 16)), (0x3B0B, _mxf_batch([], 16))]),
+            _mxf_local_set(set_key('identification'), [
+                (0x3C0A, ident), (0x3C09, uid(0xf0)), (0x3C01, "WAVsToAAF".encode('utf-16-be')),
+                (0x3C02, "WAVsToAAF".encode('utf-16-be')), (0x3C04, __version__.encode('utf-16-be')),
+                (0x3C05, hashlib.sha1(b'WAVsToAAF').digest()[:16]), (0x3C06, stamp)]),
+            _mxf_local_set(set_key('content_storage'), [
+                (0x3C0A, storage), (0x1901, _mxf_batch([mp, fp], 16)), (0x1902, _mxf_batch([ecd], 16))]),
+            _mxf_local_set(set_key('essence_data'), [
+                (0x3C0A, ecd), (0x2701, file_umid), (0x3F06, struct.pack('>I', self.INDEX_SID)),
+                (0x3F07, struct.pack('>I', self.BODY_SID))]),
+            _mxf_local_set(set_key('material_package'), [
+                (0x3C0A, mp), (0x4401, material_umid), (0x4402, name.encode('utf-16-be')), (0x4405, stamp),
+                (0x4404, stamp), (0x4403, _mxf_batch([mp_track], 16))]),
+            track(mp_track, ch + 1, 0, mp_seq),
+            sequence(mp_seq, mp_clip),
+            source_clip(mp_clip, file_umid, 1),
+            _mxf_local_set(set_key('source_package'), [
+                (0x3C0A, fp), (0x4401, file_umid), (0x4402, label), (0x4405, stamp), (0x4404, stamp),
+                (0x4403, _mxf_batch([fp_track], 16)), (0x4701, descriptor)]),
+            track(fp_track, 1, element_number, fp_seq),
+            sequence(fp_seq, fp_clip),
+            source_clip(fp_clip, bytes(32), 0),
+            _mxf_local_set(set_key('wave_descriptor'), [
+                (0x3C0A, descriptor), (0x3006, struct.pack('>I', 1)), (0x3001, edit_rate),
+                (0x3002, struct.pack('>q', frames)), (0x3004, MXF_BWF_CLIP_WRAPPED), (0x3D03, edit_rate),
+                (0x3D02, b'\x00'), (0x3D07, struct.pack('>I', 1)), (0x3D01, struct.pack('>I', width * 8)),
+                (0x3D0A, struct.pack('>H', width)), (0x3D09, struct.pack('>I', rate * width))]),
+        ]
+        primer = _klv(MXF_PRIMER_KEY, _mxf_batch(
+            [struct.pack('>H', tag) + _ul(ul) for tag, ul in MXF_LOCAL_TAGS.items()], 18))
+        return primer + b''.join(sets)
+
+
 class AAFGenerator:
     """Generate AAF files from WAV metadata using pyaaf2"""
     
     def __init__(self):
         self.app_name = f"WAVsToAAF v{__version__}"
+        # Block size / preallocation / fsync policy for embedded essence (see EssenceWriter)
+        self.essence_writer = EssenceWriter()
+        # Embed multi-channel WAVs as one interleaved SourceMob instead of one SourceMob per channel
+        self.interleaved_embed = False
+        # Whether this pyaaf2 has SourceClip ChannelIDs; probed once, with the first interleaved file
+        self._channel_ids_support: Optional[bool] = None
+        # Clone per-shape prototype mob chains in multi-clip AAFs (see MobPrototypeCache); opt-in
+        # until tests/test_mob_prototypes.py passes against pyaaf2 and the speedup is measured
+        self.mob_prototypes = False
+        # Compound-file sector size: 512 or 4096, or None for pyaaf2's default
+        self.sector_size: Optional[int] = None
+        self._sector_size_warned = False
+        # Locator policy for linked media: OLD→NEW path-prefix remaps and which URL variants to write
+        self.locator_remaps: List[Tuple[str, str]] = []
+        self.locator_set = 'all'
+        # link_mode 'mxf': OP-Atom MXF folder (default: 'Avid MediaFiles/MXF/1' next to the AAF)
+        self.mxf_media_dir: Optional[str] = None
+        # Multi-clip tape-mode AAFs: one TapeDescriptor SourceMob per tape name, shared by its clips
+        self.shared_tapes = False
     
+    def _open_aaf_for_write(self, output_path: str):
+        """aaf2.open(output_path, 'w'), with sector_size passed only when --sector-size was given"""
+        if self.sector_size is None:
+            return aaf2.open(output_path, 'w')
+        if aaf_open_sector_size_default() is None:
+            if not self._sector_size_warned:
+                print(f"Warning: this pyaaf2 has no sector_size option; --sector-size {self.sector_size} ignored")
+                self._sector_size_warned = True
+            return aaf2.open(output_path, 'w')
+        return aaf2.open(output_path, 'w', sector_size=self.sector_size)
+
+    def _locator_urls(self, wav_path: Path, relative: bool = False, avid_volume_url: bool = True) -> List[str]:
+        return build_locator_urls(wav_path, relative=relative, remaps=self.locator_remaps,
+                                  locator_set=self.locator_set, avid_volume_url=avid_volume_url)
+
+    def _write_op_atom_media(self, source_path: Path, wav_path: Path, output_path: str) -> List[Dict]:
+        """Write the per-channel OP-Atom MXF files for one WAV (link_mode 'mxf')"""
+        media_dir = Path(self.mxf_media_dir) if self.mxf_media_dir else \
+            Path(output_path).parent / 'Avid MediaFiles' / 'MXF' / '1'
+        writer = OPAtomWriter(block_size=self.essence_writer.block_size, fsync=self.essence_writer.fsync)
+        channels = int(writer._source(source_path)['channels'])
+        file_umids = [deterministic_umid_bytes(wav_path, f"mxf{ch}") for ch in range(1, channels + 1)]
+        files = writer.write_files(source_path, media_dir, wav_path.stem,
+                                   deterministic_umid_bytes(wav_path, "master"), file_umids)
+        self.essence_writer._count(**{key: writer.stats[key] for key in ('bytes', 'writes', 'seconds')})
+        return files
+
     def create_aaf_file(self, wav_metadata: Dict, bext_metadata: Dict, info_metadata: Dict = None, 
                        xml_metadata: Dict = None, ucs_metadata: Dict = None, output_path: str = None,
                        fps: float = 24, embed_audio: bool = False, link_mode: str = 'import', 
-                       relative_locators: bool = False) -> str:
-        """Create AAF file from WAV, BEXT, INFO, XML, and UCS metadata using Avid-compatible structure"""
+                       relative_locators: bool = False, growing: Optional[GrowingWavFollower] = None) -> str:
+        """Create AAF file from WAV, BEXT, INFO, XML, and UCS metadata using Avid-compatible structure
+
+        growing follows a WAV that is still being written (embedded, link_mode 'import'): its essence
+        is streamed as it grows, and lengths plus metadata come from growing.final_record() once the
+        recording has finished.
+        """
         
         try:
             # Get audio parameters - ensure they're integers
@@ -982,7 +2711,7 @@ class AAFGenerator:
             duration_seconds = audio_frames / sample_rate if sample_rate else 0
             video_length = int(duration_seconds * fps)
             
-            with aaf2.open(output_path, 'w') as f:
+            with self._open_aaf_for_write(output_path) as f:
                 # Set file identification
                 f.header['ObjectModelVersion'].value = 1
                 f.header['Version'].value = {'major': 1, 'minor': 2}
@@ -996,27 +2725,38 @@ class AAFGenerator:
                 
                 # Choose linked structure
                 # 'pcm' -> MC-exact file essence via PCMDescriptor (earlier variant that may avoid 1-by-1 prompts)
+                # 'mxf' -> same structure, pointing at per-channel OP-Atom MXF files written alongside
                 # 'import' -> ImportDescriptor 3-tier structure (current default)
-                use_mc_exact_linked = (str(link_mode).lower() == 'pcm')
+                link_mode = str(link_mode).lower()
+                use_mc_exact_linked = link_mode in ('pcm', 'mxf')
+                interleave_essence = False
 
                 # Resolve path to WAV
                 import_mob = f.create.SourceMob()
                 from pathlib import Path
                 wav_path = Path(wav_metadata.get('filepath', ''))
-                wav_source_path = Path(wav_metadata.get('converted_filepath', str(wav_path)))
+                # Audio is read from a converted copy, an archive member in place, or the WAV itself
+                wav_source_path = wav_metadata.get('archive_member') or \
+                    Path(wav_metadata.get('converted_filepath', str(wav_path)))
                 if use_mc_exact_linked and wav_path.exists():
                     # Build one SourceMob per channel, with PCMDescriptor and file locators
                     source_mobs = []
-                    abs_path = str(wav_path)
-                    
-                    # Only create URIs if not using relative locators
-                    if not relative_locators:
-                        file_uri = wav_path.as_uri()
-                        file_url_localhost = f"file://localhost{wav_path.as_posix()}"
+
+                    # Same locator list for every channel (relative, or remapped per the locator policy)
+                    locator_urls = self._locator_urls(wav_path, relative_locators, avid_volume_url=False)
+                    mxf_files = []
+                    if link_mode == 'mxf':
+                        mxf_files = self._write_op_atom_media(wav_source_path, wav_path, output_path)
+                        channels = len(mxf_files)
 
                     for ch_idx in range(channels):
                         source_mob = f.create.SourceMob()
                         source_mob.name = None  # MC leaves SourceMob names as None
+                        if mxf_files:
+                            # File SourceMob UMID must equal the MXF file package UID for relinking
+                            source_mob.mob_id = aaf2.mobid.MobID(umid_urn(mxf_files[ch_idx]['file_umid']))
+                            locator_urls = self._locator_urls(mxf_files[ch_idx]['path'], relative_locators,
+                                                              avid_volume_url=False)
 
                         pcm = f.create.PCMDescriptor()
                         pcm['SampleRate'].value = sample_rate
@@ -1026,7 +2766,14 @@ class AAFGenerator:
                         pcm['QuantizationBits'].value = bit_depth
                         pcm['BlockAlign'].value = sample_width
                         pcm['AverageBPS'].value = sample_rate * sample_width
-                        pcm['ContainerFormat'].value = f.dictionary.lookup_containerdef('AAF')
+                        container = 'AAF'
+                        if mxf_files:
+                            try:
+                                f.dictionary.lookup_containerdef('MXF')
+                                container = 'MXF'
+                            except Exception as e:
+                                logger.debug(f"MXF container definition not found: {e}")
+                        pcm['ContainerFormat'].value = f.dictionary.lookup_containerdef(container)
                         try:
                             codec = f.dictionary.lookup_codecdef('PCM')
                             pcm['CodecDefinition'].value = codec
@@ -1034,14 +2781,8 @@ class AAFGenerator:
                             logger.debug(f"PCM codec definition not found: {e}")
 
                         # Add locators - use relative if requested
-                        if relative_locators:
-                            relative_path = f"./{wav_path.name}"
-                            loc = f.create.NetworkLocator(); loc['URLString'].value = relative_path; pcm['Locator'].append(loc)
-                        else:
-                            loc1 = f.create.NetworkLocator(); loc1['URLString'].value = file_uri; pcm['Locator'].append(loc1)
-                            loc2 = f.create.NetworkLocator(); loc2['URLString'].value = file_url_localhost; pcm['Locator'].append(loc2)
-                            loc3 = f.create.NetworkLocator(); loc3['URLString'].value = abs_path; pcm['Locator'].append(loc3)
-                            loc4 = f.create.NetworkLocator(); loc4['URLString'].value = wav_path.name; pcm['Locator'].append(loc4)
+                        for url in locator_urls:
+                            loc = f.create.NetworkLocator(); loc['URLString'].value = url; pcm['Locator'].append(loc)
 
                         source_mob.descriptor = pcm
 
@@ -1061,6 +2802,9 @@ class AAFGenerator:
 
                     # Create MasterMob and wire channels
                     master_mob = f.create.MasterMob(str(wav_path.stem))
+                    if mxf_files:
+                        # Same UMID as the MXF material packages
+                        master_mob.mob_id = create_deterministic_umid(wav_path, "master")
                     for ch_idx, (source_mob, src_slot) in enumerate(source_mobs, start=1):
                         mslot = master_mob.create_timeline_slot(sample_rate)
                         mslot.name = wav_metadata.get('filename', 'Unknown')
@@ -1163,7 +2907,10 @@ class AAFGenerator:
                     master_mob.comments['Tape'] = tape_name
                     master_mob.comments['Scene'] = ""
                     master_mob.comments['Take'] = ""
+                    if wav_metadata.get('sync_group'):
+                        master_mob.comments['SyncGroup'] = wav_metadata['sync_group']
 
+                    self._append_region_subclips(f, master_mob, wav_metadata, sample_rate, audio_frames)
                     return output_path
                 else:
                     # === 1. Create ImportDescriptor SourceMob ===
@@ -1175,26 +2922,13 @@ class AAFGenerator:
                     # Create ImportDescriptor and add multiple locators
                     import_desc = f.create.ImportDescriptor()
                     if wav_path.exists():
+                        # Relative paths follow the AAF Edit Protocol spec (base URI = the AAF's location).
+                        # Otherwise the locator policy decides: by default every URL variant MC can resolve
+                        # with a single folder choice, Avid volume URL first to help MC UI prefill.
+                        # Avoid TextLocator to prevent "Error with media reference" warnings.
+                        locs_to_add = self._locator_urls(wav_path, relative_locators)
                         if relative_locators:
-                            # Use relative paths according to AAF Edit Protocol spec
-                            # Base URI is determined from the AAF file location
-                            relative_path = f"./{wav_path.name}"  # "./filename.wav"
-                            locs_to_add = [relative_path]
-                            print(f"  Using relative locator: {relative_path}")
-                        else:
-                            # Provide multiple URL variants that MC can resolve with a single folder choice.
-                            # Avoid TextLocator to prevent "Error with media reference" warnings.
-                            from urllib.parse import quote
-                            abs_posix = wav_path.as_posix()
-                            # Avid-style volume-prefixed URL tends to show best in UI
-                            avid_locator_url = f"file:///Macintosh%20HD{quote(abs_posix)}"
-                            file_url_users = f"file://{quote(abs_posix)}"            # file:///Users/...
-                            file_url_localhost = f"file://localhost{quote(abs_posix)}"  # file://localhost/Users/...
-                            abs_path = abs_posix                                      # /Users/...
-                            filename_only = wav_path.name                              # bare filename
-
-                            # Order: Avid volume URL first to help MC UI prefill; then common variants
-                            locs_to_add = [avid_locator_url, file_url_users, file_url_localhost, abs_path, filename_only]
+                            print(f"  Using relative locator: {locs_to_add[0]}")
 
                         for url in locs_to_add:
                             try:
@@ -1262,98 +2996,43 @@ class AAFGenerator:
                     channel_mobs = []
 
                     if embed_audio:
+                        # Master slots pick their channel of interleaved essence by ChannelIDs; without
+                        # it every slot would play channel 1, so embed per channel instead
+                        interleave_essence = channels > 1 and self.interleaved_embed and \
+                            self._channel_ids_supported(f)
                         # If user asked for per-channel embedding (default when multi-channel),
                         # create one SourceMob per channel and import each mono channel separately.
                         # Multi-channel WAVs will be split into per-channel mono files and each channel embedded separately.
-                        if channels > 1:
-                            # Split channels into temp mono files and import each into its own SourceMob
-                            import tempfile, os, wave as _wave
-                            tmp_paths = []
-                            try:
-                                with _wave.open(str(wav_source_path), 'rb') as r:
-                                    nch = r.getnchannels()
-                                    sampwidth = r.getsampwidth()
-                                    fr = r.getframerate()
-                                    nframes = r.getnframes()
-                                    raw = r.readframes(nframes)
-                                # reveal low-level values for problematic files (only in debug runs)
-
-                                # build per-channel byte streams
-                                bytes_per_frame = sampwidth * nch
-                                channels_data = [bytearray() for _ in range(nch)]
-                                for i in range(nframes):
-                                    off = i * bytes_per_frame
-                                    for c in range(nch):
-                                        start = off + c * sampwidth
-                                        channels_data[c].extend(raw[start:start+sampwidth])
-
-                                # write temp mono files and import into per-channel SourceMobs
-                                # report per-channel data lengths before writing (for debugging)
-                                for idx, chdata in enumerate(channels_data, start=1):
-                                    tmp = tempfile.NamedTemporaryFile(prefix=f"{wav_metadata.get('filename','tmp')}_ch{idx}_", suffix='.wav', delete=False)
-                                    tmp_paths.append(tmp.name)
-                                    tmp.close()
-                                    try:
-                                        with _wave.open(tmp.name,'wb') as w:
-                                            w.setnchannels(1)
-                                            w.setsampwidth(sampwidth)
-                                            w.setframerate(fr)
-                                            w.writeframes(bytes(chdata))
-                                    except Exception as write_exc:
-                                        # Failed to write temp WAV - surface the error
-                                        print(f"  Failed to write temp WAV {tmp.name}: {write_exc}")
-                                        # re-raise so the import step will fail and be reported
-                                        raise
-
-                                    # create a SourceMob and import the channel essence
-                                    phys_mob = f.create.SourceMob(f"{wav_metadata.get('filename','Unknown')}.PHYS.ch{idx}")
-                                    # Validate temp wav before passing to import_audio_essence to help diagnose EOF issues
-                                    try:
-                                        size = os.path.getsize(tmp.name)
-                                        # quick wave sanity check
-                                        try:
-                                            with _wave.open(tmp.name, 'rb') as tcheck:
-                                                params = (tcheck.getnchannels(), tcheck.getsampwidth(), tcheck.getframerate(), tcheck.getnframes())
-                                        except Exception as e:
-                                            # If the wave module can't read it, capture header and raise
-                                            with open(tmp.name, 'rb') as fh:
-                                                head = fh.read(256)
-                                            raise Exception(f"Temp WAV invalid (size={size}): wave.open failed: {e}; header={head[:64]!r}")
-
-                                        # Also try aaf2's WaveReader as an early check
-                                        try:
-                                            from aaf2 import audio as _audio
-                                            _wr = _audio.WaveReader(tmp.name)
-                                            _wr.close()
-                                        except Exception as e:
-                                            raise Exception(f"aaf2 WaveReader failed on temp WAV: {e}")
-
-                                    except Exception as diag_exc:
-                                        # Provide extra diagnostic info if import fails later
-                                        print(f"  Temp WAV diagnostics failed for {tmp.name}: {diag_exc}")
-                                    # Now import into the mob
-                                    phys_mob.import_audio_essence(tmp.name, edit_rate=sample_rate)
-                                    channel_mobs.append(phys_mob)
-
-                            finally:
-                                # cleanup temp files
-                                for p in tmp_paths:
-                                    try:
-                                        os.unlink(p)
-                                    except Exception:
-                                        pass
-                        else:
-                            # Use the library helper to import WAV essence directly into the AAF
-                            # This will create a PCMDescriptor, EssenceData and write frames into the file.
-                            try:
-                                # import_audio_essence expects a path and will write essence into the file
-                                # The returned source_slot contains descriptor and slot length info
-                                source_slot = wave_mob.import_audio_essence(str(wav_source_path), edit_rate=sample_rate)
-                                # descriptor and essence data have been attached to wave_mob by the helper
+                        try:
+                            if interleave_essence:
+                                # Data chunk copied block-for-block into one multichannel essence
+                                self.essence_writer.embed_into(f, wave_mob, wav_source_path, sample_rate, growing)
                                 channel_mobs.append(wave_mob)
-                            except Exception as e:
-                                # If embedding fails for any reason, surface the error so we can fall back or diagnose
-                                raise Exception(f"Embedding failed using import_audio_essence: {e}")
+                            elif channels > 1:
+                                # One mono SourceMob per channel, de-interleaved block by block
+                                channel_mobs.extend(self.essence_writer.embed_channels(
+                                    f, wav_source_path, wav_metadata.get('filename', 'Unknown'), sample_rate,
+                                    growing))
+                            else:
+                                # Essence goes straight into the WAVEDescriptor-chain SourceMob
+                                self.essence_writer.embed_into(f, wave_mob, wav_source_path, sample_rate, growing)
+                                channel_mobs.append(wave_mob)
+                        except Exception as e:
+                            # If embedding fails for any reason, surface the error so we can fall back or diagnose
+                            raise Exception(f"Embedding failed ({self.essence_writer.mode} essence writer): {e}")
+                        if growing is not None:
+                            # The recording has finished: only now are its length and header metadata final
+                            record = growing.final_record() or {}
+                            wav_metadata = record.get('wav_metadata') or wav_metadata
+                            bext_metadata = record.get('bext_metadata', bext_metadata)
+                            info_metadata = record.get('info_metadata', info_metadata)
+                            xml_metadata = record.get('xml_metadata', xml_metadata)
+                            ucs_metadata = record.get('ucs_metadata', ucs_metadata)
+                            audio_frames = growing.frames
+                            duration_seconds = audio_frames / sample_rate if sample_rate else 0
+                            video_length = int(duration_seconds * fps)
+                            for slot in import_mob.slots:
+                                slot.segment.length = video_length
                     else:
                         wave_desc = f.create.WAVEDescriptor()
                         wave_desc['SampleRate'].value = sample_rate
@@ -1380,23 +3059,11 @@ class AAFGenerator:
                         # Also add locators to WAVEDescriptor (some MC versions consult these for batch prefill)
                         try:
                             if wav_path.exists() and 'Locator' in wave_desc.keys():
-                                if relative_locators:
-                                    # Use relative path for WAVEDescriptor
-                                    relative_path = f"./{wav_path.name}"
-                                    nl = f.create.NetworkLocator(); nl['URLString'].value = relative_path; wave_desc['Locator'].append(nl)
-                                else:
-                                    from urllib.parse import quote
-                                    abs_posix = wav_path.as_posix()
-                                    avid_locator_url = f"file:///Macintosh%20HD{quote(abs_posix)}"
-                                    file_url_users = f"file://{quote(abs_posix)}"
-                                    file_url_localhost = f"file://localhost{quote(abs_posix)}"
-                                    abs_path = abs_posix
-                                    filename_only = wav_path.name
-                                    for url in [avid_locator_url, file_url_users, file_url_localhost, abs_path, filename_only]:
-                                        try:
-                                            nl = f.create.NetworkLocator(); nl['URLString'].value = url; wave_desc['Locator'].append(nl)
-                                        except Exception:
-                                            pass
+                                for url in self._locator_urls(wav_path, relative_locators):
+                                    try:
+                                        nl = f.create.NetworkLocator(); nl['URLString'].value = url; wave_desc['Locator'].append(nl)
+                                    except Exception:
+                                        pass
                         except Exception:
                             pass
                         wave_mob.descriptor = wave_desc
@@ -1417,12 +3084,12 @@ class AAFGenerator:
                         # linked case: this WAVEDescriptor represents all channels in this single SourceMob
                         channel_mobs = [wave_mob]
                     else:
-                        # For embedded audio we used import_audio_essence() which created the descriptor and
-                        # essence and also created a timeline slot on the SourceMob. No additional WAVEDescriptor
-                        # or channel slot setup is necessary here.
+                        # For embedded audio the EssenceWriter created the descriptor, the essence and the
+                        # timeline slot on each SourceMob. No additional WAVEDescriptor or channel slot
+                        # setup is necessary here.
                         pass
                 
-                # (Embedding handled above via import_audio_essence())
+                # (Embedding handled above via self.essence_writer)
                 
                 # === 3. Create MasterMob ===
                 master_mob = f.create.MasterMob()
@@ -1435,6 +3102,7 @@ class AAFGenerator:
                 master_length = audio_frames if embed_audio else video_length
                 
                 # MasterMob slot layout — one master slot per channel (linked or per-channel embedded)
+                interleaved = interleave_essence
                 for ch_idx in range(channels):
                         mslot = master_mob.create_timeline_slot(master_edit_rate)
                         mclip = f.create.SourceClip()
@@ -1445,7 +3113,12 @@ class AAFGenerator:
                         src_mob = channel_mobs[ch_idx] if ch_idx < len(channel_mobs) else channel_mobs[0]
                         mclip['SourceID'].value = src_mob.mob_id
                         # determine slot mapping depending on how channels were stored
-                        if embed_audio and channels > 1:
+                        if interleaved:
+                            # all channels live in slot 1 of one SourceMob; select this channel
+                            mclip['SourceMobSlotID'].value = 1
+                            mclip['ChannelIDs'].value = [ch_idx + 1]
+                            mslot['PhysicalTrackNumber'].value = ch_idx + 1
+                        elif embed_audio and channels > 1:
                             # each channel was embedded into its own SourceMob; its slot id will be 1
                             mclip['SourceMobSlotID'].value = 1
                         elif not embed_audio:
@@ -1455,12 +3128,13 @@ class AAFGenerator:
                             # embedded single-channel or other cases use slot 1
                             mclip['SourceMobSlotID'].value = 1
                         
-                        # Apply pan based on source mob count
-                        if len(channel_mobs) == 2:
+                        # Apply pan based on source mob count (channel count for interleaved essence)
+                        pan_sources = channels if interleaved else len(channel_mobs)
+                        if pan_sources == 2:
                             # Stereo: channel 1 = left (-1.0), channel 2 = right (1.0)
                             pan_value = -1.0 if ch_idx == 0 else 1.0
                             _apply_pan_to_slot(f, mslot, mclip, pan_value, master_length)
-                        elif len(channel_mobs) == 1:
+                        elif pan_sources == 1:
                             # Mono: center pan (0.0)
                             _apply_pan_to_slot(f, mslot, mclip, 0.0, master_length)
                         else:
@@ -1617,6 +3291,9 @@ class AAFGenerator:
                     f.content.mobs.append(channel_mobs[0])  # WAVE mob
                     f.content.mobs.append(master_mob)
                     f.content.mobs.append(import_mob)
+
+                # Marker regions become subclips of the MasterMob; the source chain is shared
+                self._append_region_subclips(f, master_mob, wav_metadata, master_edit_rate, master_length)
                 
                 return output_path
                 
@@ -1626,6 +3303,8 @@ class AAFGenerator:
             tb = traceback.format_exc()
             msg = f"Error creating AAF file: {e}\nFull traceback:\n{tb}"
             raise Exception(msg)
+        finally:
+            self.essence_writer.finalize(output_path)
 
     def create_multi_aaf(self, wav_entries: List[Dict[str, Dict]], output_path: str,
                          fps: float = 24, embed_audio: bool = False, link_mode: str = 'import') -> str:
@@ -1640,7 +3319,7 @@ class AAFGenerator:
             
         try:
             fps = int(fps)
-            with aaf2.open(output_path, 'w') as f:
+            with self._open_aaf_for_write(output_path) as f:
                 # Set file identification
                 f.header['ObjectModelVersion'].value = 1
                 f.header['Version'].value = {'major': 1, 'minor': 2}
@@ -1650,6 +3329,7 @@ class AAFGenerator:
                     ident['ProductVersionString'].value = __version__
                     break
 
+                prototypes = MobPrototypeCache(enabled=self.mob_prototypes)
                 for entry in wav_entries:
                     wav_metadata = entry.get('wav_metadata', {})
                     bext_metadata = entry.get('bext_metadata', {})
@@ -1662,10 +3342,7 @@ class AAFGenerator:
                     sample_rate = int(wav_metadata.get('sample_rate', 48000))
                     audio_frames = int(wav_metadata.get('frames', 0))
                     sample_width = int(wav_metadata.get('sample_width', 2))
-                    bit_depth = int(sample_width * 8)
-                    duration_seconds = audio_frames / sample_rate if sample_rate else 0
-                    # Use sample_rate as timeline edit rate for audio AAF (spec-compliant)
-                    timeline_edit_rate = sample_rate
+                    # sample_rate is the timeline edit rate for audio AAF (spec-compliant)
                     clip_length = audio_frames
 
                     # Resolve path
@@ -1673,190 +3350,439 @@ class AAFGenerator:
                     wav_path = Path(wav_metadata.get('filepath', ''))
 
                     # Currently support 'import' mode for multi-clip AAF. 'pcm' can be added if needed.
-                    # 1) ImportDescriptor SourceMob
-                    import_mob = f.create.SourceMob()
-                    import_mob.name = wav_metadata.get('filename', 'Unknown')
-                    # Set deterministic UMID for consistent batch import behavior
-                    import_mob.mob_id = create_deterministic_umid(wav_path, "import")
-                    import_desc = f.create.ImportDescriptor()
+                    # The mob chain comes from a per-shape prototype; only identity, length and locators differ.
+                    filename = wav_metadata.get('filename', 'Unknown')
+                    import_mob, wave_mob, master_mob = prototypes.chain(
+                        ('import', channels, sample_rate, sample_width), clip_length,
+                        lambda length: self._build_multi_clip_mobs(f, channels, sample_rate, sample_width,
+                                                                   length, filename))
+                    # Set deterministic UMIDs for consistent batch import behavior
+                    self._retarget_mob_chain(
+                        [import_mob, wave_mob, master_mob],
+                        create_deterministic_umids(wav_path, ["import", "wave", "master"]),
+                        clip_length, filename)
+                    import_mob.name = filename
+                    wave_mob.name = filename
+                    master_mob.name = Path(filename).stem
                     if wav_path.exists():
-                        from urllib.parse import quote
-                        abs_posix = wav_path.as_posix()
-                        file_url_users = f"file://{quote(abs_posix)}"
-                        file_url_localhost = f"file://localhost{quote(abs_posix)}"
-                        abs_path = abs_posix
-                        filename_only = wav_path.name
-                        loc1 = f.create.NetworkLocator(); loc1['URLString'].value = file_url_users; import_desc['Locator'].append(loc1)
-                        loc2 = f.create.NetworkLocator(); loc2['URLString'].value = file_url_localhost; import_desc['Locator'].append(loc2)
-                        loc3 = f.create.NetworkLocator(); loc3['URLString'].value = abs_path; import_desc['Locator'].append(loc3)
-                        loc4 = f.create.NetworkLocator(); loc4['URLString'].value = filename_only; import_desc['Locator'].append(loc4)
-                    import_mob.descriptor = import_desc
-
-                    # Import slots
-                    if channels == 1:
-                        slot = import_mob.create_timeline_slot(timeline_edit_rate)
-                        clip = f.create.SourceClip()
-                        clip['DataDefinition'].value = f.dictionary.lookup_datadef('sound')
-                        clip['Length'].value = clip_length
-                        clip['StartTime'].value = 0
-                        slot.segment = clip
-                        slot.name = wav_metadata.get('filename', 'Unknown')
-                        tc_slot = import_mob.create_timeline_slot(timeline_edit_rate)
-                        tc = f.create.Timecode(length=clip_length)
-                        tc['Start'].value = 0
-                        tc['FPS'].value = timeline_edit_rate  # Use timeline rate for timecode
-                        tc_slot.segment = tc
-                    else:
-                        slot1 = import_mob.create_timeline_slot(timeline_edit_rate)
-                        clip1 = f.create.SourceClip()
-                        clip1['DataDefinition'].value = f.dictionary.lookup_datadef('sound')
-                        clip1['Length'].value = clip_length
-                        clip1['StartTime'].value = 0
-                        slot1.segment = clip1
-                        slot1.name = wav_metadata.get('filename', 'Unknown')
-                        tc_slot = import_mob.create_timeline_slot(timeline_edit_rate)
-                        tc = f.create.Timecode(length=clip_length)
-                        tc['Start'].value = 0
-                        tc['FPS'].value = timeline_edit_rate
-                        tc_slot.segment = tc
-                        for ch_idx in range(1, channels):
-                            slot = import_mob.create_timeline_slot(timeline_edit_rate)
-                            clip = f.create.SourceClip()
-                            clip['DataDefinition'].value = f.dictionary.lookup_datadef('sound')
-                            clip['Length'].value = clip_length
-                            clip['StartTime'].value = 0
-                            slot.segment = clip
-                            slot.name = wav_metadata.get('filename', 'Unknown')
-
-                    # 2) WAVEDescriptor SourceMob
-                    wave_mob = f.create.SourceMob()
-                    wave_mob.name = wav_metadata.get('filename', 'Unknown')
-                    # Set deterministic UMID for consistent batch import behavior
-                    wave_mob.mob_id = create_deterministic_umid(wav_path, "wave")
-                    wave_desc = f.create.WAVEDescriptor()
-                    wave_desc['SampleRate'].value = sample_rate
-                    wave_desc['Length'].value = audio_frames
-                    try:
-                        wave_desc['ContainerFormat'].value = f.dictionary.lookup_containerdef('OMF')
-                    except Exception:
-                        wave_desc['ContainerFormat'].value = f.dictionary.lookup_containerdef('AAF')
-                    summary = bytearray()
-                    summary.extend(b'RIFF'); summary.extend(struct.pack('<I', 0)); summary.extend(b'WAVE')
-                    summary.extend(b'fmt '); summary.extend(struct.pack('<I', 16)); summary.extend(struct.pack('<H', 1))
-                    summary.extend(struct.pack('<H', channels)); summary.extend(struct.pack('<I', int(sample_rate)))
-                    bytes_per_sec = int(sample_rate * sample_width * channels)
-                    summary.extend(struct.pack('<I', bytes_per_sec))
-                    summary.extend(struct.pack('<H', int(sample_width * channels)))
-                    summary.extend(struct.pack('<H', int(bit_depth)))
-                    summary.extend(b'data'); summary.extend(struct.pack('<I', int(audio_frames * sample_width * channels)))
-                    wave_desc['Summary'].value = bytes(summary)
-                    wave_mob.descriptor = wave_desc
-                    channel_mobs = [wave_mob]
-                    for ch_idx in range(channels):
-                        wslot = wave_mob.create_timeline_slot(timeline_edit_rate)
-                        wclip = f.create.SourceClip()
-                        wclip['DataDefinition'].value = f.dictionary.lookup_datadef('sound')
-                        wclip['Length'].value = clip_length
-                        wclip['StartTime'].value = 0
-                        wclip['SourceID'].value = import_mob.mob_id
-                        import_slot_id = 1 if ch_idx == 0 else (ch_idx + 2)
-                        wclip['SourceMobSlotID'].value = import_slot_id
-                        wslot.segment = wclip
-
-                    # 3) MasterMob
-                    master_mob = f.create.MasterMob()
-                    master_mob.name = Path(wav_metadata.get('filename', 'Unknown')).stem
-                    # Set deterministic UMID for consistent batch import behavior
-                    master_mob.mob_id = create_deterministic_umid(wav_path, "master")
-                    for ch_idx in range(channels):
-                        mslot = master_mob.create_timeline_slot(timeline_edit_rate)
-                        mclip = f.create.SourceClip()
-                        mclip['DataDefinition'].value = f.dictionary.lookup_datadef('sound')
-                        mclip['Length'].value = clip_length
-                        mclip['StartTime'].value = 0
-                        mclip['SourceID'].value = wave_mob.mob_id
-                        mclip['SourceMobSlotID'].value = ch_idx + 1
-                        
-                        # Apply pan based on channel count (WAVE descriptor mode)
-                        if channels == 2:
-                            # Stereo: channel 0 = left (-1.0), channel 1 = right (1.0)
-                            pan_value = -1.0 if ch_idx == 0 else 1.0
-                            _apply_pan_to_slot(f, mslot, mclip, pan_value, clip_length)
-                        elif channels == 1:
-                            # Mono: center pan (0.0)
-                            _apply_pan_to_slot(f, mslot, mclip, 0.0, clip_length)
-                        else:
-                            # Multi-channel (>2): no pan control
-                            mslot.segment = mclip
-                        
-                        mslot.name = wav_metadata.get('filename', 'Unknown')
+                        for url in self._locator_urls(wav_path, avid_volume_url=False):
+                            loc = f.create.NetworkLocator(); loc['URLString'].value = url
+                            import_mob.descriptor['Locator'].append(loc)
+                    wave_mob.descriptor['Length'].value = audio_frames
+                    wave_mob.descriptor['Summary'].value = self._wave_summary(channels, sample_rate, sample_width,
+                                                                              audio_frames)
 
                     # 4) Metadata on MasterMob
-                    if bext_metadata:
-                        if bext_metadata.get('description'):
-                            master_mob.comments['BEXT_Description'] = bext_metadata['description']
-                        if bext_metadata.get('originator'):
-                            master_mob.comments['BEXT_Originator'] = bext_metadata['originator']
-                        if bext_metadata.get('originator_reference'):
-                            master_mob.comments['BEXT_Originator_Reference'] = bext_metadata['originator_reference']
-                        if bext_metadata.get('origination_date'):
-                            master_mob.comments['BEXT_Origination_Date'] = bext_metadata['origination_date']
-                        if bext_metadata.get('origination_time'):
-                            master_mob.comments['BEXT_Origination_Time'] = bext_metadata['origination_time']
-                        if bext_metadata.get('time_reference'):
-                            master_mob.comments['BEXT_Time_Reference'] = str(bext_metadata['time_reference'])
-                        if bext_metadata.get('umid'):
-                            master_mob.comments['BEXT_UMID'] = bext_metadata['umid']
-                    if info_metadata:
-                        info_mappings = {
-                            'IART': 'INFO_Artist','ICMT': 'INFO_Comment','ICOP': 'INFO_Copyright','ICRD': 'INFO_Creation_Date',
-                            'IENG': 'INFO_Engineer','IGNR': 'INFO_Genre','IKEY': 'INFO_Keywords','INAM': 'INFO_Title',
-                            'IPRD': 'INFO_Product','ISBJ': 'INFO_Subject','ISFT': 'INFO_Software','ISRC': 'INFO_Source'
-                        }
-                        for chunk_id, value in info_metadata.items():
-                            if value:
-                                master_mob.comments[info_mappings.get(chunk_id, f'INFO_{chunk_id}')] = str(value)
-                    if ucs_metadata and 'primary_category' in ucs_metadata:
-                        category = ucs_metadata['primary_category']
-                        master_mob.comments['UCS_Category'] = category.get('category','')
-                        master_mob.comments['UCS_SubCategory'] = category.get('subcategory','')
-                        master_mob.comments['UCS_ID'] = category.get('id','')
-                        master_mob.comments['UCS_Full_Name'] = category.get('full_name','')
-                        master_mob.comments['UCS_Match_Score'] = str(category.get('score',''))
-                        master_mob.comments['Category'] = category.get('category','')
-                        master_mob.comments['SubCategory'] = category.get('subcategory','')
-                        master_mob.comments['UCS ID'] = category.get('id','')
-                    if bext_metadata and bext_metadata.get('description'):
-                        master_mob.comments['Description'] = bext_metadata['description']
-                    elif info_metadata and 'INAM' in info_metadata:
-                        master_mob.comments['Description'] = str(info_metadata.get('INAM'))
-                    master_mob.comments['Name'] = str(Path(wav_metadata.get('filename','Unknown')).stem)
-                    master_mob.comments['Filename'] = str(Path(wav_metadata.get('filename','Unknown')).name)
-                    master_mob.comments['FilePath'] = str(wav_path)
-                    master_mob.comments['SampleRate'] = str(sample_rate)
-                    master_mob.comments['BitDepth'] = str(bit_depth)
-                    master_mob.comments['Channels'] = str(channels)
-                    master_mob.comments['Number of Frames'] = str(audio_frames)
-                    master_mob.comments['AudioFormat'] = 'WAV'
-                    master_mob.comments['Tracks'] = 'A1' if channels==1 else ('A1A2' if channels==2 else f"A1A{channels}")
-                    master_mob.comments['Duration'] = f"{duration_seconds:.3f}"
-                    master_mob.comments['Start'] = "00:00:00:00"
-                    master_mob.comments['End'] = "00:00:00:00"
-                    # Tape field - set to directory name for batch import consistency
-                    tape_name = Path(wav_path).parent.name if wav_path else "Unknown"
-                    master_mob.comments['Tape'] = tape_name
-                    master_mob.comments['Scene'] = ""
-                    master_mob.comments['Take'] = ""
+                    for name, value in self._clip_comments(
+                            wav_metadata, bext_metadata, info_metadata, ucs_metadata, wav_path,
+                            # Tape field - set to directory name for batch import consistency
+                            Path(wav_path).parent.name if wav_path else "Unknown").items():
+                        master_mob.comments[name] = value
 
                     # Order: WAVEDesc SourceMob, MasterMob, ImportDesc SourceMob
                     f.content.mobs.append(wave_mob)
                     f.content.mobs.append(master_mob)
                     f.content.mobs.append(import_mob)
+                    self._append_region_subclips(f, master_mob, wav_metadata, sample_rate, clip_length)
 
                 return output_path
         except Exception as e:
             raise Exception(f"Error creating multi-clip AAF: {e}")
 
+    @staticmethod
+    def _region_umid_key(region: Dict) -> str:
+        """create_deterministic_umid mob type for a region: its span in file samples plus its cue id
+        (cue markers) or name (iXML sync points)"""
+        label = region['cue_id'] if region.get('cue_id') is not None else region.get('name', '')
+        return f"subclip|{region.get('source', '')}|{label}|{region['start']}|{region['length']}"
+
+    def _append_region_subclips(self, f, master_mob, wav_metadata: Dict, edit_rate: int, master_length: int) -> List:
+        """Add one subclip MasterMob per wav_metadata['regions'] entry, referencing master_mob.
+
+        Each subclip has one slot per master slot, a SourceClip with the region's start/length
+        (rescaled from the region's sample rate to edit_rate). No essence is split or copied.
+        Subclip mob IDs come from the region itself, not its position in the list, so adding or
+        removing a marker leaves the other regions' subclips linked.
+        """
+        regions = wav_metadata.get('regions') or []
+        if not regions:
+            return []
+        wav_path = Path(wav_metadata.get('source_filepath') or wav_metadata.get('filepath', ''))
+        stem = Path(wav_metadata.get('filename', 'Unknown')).stem
+        master_slots = [slot for slot in master_mob.slots]
+        subclips = []
+        sound = f.dictionary.lookup_datadef('sound')
+        for region in regions:
+            scale = edit_rate / float(region.get('sample_rate') or edit_rate)
+            start = int(round(region['start'] * scale))
+            length = min(int(round(region['length'] * scale)), master_length - start)
+            if start < 0 or length <= 0:
+                continue
+            sub = f.create.MasterMob()
+            sub.name = f"{stem}.{region['name']}"
+            sub.mob_id = create_deterministic_umid(wav_path, self._region_umid_key(region))
+            for mslot in master_slots:
+                slot = sub.create_timeline_slot(edit_rate)
+                clip = f.create.SourceClip()
+                clip['DataDefinition'].value = sound
+                clip['Length'].value = length
+                clip['StartTime'].value = start
+                clip['SourceID'].value = master_mob.mob_id
+                clip['SourceMobSlotID'].value = mslot.slot_id
+                slot.segment = clip
+                slot.name = mslot.name
+            sub.comments['Name'] = sub.name
+            sub.comments['Filename'] = str(wav_metadata.get('filename', ''))
+            sub.comments['FilePath'] = str(wav_path)
+            sub.comments['Subclip Of'] = str(master_mob.name)
+            sub.comments['Duration'] = f"{length / float(edit_rate):.3f}"
+            if region.get('comment'):
+                sub.comments['Description'] = region['comment']
+            f.content.mobs.append(sub)
+            subclips.append(sub)
+        return subclips
+
+    @staticmethod
+    def _clip_comments(wav_metadata: Dict, bext_metadata: Dict, info_metadata: Dict, ucs_metadata: Dict,
+                       wav_path: Path, tape_name: str) -> Dict[str, str]:
+        """MasterMob comments of one multi-clip AAF clip, in the order they are written"""
+        comments: Dict[str, str] = {}
+        if bext_metadata:
+            if bext_metadata.get('description'):
+                comments['BEXT_Description'] = bext_metadata['description']
+            if bext_metadata.get('originator'):
+                comments['BEXT_Originator'] = bext_metadata['originator']
+            if bext_metadata.get('originator_reference'):
+                comments['BEXT_Originator_Reference'] = bext_metadata['originator_reference']
+            if bext_metadata.get('origination_date'):
+                comments['BEXT_Origination_Date'] = bext_metadata['origination_date']
+            if bext_metadata.get('origination_time'):
+                comments['BEXT_Origination_Time'] = bext_metadata['origination_time']
+            if bext_metadata.get('time_reference'):
+                comments['BEXT_Time_Reference'] = str(bext_metadata['time_reference'])
+            if bext_metadata.get('umid'):
+                comments['BEXT_UMID'] = bext_metadata['umid']
+        if info_metadata:
+            info_mappings = {
+                'IART': 'INFO_Artist','ICMT': 'INFO_Comment','ICOP': 'INFO_Copyright','ICRD': 'INFO_Creation_Date',
+                'IENG': 'INFO_Engineer','IGNR': 'INFO_Genre','IKEY': 'INFO_Keywords','INAM': 'INFO_Title',
+                'IPRD': 'INFO_Product','ISBJ': 'INFO_Subject','ISFT': 'INFO_Software','ISRC': 'INFO_Source'
+            }
+            for chunk_id, value in info_metadata.items():
+                if value:
+                    comments[info_mappings.get(chunk_id, f'INFO_{chunk_id}')] = str(value)
+        if ucs_metadata and 'primary_category' in ucs_metadata:
+            category = ucs_metadata['primary_category']
+            comments['UCS_Category'] = category.get('category','')
+            comments['UCS_SubCategory'] = category.get('subcategory','')
+            comments['UCS_ID'] = category.get('id','')
+            comments['UCS_Full_Name'] = category.get('full_name','')
+            comments['UCS_Match_Score'] = str(category.get('score',''))
+            comments['Category'] = category.get('category','')
+            comments['SubCategory'] = category.get('subcategory','')
+            comments['UCS ID'] = category.get('id','')
+        if bext_metadata and bext_metadata.get('description'):
+            comments['Description'] = bext_metadata['description']
+        elif info_metadata and 'INAM' in info_metadata:
+            comments['Description'] = str(info_metadata.get('INAM'))
+        channels = int(wav_metadata.get('channels', 1))
+        sample_rate = int(wav_metadata.get('sample_rate', 48000))
+        audio_frames = int(wav_metadata.get('frames', 0))
+        comments['Name'] = str(Path(wav_metadata.get('filename','Unknown')).stem)
+        comments['Filename'] = str(Path(wav_metadata.get('filename','Unknown')).name)
+        comments['FilePath'] = str(wav_path)
+        comments['SampleRate'] = str(sample_rate)
+        comments['BitDepth'] = str(int(wav_metadata.get('sample_width', 2)) * 8)
+        comments['Channels'] = str(channels)
+        comments['Number of Frames'] = str(audio_frames)
+        comments['AudioFormat'] = 'WAV'
+        comments['Tracks'] = 'A1' if channels==1 else ('A1A2' if channels==2 else f"A1A{channels}")
+        comments['Duration'] = f"{(audio_frames / sample_rate if sample_rate else 0):.3f}"
+        comments['Start'] = "00:00:00:00"
+        comments['End'] = "00:00:00:00"
+        comments['Tape'] = tape_name
+        comments['Scene'] = ""
+        comments['Take'] = ""
+        if wav_metadata.get('sync_group'):
+            comments['SyncGroup'] = wav_metadata['sync_group']
+        return comments
+
+    def _channel_ids_supported(self, f) -> bool:
+        """True if SourceClip has the ChannelIDs property (selects a channel of interleaved essence).
+
+        The property set comes with the pyaaf2 version, not the file, so the throwaway SourceClip
+        is created once per generator rather than in every output file.
+        """
+        if self._channel_ids_support is None:
+            try:
+                f.create.SourceClip()['ChannelIDs']
+                self._channel_ids_support = True
+            except Exception:
+                self._channel_ids_support = False
+                print("  Warning: SourceClip ChannelIDs not available in this pyaaf2; "
+                      "embedding one SourceMob per channel instead of interleaved")
+        return self._channel_ids_support
+
+    def _build_multi_clip_mobs(self, f, channels: int, sample_rate: int, sample_width: int,
+                               clip_length: int, filename: str) -> Tuple:
+        """Build the ImportDescriptor → WAVEDescriptor → MasterMob chain of one multi-AAF clip.
+
+        Locators, comments and deterministic UMIDs are applied by the caller (see _retarget_mob_chain).
+        """
+        timeline_edit_rate = sample_rate
+        sound = f.dictionary.lookup_datadef('sound')
+
+        # 1) ImportDescriptor SourceMob
+        import_mob = f.create.SourceMob()
+        import_mob.name = filename
+        import_mob.descriptor = f.create.ImportDescriptor()
+
+        # Import slots: Ch1, Timecode, then remaining channels
+        slot1 = import_mob.create_timeline_slot(timeline_edit_rate)
+        clip1 = f.create.SourceClip()
+        clip1['DataDefinition'].value = sound
+        clip1['Length'].value = clip_length
+        clip1['StartTime'].value = 0
+        slot1.segment = clip1
+        slot1.name = filename
+        tc_slot = import_mob.create_timeline_slot(timeline_edit_rate)
+        tc = f.create.Timecode(length=clip_length)
+        tc['Start'].value = 0
+        tc['FPS'].value = timeline_edit_rate  # Use timeline rate for timecode
+        tc_slot.segment = tc
+        for ch_idx in range(1, channels):
+            slot = import_mob.create_timeline_slot(timeline_edit_rate)
+            clip = f.create.SourceClip()
+            clip['DataDefinition'].value = sound
+            clip['Length'].value = clip_length
+            clip['StartTime'].value = 0
+            slot.segment = clip
+            slot.name = filename
+
+        # 2) WAVEDescriptor SourceMob
+        wave_mob = f.create.SourceMob()
+        wave_mob.name = filename
+        wave_desc = f.create.WAVEDescriptor()
+        wave_desc['SampleRate'].value = sample_rate
+        wave_desc['Length'].value = clip_length
+        try:
+            wave_desc['ContainerFormat'].value = f.dictionary.lookup_containerdef('OMF')
+        except Exception:
+            wave_desc['ContainerFormat'].value = f.dictionary.lookup_containerdef('AAF')
+        wave_desc['Summary'].value = self._wave_summary(channels, sample_rate, sample_width, clip_length)
+        wave_mob.descriptor = wave_desc
+        for ch_idx in range(channels):
+            wslot = wave_mob.create_timeline_slot(timeline_edit_rate)
+            wclip = f.create.SourceClip()
+            wclip['DataDefinition'].value = sound
+            wclip['Length'].value = clip_length
+            wclip['StartTime'].value = 0
+            wclip['SourceID'].value = import_mob.mob_id
+            import_slot_id = 1 if ch_idx == 0 else (ch_idx + 2)
+            wclip['SourceMobSlotID'].value = import_slot_id
+            wslot.segment = wclip
+
+        # 3) MasterMob
+        master_mob = f.create.MasterMob()
+        master_mob.name = Path(filename).stem
+        for ch_idx in range(channels):
+            mslot = master_mob.create_timeline_slot(timeline_edit_rate)
+            mclip = f.create.SourceClip()
+            mclip['DataDefinition'].value = sound
+            mclip['Length'].value = clip_length
+            mclip['StartTime'].value = 0
+            mclip['SourceID'].value = wave_mob.mob_id
+            mclip['SourceMobSlotID'].value = ch_idx + 1
+
+            # Apply pan based on channel count (WAVE descriptor mode)
+            if channels == 2:
+                # Stereo: channel 0 = left (-1.0), channel 1 = right (1.0)
+                pan_value = -1.0 if ch_idx == 0 else 1.0
+                _apply_pan_to_slot(f, mslot, mclip, pan_value, clip_length)
+            elif channels == 1:
+                # Mono: center pan (0.0)
+                _apply_pan_to_slot(f, mslot, mclip, 0.0, clip_length)
+            else:
+                # Multi-channel (>2): no pan control
+                mslot.segment = mclip
+
+            mslot.name = filename
+        return import_mob, wave_mob, master_mob
+
+    def _build_multi_tape_mobs(self, f, fps: int, video_length: int, wav_stem: str) -> Tuple:
+        """Build the TapeDescriptor SourceMob + MasterMob pair of one multi-clip tape AAF clip"""
+        tape_mob = self._build_tape_source_mob(f, fps, video_length, f"Tape_{wav_stem}")
+        return tape_mob, self._build_tape_master_mob(f, fps, video_length, wav_stem, tape_mob.mob_id)
+
+    def _build_tape_source_mob(self, f, fps: int, video_length: int, name: str):
+        """TapeDescriptor SourceMob with video (1) and audio (2) slots, mimicking ALE-exported AAFs"""
+        tape_mob = f.create.SourceMob()
+        tape_mob.name = name
+        tape_desc = f.create.from_name('TapeDescriptor')
+        tape_desc['ColorFrame'].value = 0
+        tape_mob.descriptor = tape_desc
+
+        # Create slots like ALE exports: video slot (1) + audio slot (2)
+        # Video slot
+        video_slot = tape_mob.create_timeline_slot(fps)
+        video_slot.slot_id = 1
+        video_clip = f.create.SourceClip()
+        video_clip['DataDefinition'].value = f.dictionary.lookup_datadef('picture')
+        video_clip['Length'].value = video_length
+        video_clip['StartTime'].value = 0
+        video_clip['SourceID'].value = aaf2.mobid.MobID()  # NULL source
+        video_clip['SourceMobSlotID'].value = 0
+        video_slot.segment = video_clip
+
+        # Audio slot
+        audio_slot = tape_mob.create_timeline_slot(fps)
+        audio_slot.slot_id = 2
+        audio_clip = f.create.SourceClip()
+        audio_clip['DataDefinition'].value = f.dictionary.lookup_datadef('sound')
+        audio_clip['Length'].value = video_length
+        audio_clip['StartTime'].value = 0
+        audio_clip['SourceID'].value = aaf2.mobid.MobID()  # NULL source
+        audio_clip['SourceMobSlotID'].value = 0
+        audio_slot.segment = audio_clip
+        return tape_mob
+
+    def _build_tape_master_mob(self, f, fps: int, video_length: int, wav_stem: str, tape_mob_id):
+        """MasterMob (ALE-exported naming: filename.Exported.01) referencing a tape's audio slot"""
+        master_mob = f.create.MasterMob()
+        master_mob.name = f"{wav_stem}.Exported.01"
+
+        # Single audio slot referencing the tape
+        master_slot = master_mob.create_timeline_slot(fps)
+        master_slot.slot_id = 1
+        master_clip = f.create.SourceClip()
+        master_clip['DataDefinition'].value = f.dictionary.lookup_datadef('sound')
+        master_clip['Length'].value = video_length
+        master_clip['StartTime'].value = 0
+        master_clip['SourceID'].value = tape_mob_id
+        master_clip['SourceMobSlotID'].value = 2  # Reference audio slot on tape
+        master_slot.segment = master_clip
+        return master_mob
+
+    @staticmethod
+    def tape_name_for(entry: Dict) -> str:
+        """Tape a clip belongs to: iXML TAPE, then BEXT originator reference, then the WAV's folder name"""
+        for key, value in (entry.get('xml_metadata') or {}).items():
+            if key.split('_')[-1].upper() == 'TAPE' and str(value).strip():
+                return str(value).strip()
+        reference = ((entry.get('bext_metadata') or {}).get('originator_reference') or '').strip()
+        if reference:
+            return reference
+        folder = Path((entry.get('wav_metadata') or {}).get('filepath', '')).parent.name
+        return folder or 'Tape'
+
+    @classmethod
+    def group_tapes(cls, wav_entries: List[Dict], fps: int) -> Dict[str, Dict]:
+        """Group clips by tape name; each tape spans its clips' time_reference ranges in fps frames.
+
+        Returns {tape: {'start': first frame, 'length': frames, 'clips': [(entry, offset, length)]}},
+        where offset is the clip's position on the tape relative to 'start'. Clips without a BEXT
+        time reference have no position on a tape and are left out (they keep their own tape mob).
+        """
+        tapes: Dict[str, Dict] = {}
+        for entry in wav_entries:
+            time_reference = int((entry.get('bext_metadata') or {}).get('time_reference') or 0)
+            if not time_reference:
+                continue
+            wav_metadata = entry.get('wav_metadata', {})
+            sample_rate = int(wav_metadata.get('sample_rate', 48000)) or 48000
+            frames = int(wav_metadata.get('frames', 0))
+            start = time_reference * fps // sample_rate
+            length = int(frames / sample_rate * fps)
+            tapes.setdefault(cls.tape_name_for(entry), {'clips': []})['clips'].append([entry, start, length])
+        for tape in tapes.values():
+            tape['start'] = min(start for _, start, _ in tape['clips'])
+            tape['length'] = max(start + length for _, start, length in tape['clips']) - tape['start']
+            tape['clips'] = [(entry, start - tape['start'], length) for entry, start, length in tape['clips']]
+        return tapes
+
+    @staticmethod
+    def tape_identity(tape: Dict) -> Tuple[str, str, str]:
+        """What tells one tape from another of the same name: the folder holding its clips, and the
+        recording day and originator of its earliest clip"""
+        clips = [entry for entry, _, _ in sorted(tape['clips'], key=lambda clip: clip[1])]
+        folders = [str(Path((entry.get('wav_metadata') or {}).get('filepath', '')).resolve().parent)
+                   for entry in clips]
+        try:
+            root = os.path.commonpath(folders) if folders else ''
+        except ValueError:
+            root = min(folders)
+        bext = (clips[0].get('bext_metadata') or {}) if clips else {}
+        return root, str(bext.get('origination_date') or ''), str(bext.get('originator') or '')
+
+    def _add_shared_tape_mobs(self, f, wav_entries: List[Dict], fps: int) -> Dict[int, Tuple]:
+        """Create one TapeDescriptor SourceMob per tape; returns {id(entry): (tape, tape_mob_id, offset)}.
+
+        Clips missing from the result (no time reference) get their own Tape_<stem> mob.
+        """
+        placements = {}
+        for tape_name, tape in self.group_tapes(wav_entries, fps).items():
+            tape_mob = self._build_tape_source_mob(f, fps, tape['length'], tape_name)
+            tape_mob.mob_id = create_tape_umid(tape_name, self.tape_identity(tape))
+            try:
+                tc_slot = tape_mob.create_timecode_slot(fps, fps)
+                tc_slot.segment.start = tape['start']
+                tc_slot.segment.length = tape['length']
+            except Exception as e:
+                logger.debug(f"Tape timecode slot unavailable: {e}")
+            f.content.mobs.append(tape_mob)
+            for entry, offset, _ in tape['clips']:
+                placements[id(entry)] = (tape_name, tape_mob.mob_id, offset)
+        return placements
+
+    @staticmethod
+    def _wave_summary(channels: int, sample_rate: int, sample_width: int, frames: int) -> bytes:
+        """Minimal RIFF summary (fmt + data size) for a linked WAVEDescriptor"""
+        summary = bytearray()
+        summary.extend(b'RIFF'); summary.extend(struct.pack('<I', 0)); summary.extend(b'WAVE')
+        summary.extend(b'fmt '); summary.extend(struct.pack('<I', 16)); summary.extend(struct.pack('<H', 1))
+        summary.extend(struct.pack('<H', channels)); summary.extend(struct.pack('<I', int(sample_rate)))
+        summary.extend(struct.pack('<I', int(sample_rate * sample_width * channels)))
+        summary.extend(struct.pack('<H', int(sample_width * channels)))
+        summary.extend(struct.pack('<H', int(sample_width * 8)))
+        summary.extend(b'data'); summary.extend(struct.pack('<I', int(frames * sample_width * channels)))
+        return bytes(summary)
+
+    @classmethod
+    def _retarget_segment(cls, segment, id_map: Dict, length: int):
+        segment['Length'].value = length
+        if isinstance(segment, aaf2.components.SourceClip):
+            new_id = id_map.get(str(segment['SourceID'].value))
+            if new_id is not None:
+                segment['SourceID'].value = new_id
+        elif isinstance(segment, aaf2.components.OperationGroup):
+            for child in segment.segments:
+                cls._retarget_segment(child, id_map, length)
+            for param in segment.parameters:
+                try:
+                    points = list(param['PointList'].value)
+                except Exception:
+                    continue
+                # Pan control points sit at the first and last edit unit (see _apply_pan_to_slot)
+                if points and length > 0:
+                    points[0]['Time'].value = aaf2.rational.AAFRational(f"0/{length}")
+                    points[-1]['Time'].value = aaf2.rational.AAFRational(f"{length - 1}/{length}")
+
+    @classmethod
+    def _retarget_mob_chain(cls, mobs: List, mob_ids: List, length: int, slot_name: Optional[str] = None):
+        """Give a built or cloned mob chain its own UMIDs, clip length and slot names.
+
+        SourceClips that pointed at a mob of the chain are repointed at its new UMID.
+        """
+        id_map = {}
+        for mob, mob_id in zip(mobs, mob_ids):
+            id_map[str(mob.mob_id)] = mob_id
+            mob.mob_id = mob_id
+        for mob in mobs:
+            for slot in mob.slots:
+                cls._retarget_segment(slot.segment, id_map, length)
+                if slot_name is not None and slot.name:
+                    slot.name = slot_name
+
     def create_multi_tape_aaf(self, wav_entries: List[Dict[str, Dict]], output_path: str,
                              fps: float = 24) -> str:
         """Create a single AAF with multiple clips using TapeDescriptor structure (like ALE-exported AAFs).
@@ -1865,7 +3791,7 @@ class AAFGenerator:
         """
         try:
             fps = int(fps)
-            with aaf2.open(output_path, 'w') as f:
+            with self._open_aaf_for_write(output_path) as f:
                 # Set file identification
                 f.header['ObjectModelVersion'].value = 1
                 f.header['Version'].value = {'major': 1, 'minor': 2}
@@ -1875,6 +3801,9 @@ class AAFGenerator:
                     ident['ProductVersionString'].value = __version__
                     break
 
+                prototypes = MobPrototypeCache(enabled=self.mob_prototypes)
+                # Shared tapes: tape mobs first, each created once; clips then only add MasterMobs
+                tape_placements = self._add_shared_tape_mobs(f, wav_entries, fps) if self.shared_tapes else {}
                 for entry in wav_entries:
                     wav_metadata = entry.get('wav_metadata', {})
                     bext_metadata = entry.get('bext_metadata', {})
@@ -1886,8 +3815,6 @@ class AAFGenerator:
                     channels = int(wav_metadata.get('channels', 1))
                     sample_rate = int(wav_metadata.get('sample_rate', 48000))
                     audio_frames = int(wav_metadata.get('frames', 0))
-                    sample_width = int(wav_metadata.get('sample_width', 2))
-                    bit_depth = int(sample_width * 8)
                     duration_seconds = audio_frames / sample_rate if sample_rate else 0
                     video_length = int(duration_seconds * fps)
 
@@ -1896,113 +3823,41 @@ class AAFGenerator:
                     wav_path = Path(wav_metadata.get('filepath', ''))
                     wav_stem = wav_path.stem
 
-                    # 1) TapeDescriptor SourceMob (mimics ALE-exported structure)
-                    tape_mob = f.create.SourceMob()
-                    tape_mob.name = f"Tape_{wav_stem}"
-                    # Use Avid-style UMID prefix (01010f10) with tape_mode=True
-                    tape_mob.mob_id = create_deterministic_umid(wav_path, "tape", tape_mode=True)
-                    
-                    tape_desc = f.create.from_name('TapeDescriptor')
-                    tape_desc['ColorFrame'].value = 0
-                    tape_mob.descriptor = tape_desc
-
-                    # Create slots like ALE exports: video slot (1) + audio slot (2)
-                    # Video slot
-                    video_slot = tape_mob.create_timeline_slot(fps)
-                    video_slot.slot_id = 1
-                    video_clip = f.create.SourceClip()
-                    video_clip['DataDefinition'].value = f.dictionary.lookup_datadef('picture')
-                    video_clip['Length'].value = video_length
-                    video_clip['StartTime'].value = 0
-                    video_clip['SourceID'].value = aaf2.mobid.MobID()  # NULL source
-                    video_clip['SourceMobSlotID'].value = 0
-                    video_slot.segment = video_clip
-
-                    # Audio slot  
-                    audio_slot = tape_mob.create_timeline_slot(fps)
-                    audio_slot.slot_id = 2
-                    audio_clip = f.create.SourceClip()
-                    audio_clip['DataDefinition'].value = f.dictionary.lookup_datadef('sound')
-                    audio_clip['Length'].value = video_length
-                    audio_clip['StartTime'].value = 0
-                    audio_clip['SourceID'].value = aaf2.mobid.MobID()  # NULL source
-                    audio_clip['SourceMobSlotID'].value = 0
-                    audio_slot.segment = audio_clip
-
-                    # 2) MasterMob (mimics ALE-exported naming: filename.Exported.01)
-                    master_mob = f.create.MasterMob()
+                    tape_umid, master_umid = create_deterministic_umids(wav_path, ["tape", "master"], tape_mode=True)
+                    placement = tape_placements.get(id(entry))
+                    if placement:
+                        # MasterMob only, placed at its time_reference position on the shared tape
+                        tape_name, tape_mob_id, tape_offset = placement
+                        tape_mob = None
+                        master_mob, = prototypes.chain(
+                            ('tape_master', fps), video_length,
+                            lambda length: (self._build_tape_master_mob(f, fps, length, wav_stem, tape_mob_id),))
+                        self._retarget_mob_chain([master_mob], [master_umid], video_length)
+                        master_clip = next(iter(master_mob.slots)).segment
+                        master_clip['SourceID'].value = tape_mob_id
+                        master_clip['StartTime'].value = tape_offset
+                    else:
+                        # 1) TapeDescriptor SourceMob + 2) MasterMob, cloned from the per-shape prototype
+                        tape_name = ""
+                        tape_mob, master_mob = prototypes.chain(
+                            ('tape', fps), video_length,
+                            lambda length: self._build_multi_tape_mobs(f, fps, length, wav_stem))
+                        # Use Avid-style UMID prefix (01010f10) with tape_mode=True
+                        self._retarget_mob_chain(
+                            [tape_mob, master_mob],
+                            [tape_umid, master_umid],
+                            video_length)
+                        tape_mob.name = f"Tape_{wav_stem}"
                     master_mob.name = f"{wav_stem}.Exported.01"
-                    # Use Avid-style UMID prefix (01010f10) with tape_mode=True
-                    master_mob.mob_id = create_deterministic_umid(wav_path, "master", tape_mode=True)
-
-                    # Single audio slot referencing the tape
-                    master_slot = master_mob.create_timeline_slot(fps)
-                    master_slot.slot_id = 1
-                    master_clip = f.create.SourceClip()
-                    master_clip['DataDefinition'].value = f.dictionary.lookup_datadef('sound')
-                    master_clip['Length'].value = video_length
-                    master_clip['StartTime'].value = 0
-                    master_clip['SourceID'].value = tape_mob.mob_id
-                    master_clip['SourceMobSlotID'].value = 2  # Reference audio slot on tape
-                    master_slot.segment = master_clip
 
                     # 3) Add metadata comments to MasterMob (same as ImportDescriptor version)
-                    if bext_metadata:
-                        if bext_metadata.get('description'):
-                            master_mob.comments['BEXT_Description'] = bext_metadata['description']
-                        if bext_metadata.get('originator'):
-                            master_mob.comments['BEXT_Originator'] = bext_metadata['originator']
-                        if bext_metadata.get('originator_reference'):
-                            master_mob.comments['BEXT_Originator_Reference'] = bext_metadata['originator_reference']
-                        if bext_metadata.get('origination_date'):
-                            master_mob.comments['BEXT_Origination_Date'] = bext_metadata['origination_date']
-                        if bext_metadata.get('origination_time'):
-                            master_mob.comments['BEXT_Origination_Time'] = bext_metadata['origination_time']
-                        if bext_metadata.get('time_reference'):
-                            master_mob.comments['BEXT_Time_Reference'] = str(bext_metadata['time_reference'])
-                        if bext_metadata.get('umid'):
-                            master_mob.comments['BEXT_UMID'] = bext_metadata['umid']
-                    if info_metadata:
-                        info_mappings = {
-                            'IART': 'INFO_Artist','ICMT': 'INFO_Comment','ICOP': 'INFO_Copyright','ICRD': 'INFO_Creation_Date',
-                            'IENG': 'INFO_Engineer','IGNR': 'INFO_Genre','IKEY': 'INFO_Keywords','INAM': 'INFO_Title',
-                            'IPRD': 'INFO_Product','ISBJ': 'INFO_Subject','ISFT': 'INFO_Software','ISRC': 'INFO_Source'
-                        }
-                        for chunk_id, value in info_metadata.items():
-                            if value:
-                                master_mob.comments[info_mappings.get(chunk_id, f'INFO_{chunk_id}')] = str(value)
-                    if ucs_metadata and 'primary_category' in ucs_metadata:
-                        category = ucs_metadata['primary_category']
-                        master_mob.comments['UCS_Category'] = category.get('category','')
-                        master_mob.comments['UCS_SubCategory'] = category.get('subcategory','')
-                        master_mob.comments['UCS_ID'] = category.get('id','')
-                        master_mob.comments['UCS_Full_Name'] = category.get('full_name','')
-                        master_mob.comments['UCS_Match_Score'] = str(category.get('score',''))
-                        master_mob.comments['Category'] = category.get('category','')
-                        master_mob.comments['SubCategory'] = category.get('subcategory','')
-                        master_mob.comments['UCS ID'] = category.get('id','')
-                    if bext_metadata and bext_metadata.get('description'):
-                        master_mob.comments['Description'] = bext_metadata['description']
-                    elif info_metadata and 'INAM' in info_metadata:
-                        master_mob.comments['Description'] = str(info_metadata.get('INAM'))
-                    master_mob.comments['Name'] = str(Path(wav_metadata.get('filename','Unknown')).stem)
-                    master_mob.comments['Filename'] = str(Path(wav_metadata.get('filename','Unknown')).name)
-                    master_mob.comments['FilePath'] = str(wav_path)
-                    master_mob.comments['SampleRate'] = str(sample_rate)
-                    master_mob.comments['BitDepth'] = str(bit_depth)
-                    master_mob.comments['Channels'] = str(channels)
-                    master_mob.comments['Number of Frames'] = str(audio_frames)
-                    master_mob.comments['AudioFormat'] = 'WAV'
-                    master_mob.comments['Tracks'] = 'A1' if channels==1 else ('A1A2' if channels==2 else f"A1A{channels}")
-                    master_mob.comments['Duration'] = f"{duration_seconds:.3f}"
-                    master_mob.comments['Start'] = "00:00:00:00"
-                    master_mob.comments['End'] = "00:00:00:00"
-                    master_mob.comments['Tape'] = ""
-                    master_mob.comments['Scene'] = ""
-                    master_mob.comments['Take'] = ""
+                    for name, value in self._clip_comments(wav_metadata, bext_metadata, info_metadata,
+                                                           ucs_metadata, wav_path, tape_name).items():
+                        master_mob.comments[name] = value
 
                     # Add mobs to content (order: TapeDescriptor SourceMob, then MasterMob)
-                    f.content.mobs.append(tape_mob)
+                    if tape_mob is not None:
+                        f.content.mobs.append(tape_mob)
                     f.content.mobs.append(master_mob)
 
                 return output_path
@@ -2071,7 +3926,7 @@ class AAFGenerator:
             duration_seconds = audio_frames / sample_rate if sample_rate else 0
             video_length = int(duration_seconds * fps)
             
-            with aaf2.open(output_path, 'w') as f:
+            with self._open_aaf_for_write(output_path) as f:
                 # Set file identification (same as working ALE exports)
                 f.header['ObjectModelVersion'].value = 1
                 f.header['Version'].value = {'major': 1, 'minor': 2}
@@ -2146,15 +4001,787 @@ class AAFGenerator:
         except Exception as e:
             print(f"Error creating tape-mode AAF: {e}")
             raise
+        finally:
+            self.essence_writer.finalize(output_path)
+
+THROUGHPUT_MODEL_PATH = Path.home() / '.wavstoaaf' / 'throughput.json'
+
+
+def _format_bytes(num_bytes: float) -> str:
+    for unit in ('B', 'KB', 'MB', 'GB'):
+        if abs(num_bytes) < 1024:
+            return f"{num_bytes:.1f} {unit}" if unit != 'B' else f"{int(num_bytes)} B"
+        num_bytes /= 1024.0
+    return f"{num_bytes:.2f} TB"
+
+
+def _format_duration(seconds: float) -> str:
+    seconds = int(round(seconds))
+    hours, rem = divmod(seconds, 3600)
+    minutes, secs = divmod(rem, 60)
+    if hours:
+        return f"{hours}h {minutes:02d}m"
+    if minutes:
+        return f"{minutes}m {secs:02d}s"
+    return f"{secs}s"
+
+
+class ThroughputModel:
+    """Per-machine throughput samples recorded by --profile runs, used by --plan.
+
+    Wall time is modelled as per-file cost (by run mode) + essence bytes / essence rate
+    + converted bytes / conversion rate. Profiled samples replace the built-in defaults
+    as soon as a matching run has been recorded on this host.
+    """
+
+    MAX_SAMPLES = 50
+    DEFAULT_PER_FILE_SECONDS = {'ale': 0.002, 'linked': 0.03, 'tape': 0.03, 'embedded': 0.05, 'one_aaf': 0.01}
+    DEFAULT_ESSENCE_BYTES_PER_SEC = 150e6
+    DEFAULT_CONVERSION_BYTES_PER_SEC = 60e6
+    # AAF container/metadata bytes per output file (per clip for one_aaf)
+    DEFAULT_OVERHEAD_BYTES = {'ale': 0, 'linked': 96 * 1024, 'tape': 64 * 1024, 'embedded': 128 * 1024,
+                              'one_aaf': 8 * 1024}
+
+    def __init__(self, path: Optional[Path] = None, host: Optional[str] = None):
+        self.path = Path(path) if path else THROUGHPUT_MODEL_PATH
+        self.host = host or platform.node() or 'localhost'
+        self._data = {'hosts': {}}
+        try:
+            with open(self.path, 'r', encoding='utf-8') as f:
+                self._data = json.load(f)
+        except (OSError, ValueError):
+            pass
+        self.samples: List[Dict] = self._data.setdefault('hosts', {}).setdefault(self.host, {}).setdefault('samples', [])
+
+    def record(self, stats: Dict):
+        """Add one run's stats (mode, files, essence_bytes, converted_bytes, output_bytes, seconds)"""
+        if not stats or not stats.get('files') or stats.get('seconds', 0) <= 0:
+            return False
+        sample = {k: stats.get(k, 0) for k in ('mode', 'files', 'essence_bytes', 'converted_bytes',
+                                                'output_bytes', 'seconds')}
+        sample['recorded'] = datetime.now().isoformat(timespec='seconds')
+        self.samples.append(sample)
+        del self.samples[:-self.MAX_SAMPLES]
+        return True
+
+    def save(self):
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        tmp_path = self.path.with_suffix('.tmp')
+        with open(tmp_path, 'w', encoding='utf-8') as f:
+            json.dump(self._data, f, indent=2)
+        os.replace(tmp_path, self.path)
+
+    def _mode_samples(self, mode: str) -> List[Dict]:
+        return [s for s in self.samples if s.get('mode') == mode and s.get('files')]
+
+    def per_file_seconds(self, mode: str) -> float:
+        pure = [s for s in self._mode_samples(mode) if not s.get('essence_bytes') and not s.get('converted_bytes')]
+        if pure:
+            return sum(s['seconds'] for s in pure) / sum(s['files'] for s in pure)
+        return self.DEFAULT_PER_FILE_SECONDS.get(mode, 0.05)
+
+    def essence_bytes_per_sec(self) -> float:
+        samples = [s for s in self.samples if s.get('essence_bytes') and not s.get('converted_bytes')]
+        if not samples:
+            return self.DEFAULT_ESSENCE_BYTES_PER_SEC
+        seconds = sum(max(s['seconds'] - self.per_file_seconds(s['mode']) * s['files'], 1e-3) for s in samples)
+        return sum(s['essence_bytes'] for s in samples) / seconds
+
+    def conversion_bytes_per_sec(self) -> float:
+        samples = [s for s in self.samples if s.get('converted_bytes')]
+        if not samples:
+            return self.DEFAULT_CONVERSION_BYTES_PER_SEC
+        essence_rate = self.essence_bytes_per_sec()
+        seconds = sum(max(s['seconds'] - self.per_file_seconds(s['mode']) * s['files']
+                          - s.get('essence_bytes', 0) / essence_rate, 1e-3) for s in samples)
+        return sum(s['converted_bytes'] for s in samples) / seconds
+
+    def overhead_bytes(self, mode: str) -> float:
+        samples = [s for s in self._mode_samples(mode) if s.get('output_bytes')]
+        if samples:
+            return max(0.0, sum(s['output_bytes'] - s.get('essence_bytes', 0) for s in samples)
+                       / sum(s['files'] for s in samples))
+        return self.DEFAULT_OVERHEAD_BYTES.get(mode, 96 * 1024)
+
+    def estimate_seconds(self, mode: str, files: int, essence_bytes: int = 0, converted_bytes: int = 0) -> float:
+        seconds = files * self.per_file_seconds(mode)
+        if essence_bytes:
+            seconds += essence_bytes / self.essence_bytes_per_sec()
+        if converted_bytes:
+            seconds += converted_bytes / self.conversion_bytes_per_sec()
+        return seconds
+
+    def describe(self, mode: str) -> str:
+        count = len(self._mode_samples(mode))
+        if count:
+            return f"calibrated from {count} --profile run(s) on {self.host}"
+        return "built-in defaults; run a batch with --profile to calibrate this machine"
+
+
+OUTPUT_TARGET_KINDS = ('embedded', 'linked', 'ale')
+
+
+def parse_output_target(spec: str, base_dir: Optional[str] = None) -> Dict:
+    """Parse a --target spec 'KIND:OUTPUT[,option...]' into a target dict for process_targets.
+
+    KIND is embedded, linked or ale. Options: fps=N, link=import|pcm, tape, one-aaf, relative,
+    ale (also write batch.ale), bit-depth=16|24 and sample-rate=44100|48000|96000 (embedded only).
+    A relative OUTPUT is resolved against base_dir when given.
+    """
+    kind, sep, rest = spec.partition(':')
+    kind = kind.strip().lower()
+    output, *options = rest.split(',')
+    output = output.strip()
+    if not sep or kind not in OUTPUT_TARGET_KINDS or not output:
+        raise ValueError(f"Target must look like KIND:OUTPUT[,options] with KIND one of "
+                         f"{', '.join(OUTPUT_TARGET_KINDS)}: {spec}")
+    if base_dir and not os.path.isabs(output):
+        output = os.path.join(base_dir, output)
+    target = {'kind': kind, 'output': output, 'fps': 24.0, 'link_mode': 'import', 'tape_mode': False,
+              'one_aaf': False, 'relative_locators': False, 'emit_ale': kind == 'ale',
+              'bit_depth': None, 'sample_rate': None}
+    flags = {'tape': 'tape_mode', 'one-aaf': 'one_aaf', 'relative': 'relative_locators', 'ale': 'emit_ale'}
+    for option in options:
+        key, has_value, value = (part.strip() for part in option.partition('='))
+        key = key.lower()
+        if key in flags and not has_value:
+            target[flags[key]] = True
+        elif key == 'fps' and re.fullmatch(r'\d+(\.\d+)?', value) and float(value) > 0:
+            target['fps'] = float(value)
+        elif key == 'link' and value in ('import', 'pcm'):
+            target['link_mode'] = value
+        elif key == 'bit-depth' and value in ('16', '24'):
+            target['bit_depth'] = int(value)
+        elif key == 'sample-rate' and value in ('44100', '48000', '96000'):
+            target['sample_rate'] = int(value)
+        else:
+            raise ValueError(f"Unknown or invalid target option '{option.strip()}' in {spec}")
+    if kind != 'embedded' and (target['bit_depth'] or target['sample_rate']):
+        raise ValueError(f"bit-depth and sample-rate only apply to embedded targets: {spec}")
+    if kind == 'embedded' and target['one_aaf']:
+        raise ValueError(f"one-aaf targets are linked only: {spec}")
+    return target
+
+
+# BEXT fields as named by _parse_bext_chunk_from_data; XML chunk keys carry one of these prefixes
+BEXT_FIELDS = frozenset([
+    'description', 'originator', 'originator_reference', 'origination_date',
+    'origination_time', 'time_reference', 'version', 'umid', 'loudness_value',
+    'loudness_range', 'max_true_peak', 'max_momentary_loudness', 'max_short_term_loudness'
+])
+XML_KEY_PREFIXES = ('ebucore_', 'bwfmetaedit_', 'protools_', 'axml_', 'xml_')
+
+
+CATALOG_XML_KEYS = ('TAPE', 'SCENE', 'TAKE', 'PROJECT', 'NOTE', 'CIRCLED')
+CATALOG_ROW_GROUP = 16384
+
+
+class CatalogWriter:
+    """Typed columnar catalog (Parquet, or Arrow IPC for .arrow/.feather/.ipc) of extracted metadata.
+
+    Rows are buffered column-wise and written as one row group every row_group_size files, so
+    memory stays bounded however large the library is. The file is written next to the target
+    and moved into place on close(), so a refresh can stream rows out of the previous catalog
+    (copy_unchanged) while the new one is being written. Needs the optional pyarrow package.
+    """
+
+    def __init__(self, path, row_group_size: int = CATALOG_ROW_GROUP):
+        import pyarrow as pa
+        self.pa = pa
+        self.path = Path(path)
+        self.format = 'arrow' if self.path.suffix.lower() in ('.arrow', '.feather', '.ipc') else 'parquet'
+        self.row_group_size = max(1, int(row_group_size))
+        self.schema = self.catalog_schema(pa)
+        self.rows_written = 0
+        self._columns: Dict[str, List] = {name: [] for name in self.schema.names}
+        self._pending = 0
+        self._lock = threading.Lock()
+        self._tmp_path = self.path.with_name(self.path.name + '.tmp')
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        if self.format == 'parquet':
+            import pyarrow.parquet as pq
+            self._writer = pq.ParquetWriter(str(self._tmp_path), self.schema, compression='zstd')
+        else:
+            self._writer = pa.ipc.new_file(str(self._tmp_path), self.schema)
+
+    @classmethod
+    def catalog_schema(cls, pa):
+        fields = [
+            ('path', pa.string()), ('filename', pa.string()), ('file_size', pa.int64()),
+            ('modified', pa.timestamp('us')), ('sample_rate', pa.int32()), ('channels', pa.int16()),
+            ('bit_depth', pa.int16()), ('frames', pa.int64()), ('duration_seconds', pa.float64()),
+            ('bext_description', pa.string()), ('bext_originator', pa.string()),
+            ('bext_originator_reference', pa.string()), ('bext_origination_date', pa.string()),
+            ('bext_origination_time', pa.string()), ('bext_time_reference', pa.int64()),
+            ('bext_umid', pa.string()), ('bext_loudness_value', pa.float64()),
+            ('bext_loudness_range', pa.float64()), ('bext_max_true_peak', pa.float64()),
+            ('info', pa.map_(pa.string(), pa.string())),
+        ]
+        fields += [(f"xml_{key.lower()}", pa.string()) for key in CATALOG_XML_KEYS]
+        fields += [('ucs_id', pa.string()), ('ucs_category', pa.string()), ('ucs_subcategory', pa.string()),
+                   ('ucs_full_name', pa.string()), ('ucs_score', pa.float64())]
+        return pa.schema(fields)
+
+    @staticmethod
+    def row_for(wav_path, record: Dict, ucs_metadata: Optional[Dict]) -> Dict:
+        """One catalog row (plain Python values) from an _extract_file_record result and its UCS match"""
+        wav = record.get('wav_metadata') or {}
+        bext = record.get('bext_metadata') or {}
+        xml = record.get('xml_metadata') or {}
+        category = (ucs_metadata or {}).get('primary_category') or {}
+
+        def number(value, kind=int):
+            try:
+                return kind(value) if value is not None and value != '' else None
+            except (TypeError, ValueError):
+                return None
+
+        try:
+            modified = datetime.fromisoformat(wav['modification_time']) if wav.get('modification_time') else None
+        except ValueError:
+            modified = None
+        sample_width = number(wav.get('sample_width'))
+        row = {
+            'path': str(wav_path), 'filename': wav.get('filename') or Path(str(wav_path)).name,
+            'file_size': number(wav.get('file_size')), 'modified': modified,
+            'sample_rate': number(wav.get('sample_rate')), 'channels': number(wav.get('channels')),
+            'bit_depth': sample_width * 8 if sample_width else None, 'frames': number(wav.get('frames')),
+            'duration_seconds': number(wav.get('duration_seconds'), float),
+            'bext_description': bext.get('description') or None, 'bext_originator': bext.get('originator') or None,
+            'bext_originator_reference': bext.get('originator_reference') or None,
+            'bext_origination_date': bext.get('origination_date') or None,
+            'bext_origination_time': bext.get('origination_time') or None,
+            'bext_time_reference': number(bext.get('time_reference')), 'bext_umid': bext.get('umid') or None,
+            'bext_loudness_value': number(bext.get('loudness_value'), float),
+            'bext_loudness_range': number(bext.get('loudness_range'), float),
+            'bext_max_true_peak': number(bext.get('max_true_peak'), float),
+            'info': sorted((str(k), str(v)) for k, v in (record.get('info_metadata') or {}).items() if v),
+            'ucs_id': category.get('id') or None, 'ucs_category': category.get('category') or None,
+            'ucs_subcategory': category.get('subcategory') or None,
+            'ucs_full_name': category.get('full_name') or None,
+            'ucs_score': number(category.get('score'), float),
+        }
+        for key in CATALOG_XML_KEYS:
+            row[f"xml_{key.lower()}"] = next((str(v) for k, v in xml.items()
+                                              if k.split('_')[-1].upper() == key and str(v).strip()), None)
+        return row
+
+    def add(self, wav_path, record: Dict, ucs_metadata: Optional[Dict]):
+        row = self.row_for(wav_path, record, ucs_metadata)
+        with self._lock:
+            for name, values in self._columns.items():
+                values.append(row[name])
+            self._pending += 1
+            if self._pending >= self.row_group_size:
+                self._flush()
+
+    def _flush(self):
+        if not self._pending:
+            return
+        table = self.pa.Table.from_pydict(self._columns, schema=self.schema)
+        self._write_table(table)
+        self._columns = {name: [] for name in self.schema.names}
+        self._pending = 0
+
+    def _write_table(self, table):
+        if self.format == 'parquet':
+            self._writer.write_table(table, row_group_size=self.row_group_size)
+        else:
+            self._writer.write_table(table, max_chunksize=self.row_group_size)
+        self.rows_written += table.num_rows
+
+    def _previous_batches(self):
+        """Record batches of the catalog being replaced (nothing if missing or of another schema)"""
+        if not self.path.exists():
+            return
+        try:
+            if self.format == 'parquet':
+                import pyarrow.parquet as pq
+                source = pq.ParquetFile(str(self.path))
+                if not source.schema_arrow.equals(self.schema):
+                    return
+                yield from source.iter_batches(batch_size=self.row_group_size)
+            else:
+                with self.pa.memory_map(str(self.path)) as stream:
+                    source = self.pa.ipc.open_file(stream)
+                    if not source.schema.equals(self.schema):
+                        return
+                    for i in range(source.num_record_batches):
+                        yield source.get_batch(i)
+        except Exception as e:
+            print(f"  Previous catalog {self.path.name} unreadable, rebuilding it: {e}")
+
+    def copy_unchanged(self, current: Dict[str, Tuple[int, datetime]]) -> set:
+        """Copy rows of the previous catalog whose file still exists with the same size and mtime.
+
+        current maps path → (file_size, modified). Rows are streamed batch by batch; returns the
+        set of paths whose rows were reused (those files need not be read again).
+        """
+        reused = set()
+        with self._lock:
+            self._flush()
+            for batch in self._previous_batches():
+                paths = batch.column('path').to_pylist()
+                sizes = batch.column('file_size').to_pylist()
+                modified = batch.column('modified').to_pylist()
+                keep = [current.get(p) == (s, m) and p not in reused for p, s, m in zip(paths, sizes, modified)]
+                if any(keep):
+                    self._write_table(self.pa.Table.from_batches([batch.filter(self.pa.array(keep))]))
+                    reused.update(p for p, k in zip(paths, keep) if k)
+        return reused
+
+    def close(self):
+        with self._lock:
+            self._flush()
+            self._writer.close()
+            os.replace(self._tmp_path, self.path)
+
+    def abort(self):
+        try:
+            self._writer.close()
+        finally:
+            try:
+                os.unlink(self._tmp_path)
+            except OSError:
+                pass
+
+
+class DeliveryPackage:
+    """Tar or zip64 delivery archive that finished outputs are streamed into while a batch runs.
+
+    add() copies each AAF, ALE or report into the archive as soon as it is written and hashes it
+    (SHA-256) in the same read, right after the write (usually from the page cache), instead of
+    archiving the output tree in a second pass. close() appends index.json (name, size, modified,
+    sha256 per member) and SHA256SUMS (sha256sum -c format) and moves the archive into place; with
+    remove_added the archived loose files are deleted then, so abort() never loses an output.
+    A second file under a name already in the archive is refused (ValueError). Callers record
+    outputs that could not be added in `failed`. Members are stored: embedded PCM doesn't
+    compress, and stored members can be read in place again (see process_archive).
+    """
+
+    FORMATS = {'.zip': 'zip', '.tar': 'tar'}
+    COPY_BLOCK = 4 * 1024 * 1024
+
+    class _HashingReader:
+        """File wrapper hashing what tarfile reads through it"""
+
+        def __init__(self, src, digest):
+            self.src, self.digest = src, digest
+
+        def read(self, size: int = -1) -> bytes:
+            data = self.src.read(size)
+            self.digest.update(data)
+            return data
+
+    def __init__(self, path, remove_added: bool = False):
+        self.path = Path(path)
+        self.format = self.FORMATS.get(self.path.suffix.lower())
+        if self.format is None:
+            raise ValueError(f"delivery package must be .zip or .tar: {self.path.name}")
+        self.remove_added = remove_added
+        self.entries: List[Dict] = []
+        self.bytes_added = 0
+        self.failed: List[Tuple[str, str]] = []
+        self._names = set()
+        self._added_paths: List[Path] = []
+        self._lock = threading.Lock()
+        self._tmp_path = self.path.with_name(self.path.name + '.tmp')
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        if self.format == 'zip':
+            self._archive = zipfile.ZipFile(self._tmp_path, 'w', compression=zipfile.ZIP_STORED, allowZip64=True)
+        else:
+            self._archive = tarfile.open(self._tmp_path, 'w', format=tarfile.PAX_FORMAT)
+            self._archive.copybufsize = self.COPY_BLOCK
+
+    def _copy(self, src, dst, digest):
+        buf = bytearray(self.COPY_BLOCK)
+        view = memoryview(buf)
+        while True:
+            n = src.readinto(buf)
+            if not n:
+                break
+            digest.update(view[:n])
+            dst.write(view[:n])
+
+    def _add_member(self, name: str, src, size: int, mtime: float) -> str:
+        digest = hashlib.sha256()
+        if self.format == 'zip':
+            info = zipfile.ZipInfo(name, time.localtime(max(mtime, 315532800))[:6])
+            info.compress_type = zipfile.ZIP_STORED
+            info.file_size = size
+            with self._archive.open(info, 'w', force_zip64=size >= 0x7FFFFFFF) as dst:
+                self._copy(src, dst, digest)
+        else:
+            info = tarfile.TarInfo(name)
+            info.size, info.mtime = size, int(mtime)
+            self._archive.addfile(info, self._HashingReader(src, digest))
+        return digest.hexdigest()
+
+    def add(self, path, arcname: Optional[str] = None):
+        """Stream one finished output file into the archive (no-op for missing files)"""
+        path = Path(path)
+        name = (arcname or path.name).replace(os.sep, '/')
+        with self._lock:
+            if not path.is_file():
+                return
+            if name in self._names:
+                raise ValueError(f"{name} is already in {self.path.name}")
+            st = path.stat()
+            with open(path, 'rb', buffering=0) as src:
+                sha256 = self._add_member(name, src, st.st_size, st.st_mtime)
+            self._names.add(name)
+            self._added_paths.append(path)
+            self.bytes_added += st.st_size
+            self.entries.append({'name': name, 'size': st.st_size,
+                                 'modified': datetime.fromtimestamp(st.st_mtime).isoformat(timespec='seconds'),
+                                 'sha256': sha256})
+
+    def _add_bytes(self, name: str, data: bytes):
+        self._add_member(name, io.BytesIO(data), len(data), time.time())
+
+    def close(self):
+        with self._lock:
+            index = {'created': datetime.now().isoformat(timespec='seconds'),
+                     'generator': f"WAVsToAAF {__version__}", 'files': self.entries}
+            self._add_bytes('index.json', (json.dumps(index, indent=2) + '\n').encode('utf-8'))
+            self._add_bytes('SHA256SUMS', ''.join(f"{e['sha256']}  {e['name']}\n"
+                                                  for e in self.entries).encode('utf-8'))
+            self._archive.close()
+            os.replace(self._tmp_path, self.path)
+        if self.remove_added:
+            for path in self._added_paths:
+                try:
+                    path.unlink()
+                except OSError as e:
+                    print(f"  Could not remove {path} after packaging: {e}")
+
+    def abort(self):
+        try:
+            self._archive.close()
+        finally:
+            try:
+                os.unlink(self._tmp_path)
+            except OSError:
+                pass
+
+
+def _run_mode_key(embed_audio: bool, one_aaf: bool, tape_mode: bool, ale_only: bool) -> str:
+    """Throughput model key for a process_directory run"""
+    if ale_only:
+        return 'ale'
+    if one_aaf:
+        return 'one_aaf'
+    if tape_mode:
+        return 'tape'
+    return 'embedded' if embed_audio else 'linked'
+
+
+class SyncGroupIndex:
+    """Group recordings that overlap in time (multi-recorder / multicam shoots) into sync groups.
+
+    Each recording is an interval [time_reference, time_reference + duration) on its recording
+    day (BEXT origination date), kept in microseconds so files at different sample rates compare
+    exactly. add() is called during the header pass; assign() sorts each day's intervals once
+    and sweeps them, starting a new group whenever an interval begins more than gap_seconds after
+    the furthest end seen so far: O(n log n) instead of comparing every pair of files.
+    Files with no BEXT time reference (0) are not grouped.
+    """
+
+    def __init__(self, gap_seconds: float = 0.0):
+        self.gap = int(gap_seconds * 1_000_000)
+        self._days: Dict[str, List[Tuple[int, int, int, Any]]] = {}
+        self._count = 0
+
+    @staticmethod
+    def recording_interval(wav_metadata: Dict, bext_metadata: Dict) -> Optional[Tuple[str, int, int]]:
+        """(day, start_us, end_us) of one recording, or None if it carries no time reference"""
+        time_reference = int((bext_metadata or {}).get('time_reference') or 0)
+        sample_rate = int((wav_metadata or {}).get('sample_rate') or 0)
+        if time_reference <= 0 or sample_rate <= 0:
+            return None
+        day = re.sub(r'[^0-9]', '', str((bext_metadata or {}).get('origination_date') or ''))[:8]
+        start = time_reference * 1_000_000 // sample_rate
+        end = start + int(wav_metadata.get('frames', 0)) * 1_000_000 // sample_rate
+        return day, start, end
+
+    def add(self, item: Any, wav_metadata: Dict, bext_metadata: Dict) -> bool:
+        interval = self.recording_interval(wav_metadata, bext_metadata)
+        if interval is None:
+            return False
+        day, start, end = interval
+        # Insertion order breaks ties so equal starts stay stable and items are never compared
+        self._days.setdefault(day, []).append((start, end, self._count, item))
+        self._count += 1
+        return True
+
+    def assign(self) -> List[Tuple[Any, str]]:
+        """[(item, group_id)] in day/time order; IDs look like SG20240501-0003 (SG-0003 when undated)"""
+        result = []
+        for day in sorted(self._days):
+            intervals = sorted(self._days[day], key=lambda iv: (iv[0], iv[2]))
+            group, group_end = 0, None
+            for start, end, _, item in intervals:
+                if group_end is None or start > group_end + self.gap:
+                    group += 1
+                    group_end = end
+                else:
+                    group_end = max(group_end, end)
+                result.append((item, f"SG{day}-{group:04d}"))
+        return result
+
 
 class WAVsToAAFProcessor:
     """Main processor class for converting WAV files to AAF format"""
     
+    # Files read (and fuzzy-UCS batch-scored) per step of a multi-target run
+    TARGET_BATCH = 256
+
     def __init__(self):
         self.extractor = WAVMetadataExtractor()
         self.generator = AAFGenerator()
         self.ucs_processor = UCSProcessor()
+        # Stats of the last process_directory run (consumed by --profile)
+        self.last_run_stats: Dict = {}
+        # Emit a subclip per cue/adtl region or iXML sync-point region (see --subclips)
+        self.subclips = False
+        # Optional MemoryGovernor admitting per-clip work by estimated peak memory (see --memory-budget)
+        self.memory_governor: Optional[MemoryGovernor] = None
+        # Optional CatalogWriter: process_directory adds a row per extracted file (see --catalog)
+        self.catalog: Optional[CatalogWriter] = None
+        # Assign sync-group IDs to time-overlapping recordings in one-AAF / ALE-only runs (see --sync-groups)
+        self.sync_groups = False
+        self.sync_gap_seconds = 0.0
+        # One-AAF runs write only clips new or changed since batch_manifest.json (see --delta)
+        self.delta = False
+        # Optional DeliveryPackage: process_directory streams each finished output into it (see --package)
+        self.package: Optional[DeliveryPackage] = None
+        # Growing-file ingest: seconds without growth that end an unpatched recording, and poll period
+        self.follow_settle_seconds = 5.0
+        self.follow_poll_interval = 0.25
     
+    def _attach_regions(self, wav_metadata: Dict, wav_file, bext_metadata: Dict):
+        """Store the source file's marker regions in wav_metadata['regions'] when subclips are enabled"""
+        if not self.subclips or not wav_metadata:
+            return
+        try:
+            regions = self.extractor.extract_regions(str(wav_file), bext_metadata.get('time_reference') or 0)
+        except Exception as e:
+            print(f"  Could not read markers from {Path(wav_file).name}: {e}")
+            return
+        if regions:
+            wav_metadata['regions'] = regions
+            print(f"  {len(regions)} marker region(s) → subclips")
+
+    def _clip_memory_cost(self, wav_file: Path, embed_audio: bool) -> int:
+        """Governor estimate for writing one per-clip AAF (header read only)"""
+        try:
+            header = self.extractor.chunk_header(str(wav_file)) if embed_audio else {}
+        except OSError:
+            header = {}
+        return self.memory_governor.estimate(
+            header, embed_audio, block_size=self.generator.essence_writer.block_size,
+            sector_size=self.generator.sector_size or aaf_open_sector_size_default() or 512,
+            interleaved=self.generator.interleaved_embed)
+
+    @staticmethod
+    def _split_metadata_chunks(all_chunks: Dict) -> Tuple[Dict, Dict, Dict]:
+        """Split extract_all_metadata_chunks output into (bext, info, xml) dicts; INFO is everything else"""
+        bext_metadata = {k: v for k, v in all_chunks.items() if k in BEXT_FIELDS}
+        xml_metadata = {k: v for k, v in all_chunks.items() if k.startswith(XML_KEY_PREFIXES)}
+        info_metadata = {k: v for k, v in all_chunks.items() if k not in bext_metadata and k not in xml_metadata}
+        return bext_metadata, info_metadata, xml_metadata
+
+    def _extract_file_record(self, wav_file, basic_path=None) -> Optional[Dict]:
+        """Read one WAV's basic info and metadata chunks into the dicts the AAF writers take.
+
+        basic_path is a converted copy whose format fields replace the source's (chunks are always
+        read from wav_file). UCS is left to the caller. Returns None if the WAV can't be read.
+        """
+        wav_file = Path(wav_file)
+        wav_metadata = self.extractor.extract_basic_info(str(basic_path or wav_file))
+        if not wav_metadata:
+            return None
+        if basic_path is not None and Path(basic_path) != wav_file:
+            wav_metadata.update(filename=wav_file.name, filepath=str(basic_path), source_filepath=str(wav_file))
+        bext_metadata, info_metadata, xml_metadata = self._split_metadata_chunks(
+            self.extractor.extract_all_metadata_chunks(str(wav_file)))
+        self._attach_regions(wav_metadata, wav_file, bext_metadata)
+        return {
+            'wav_metadata': wav_metadata,
+            'bext_metadata': bext_metadata,
+            'info_metadata': info_metadata,
+            'xml_metadata': xml_metadata,
+        }
+
+    def _header_basic_info(self, source) -> Dict:
+        """Channels/rate/frames of a WAV path or ArchiveMember from its RIFF header alone ({} if unreadable)"""
+        try:
+            header = self.extractor.chunk_header(source)
+        except OSError:
+            return {}
+        name = getattr(source, 'name', None) or str(source)
+        return self.extractor.basic_info_from_header(header, Path(name).name, str(source)) if header else {}
+
+    @staticmethod
+    def _ale_row(wav_path: Path, wav_meta: Dict) -> Optional[Dict[str, str]]:
+        """One batch.ale row for a clip (None if its basic info is unusable)"""
+        try:
+            ch = int(wav_meta.get('channels', 1))
+            sr = int(wav_meta.get('sample_rate', 48000))
+            frames = int(wav_meta.get('frames', 0))
+            dur = (frames / sr) if sr else 0.0
+            audio_rate = '48kHz' if sr == 48000 else (f"{sr/1000:g}kHz")
+            return {
+                'Name': wav_path.stem,
+                'Tracks': ('A1' if ch==1 else ('A1A2' if ch==2 else f"A1A{ch}")),
+                'Start': '',
+                'End': '',
+                'Tape': '',
+                'Source File': wav_path.name,
+                'AudioRate': audio_rate,
+                'SampleRate': f"{sr}Hz",
+                'Channels': str(ch),
+                'Duration': f"{dur:.3f}",
+            }
+        except Exception:
+            return None
+
+    def _low_confidence_item(self, filename: str, description: str, ucs_metadata: Dict) -> Optional[Dict]:
+        """Report row for a fuzzy UCS match scoring under the low-confidence threshold, else None"""
+        try:
+            if ucs_metadata and 'primary_category' in ucs_metadata:
+                score = float(ucs_metadata['primary_category'].get('score', 0.0))
+                if 0 < score < getattr(self, '_ucs_min_score', 25.0):
+                    return {
+                        'file': filename,
+                        'description': description,
+                        'ucs_id': ucs_metadata['primary_category'].get('id',''),
+                        'category': ucs_metadata['primary_category'].get('category',''),
+                        'subcategory': ucs_metadata['primary_category'].get('subcategory',''),
+                        'score': score,
+                    }
+        except Exception:
+            pass
+        return None
+
+    @staticmethod
+    def _write_ale(ale_path: Path, ale_rows: List[Dict[str, str]], fps: float):
+        try:
+            with open(ale_path, 'w', encoding='utf-8') as f:
+                f.write('Heading\n')
+                f.write('FIELD_DELIM\tTABS\n')
+                f.write('VIDEO_FORMAT\t1080\n')
+                f.write('AUDIO_FORMAT\t48kHz\n')
+                f.write(f'FPS\t{int(fps)}\n')
+                f.write('\nColumn\n')
+                cols = ['Name','Tracks','Start','End','Tape','Source File','AudioRate','SampleRate','Channels','Duration']
+                if any(r.get('SyncGroup') for r in ale_rows):
+                    cols.append('SyncGroup')
+                f.write('\t'.join(cols)+'\n')
+                f.write('Data\n')
+                for r in ale_rows:
+                    f.write('\t'.join(r.get(c,'') for c in cols)+'\n')
+            print(f"  Wrote ALE: {ale_path}")
+        except Exception as e:
+            print(f"  Failed to write ALE: {e}")
+
+    @staticmethod
+    def _write_low_confidence_report(report_path: Path, items: List[Dict]):
+        try:
+            import csv
+            with open(report_path, 'w', newline='', encoding='utf-8') as rf:
+                writer = csv.DictWriter(rf, fieldnames=['file','description','ucs_id','category','subcategory','score'])
+                writer.writeheader()
+                for row in items:
+                    writer.writerow(row)
+            print(f"  Wrote UCS low-confidence report: {report_path}")
+        except Exception as e:
+            print(f"  Failed to write UCS low-confidence report: {e}")
+
+    BATCH_MANIFEST = 'batch_manifest.json'
+
+    @staticmethod
+    def _manifest_key(wav_file: Path, input_path: Path) -> str:
+        """Manifest key of a clip: its path relative to the input directory, with '/' separators,
+        so a library that is moved, remounted or read from another machine keeps its keys"""
+        try:
+            return wav_file.relative_to(input_path).as_posix()
+        except ValueError:
+            return str(wav_file.resolve())
+
+    @staticmethod
+    def _manifest_clip(wav_file: Path, tape_mode: bool) -> Dict:
+        """Manifest record of one clip: the size and whole-second mtime its deterministic UMIDs
+        are derived from, plus the resulting MasterMob ID"""
+        st = wav_file.stat()
+        return {
+            'name': wav_file.name,
+            'size': st.st_size,
+            'mtime': int(st.st_mtime),
+            'master_mob_id': umid_urn(deterministic_umid_bytes(wav_file, "master", tape_mode)),
+        }
+
+    @staticmethod
+    def _load_batch_manifest(manifest_file: Path, tape_mode: bool, input_path: Path) -> Dict[str, Dict]:
+        """Clips of the previous one-AAF run ({} if there is none or it was built in the other mode).
+
+        Version 1 manifests were keyed by absolute path; their keys are made relative to input_path.
+        """
+        if not manifest_file.exists():
+            print(f"  No {manifest_file.name} from a previous run: every clip is new")
+            return {}
+        try:
+            manifest = json.loads(manifest_file.read_text(encoding='utf-8'))
+        except (OSError, ValueError) as e:
+            print(f"  Warning: Could not read {manifest_file}: {e}; every clip is treated as new")
+            return {}
+        if bool(manifest.get('tape_mode')) != bool(tape_mode):
+            print(f"  Previous run used {'tape' if manifest.get('tape_mode') else 'linked'} mode: every clip is new")
+            return {}
+        clips = manifest.get('clips', {})
+        if manifest.get('version', 1) < 2:
+            root = input_path.resolve()
+            clips = {WAVsToAAFProcessor._manifest_key(Path(key), root): clip for key, clip in clips.items()}
+        return clips
+
+    @staticmethod
+    def _write_batch_manifest(manifest_file: Path, clips: Dict[str, Dict], tape_mode: bool, aaf_name: str):
+        manifest = {'version': 2, 'created': datetime.now().isoformat(timespec='seconds'),
+                    'tape_mode': bool(tape_mode), 'aaf': aaf_name, 'clips': clips}
+        tmp = manifest_file.with_name(manifest_file.name + '.tmp')
+        try:
+            tmp.write_text(json.dumps(manifest, indent=1, sort_keys=True), encoding='utf-8')
+            os.replace(tmp, manifest_file)
+        except OSError as e:
+            print(f"  Failed to write {manifest_file.name}: {e}")
+
+    @staticmethod
+    def _write_delta_removed(report_path: Path, rows: List[Dict]):
+        """Clips to take out of the bin: removed WAVs, and the superseded clips of changed ones"""
+        try:
+            with open(report_path, 'w', newline='', encoding='utf-8') as rf:
+                writer = csv.DictWriter(rf, fieldnames=['name', 'path', 'master_mob_id', 'reason'])
+                writer.writeheader()
+                for row in rows:
+                    writer.writerow(row)
+            print(f"  Wrote removed-clip list: {report_path.name} ({len(rows)} clip(s))")
+        except Exception as e:
+            print(f"  Failed to write removed-clip list: {e}")
+
+    def _deliver(self, path: Path, root: Path):
+        """Add a finished output to the delivery package (if any), named relative to root"""
+        if self.package is None:
+            return
+        try:
+            arcname = str(Path(path).relative_to(root))
+        except ValueError:
+            arcname = Path(path).name
+        try:
+            self.package.add(path, arcname)
+        except Exception as e:
+            print(f"  Error adding {Path(path).name} to {self.package.path.name}: {e}")
+            self.package.failed.append((arcname, str(e)))
+
     def _prepare_audio_source(self, wav_file: Path, target_sample_rate: Optional[int] = None,
                               target_bit_depth: Optional[int] = None) -> Tuple[Path, Optional[str]]:
         """Return a WAV file path matching requested sample rate/bit depth, converting if needed."""
@@ -2193,13 +4820,166 @@ class WAVsToAAFProcessor:
 
         return Path(tmp_file.name), tmp_file.name
 
+    def discover_wav_files(self, input_path: Path) -> List[Path]:
+        """Find WAV files below input_path (deduplicate case-insensitive matches)"""
+        wav_files = []
+        for ext in self.extractor.supported_formats:
+            wav_files.extend(input_path.glob(f"**/*{ext}"))
+            wav_files.extend(input_path.glob(f"**/*{ext.upper()}"))
+        # Deduplicate while preserving order
+        seen = set()
+        unique_wavs = []
+        for p in wav_files:
+            try:
+                key = str(p.resolve())
+            except Exception:
+                key = str(p)
+            if key not in seen:
+                seen.add(key)
+                unique_wavs.append(p)
+        return unique_wavs
+
+    def _per_clip_output_file(self, wav_file: Path, input_path: Path, output_path: Path, near_sources: bool) -> Path:
+        """Where the per-clip AAF for wav_file goes (next to the source, or mirrored under output_path)"""
+        output_filename = wav_file.stem + '.aaf'
+        if near_sources:
+            return wav_file.parent / output_filename
+        try:
+            return output_path / wav_file.parent.relative_to(input_path) / output_filename
+        except ValueError:
+            return output_path / output_filename
+
+    def _is_up_to_date(self, wav_file: Path, out_file: Path) -> bool:
+        """True if out_file exists and is at least as new as its source WAV"""
+        try:
+            return out_file.stat().st_mtime >= wav_file.stat().st_mtime
+        except OSError:
+            return False
+
+    def plan_directory(self, input_dir: str, output_dir: Optional[str], embed_audio: bool = False,
+                       one_aaf: bool = False, near_sources: bool = False, tape_mode: bool = False,
+                       bit_depth: Optional[int] = None, sample_rate: Optional[int] = None,
+                       ale_only: bool = False, skip_up_to_date: bool = False,
+                       model: Optional[ThroughputModel] = None) -> Dict:
+        """Dry run: read WAV headers only and report what a batch would do, write and take.
+
+        Mirrors the mode decisions of process_directory. Nothing is written.
+        """
+        input_path = Path(input_dir)
+        if not input_path.exists():
+            print(f"Error: Input '{input_dir}' does not exist")
+            return {}
+        output_path = Path(output_dir) if output_dir else input_path.parent / 'AAFs'
+
+        if ale_only:
+            one_aaf = False
+            bit_depth = sample_rate = None
+        if one_aaf and embed_audio:
+            print("Note: multi-clip AAFs are linked only; planning one embedded AAF per clip instead.")
+            one_aaf = False
+        if not embed_audio or tape_mode:
+            bit_depth = sample_rate = None
+        mode = _run_mode_key(embed_audio, one_aaf, tape_mode, ale_only)
+        model = model or ThroughputModel()
+
+        discover_start = time.perf_counter()
+        wav_files = [input_path] if input_path.is_file() else self.discover_wav_files(input_path)
+        discovery_seconds = time.perf_counter() - discover_start
+
+        actions: Dict[str, int] = {}
+        source_bytes = essence_bytes = converted_bytes = 0
+        files_to_write = 0
+        for wav_file in wav_files:
+            try:
+                header = self.extractor.chunk_header(str(wav_file))
+            except OSError:
+                header = {}
+            if not header or not header.get('block_align'):
+                action = 'unreadable'
+            elif ale_only:
+                action = 'metadata only'
+            elif (skip_up_to_date and not one_aaf and
+                  self._is_up_to_date(wav_file, self._per_clip_output_file(wav_file, input_path, output_path, near_sources))):
+                action = 'up to date'
+            elif tape_mode:
+                action = 'tape (no essence)'
+            elif not embed_audio:
+                action = 'linked'
+            else:
+                src_rate = header.get('sample_rate') or 48000
+                src_width = max(1, (header.get('bits_per_sample') or 16) // 8)
+                out_rate = sample_rate or src_rate
+                out_width = (bit_depth // 8) if bit_depth else src_width
+                # extract_basic_info falls back to ffmpeg for anything the wave module can't read
+                needs_conversion = (header.get('audio_format') != 1 or out_rate != src_rate or out_width != src_width)
+                action = 'needs conversion' if needs_conversion else 'embedded'
+                frames = header['frames'] * out_rate // src_rate
+                essence_bytes += frames * header.get('channels', 1) * out_width
+                if needs_conversion:
+                    converted_bytes += header['file_size']
+            actions[action] = actions.get(action, 0) + 1
+            if action not in ('unreadable', 'up to date'):
+                files_to_write += 1
+                source_bytes += header.get('file_size', 0)
+
+        if mode == 'ale':
+            output_files = 1 if files_to_write else 0
+            output_bytes = 0
+        elif mode == 'one_aaf':
+            output_files = 1 if files_to_write else 0
+            output_bytes = int(ThroughputModel.DEFAULT_OVERHEAD_BYTES['linked'] + files_to_write * model.overhead_bytes(mode))
+        else:
+            output_files = files_to_write
+            output_bytes = int(files_to_write * model.overhead_bytes(mode) + essence_bytes)
+        plan = {
+            'input': str(input_path),
+            'output': str(output_path),
+            'mode': mode,
+            'files': len(wav_files),
+            'actions': actions,
+            'source_bytes': source_bytes,
+            'essence_bytes': essence_bytes,
+            'converted_bytes': converted_bytes,
+            'output_files': output_files,
+            'output_bytes': output_bytes,
+            'estimated_seconds': model.estimate_seconds(mode, files_to_write, essence_bytes, converted_bytes),
+            'discovery_seconds': discovery_seconds,
+            'model': model.describe(mode),
+        }
+
+        print(f"Plan for {plan['files']} WAV file(s) in {input_path} (mode: {mode})")
+        print("  Files per action:")
+        for action in ('embedded', 'needs conversion', 'linked', 'tape (no essence)', 'metadata only',
+                       'up to date', 'unreadable'):
+            if actions.get(action):
+                print(f"    {action:<20}{actions[action]:>8}")
+        print(f"  Source audio:       {_format_bytes(source_bytes)}")
+        print(f"  Essence to write:   {_format_bytes(essence_bytes)}")
+        if converted_bytes:
+            print(f"  To convert (ffmpeg): {_format_bytes(converted_bytes)}")
+        print(f"  Est. output size:   {_format_bytes(output_bytes)} in {output_files} {'ALE' if mode == 'ale' else 'AAF'} file(s) -> {output_path}")
+        print(f"  Est. wall time:     {_format_duration(plan['estimated_seconds'])} "
+              f"(+{_format_duration(discovery_seconds)} discovery)")
+        print(f"  Throughput model:   {plan['model']}")
+        return plan
+
     def process_directory(self, input_dir: str, output_dir: str, fps: float = 24, embed_audio: bool = False,
                           link_mode: str = 'import', emit_ale: bool = False, one_aaf: bool = False,
                           near_sources: bool = False, tape_mode: bool = False, relative_locators: bool = False,
                           bit_depth: Optional[int] = None, sample_rate: Optional[int] = None,
                           skip_log_path: Optional[str] = None, auto_skip_log: bool = False,
-                          allow_ucs_guess: bool = True, cancel_event: Optional[Any] = None) -> int:
-        """Process all WAV files in a directory"""
+                          allow_ucs_guess: bool = True, cancel_event: Optional[Any] = None,
+                          ale_only: bool = False, pause_event: Optional[Any] = None,
+                          progress_callback: Optional[Callable[[int, int], None]] = None,
+                          skip_up_to_date: bool = False, workers: int = 1) -> int:
+        """Process all WAV files in a directory
+
+        With ale_only=True, metadata is extracted and batch.ale is written but no AAFs are created.
+        pause_event (while set) holds the batch between files; progress_callback(done, total)
+        is called after each file. skip_up_to_date leaves per-clip AAFs that are newer than
+        their WAV alone. workers > 1 writes per-clip AAFs on that many threads, admitted by
+        self.memory_governor when one is set.
+        """
         input_path = Path(input_dir)
         
         # Determine the base output directory
@@ -2220,23 +5000,7 @@ class WAVsToAAFProcessor:
         # Create output directory
         output_path.mkdir(parents=True, exist_ok=True)
 
-        # Find WAV files (deduplicate case-insensitive matches)
-        wav_files = []
-        for ext in self.extractor.supported_formats:
-            wav_files.extend(input_path.glob(f"**/*{ext}"))
-            wav_files.extend(input_path.glob(f"**/*{ext.upper()}"))
-        # Deduplicate while preserving order
-        seen = set()
-        unique_wavs = []
-        for p in wav_files:
-            try:
-                key = str(p.resolve())
-            except Exception:
-                key = str(p)
-            if key not in seen:
-                seen.add(key)
-                unique_wavs.append(p)
-        wav_files = unique_wavs
+        wav_files = self.discover_wav_files(input_path)
 
         if not wav_files:
             print(f"No WAV files found in '{input_dir}'")
@@ -2247,31 +5011,72 @@ class WAVsToAAFProcessor:
         # Prepare ALE rows (optional)
         ale_rows: List[Dict[str, str]] = []
 
-        def add_ale_row_from_wavmeta(wav_path: Path, wav_meta: Dict):
-            try:
-                ch = int(wav_meta.get('channels', 1))
-                sr = int(wav_meta.get('sample_rate', 48000))
-                frames = int(wav_meta.get('frames', 0))
-                dur = (frames / sr) if sr else 0.0
-                name = wav_path.stem
-                audio_rate = '48kHz' if sr == 48000 else (f"{sr/1000:g}kHz")
-                ale_rows.append({
-                    'Name': name,
-                    'Tracks': ('A1' if ch==1 else ('A1A2' if ch==2 else f"A1A{ch}")),
-                    'Start': '',
-                    'End': '',
-                    'Tape': '',
-                    'Source File': wav_path.name,
-                    'AudioRate': audio_rate,
-                    'SampleRate': f"{sr}Hz",
-                    'Channels': str(ch),
-                    'Duration': f"{dur:.3f}",
-                })
-            except Exception:
-                pass
+        # Sync groups need every header first, so they are assigned once the header pass is done
+        sync_index = SyncGroupIndex(self.sync_gap_seconds) if self.sync_groups and (one_aaf or ale_only) else None
+
+        def add_ale_row_from_wavmeta(wav_path: Path, wav_meta: Dict, bext_meta: Optional[Dict] = None):
+            row = self._ale_row(wav_path, wav_meta)
+            if row:
+                ale_rows.append(row)
+            if sync_index is not None and bext_meta is not None:
+                with tally_lock:
+                    sync_index.add((wav_meta, row), wav_meta, bext_meta)
+
+        def assign_sync_groups() -> List:
+            if sync_index is None:
+                return []
+            groups = sync_index.assign()
+            for (wav_meta, row), group_id in groups:
+                wav_meta['sync_group'] = group_id
+                if row:
+                    row['SyncGroup'] = group_id
+            print(f"  Sync groups: {len(set(g for _, g in groups))} group(s) across {len(groups)} timed file(s)")
+            return groups
 
         processed = 0
+        tally_lock = threading.Lock()  # guards processed/skipped/run_stats when clips run on threads
         low_confidence_items = []  # collect low-confidence UCS matches for reporting
+        total_files = len(wav_files)
+        # Fuzzy UCS guesses that don't go into a per-clip AAF are scored in one batch after extraction
+        deferred_ucs: List[Tuple[Dict, str, str]] = []
+
+        def note_low_confidence(filename: str, description: str, ucs_metadata: Dict):
+            if allow_ucs_guess:
+                item = self._low_confidence_item(filename, description, ucs_metadata)
+                if item:
+                    low_confidence_items.append(item)
+
+        def resolve_deferred_ucs():
+            if not deferred_ucs:
+                return
+            results = self.ucs_processor.categorize_batch([(name, desc) for _, name, desc in deferred_ucs])
+            for (entry, name, desc), result in zip(deferred_ucs, results):
+                entry['ucs_metadata'] = result
+                note_low_confidence(name, desc, result)
+                if self.catalog is not None and 'catalog_path' in entry:
+                    self.catalog.add(entry['catalog_path'], entry, result)
+            deferred_ucs.clear()
+
+        def wait_while_paused():
+            while pause_event is not None and pause_event.is_set():
+                if cancel_event and cancel_event.is_set():
+                    return
+                time.sleep(0.2)
+
+        def report_progress(done: int):
+            if progress_callback:
+                try:
+                    progress_callback(done, total_files)
+                except Exception:
+                    pass
+
+        if ale_only:
+            # ALE-only runs never write AAFs, so the multi-clip and conversion paths don't apply
+            emit_ale = True
+            one_aaf = False
+            bit_depth = None
+            sample_rate = None
+
         if one_aaf:
             # Check if embedded mode is requested for multi-clip AAF
             if embed_audio:
@@ -2284,86 +5089,160 @@ class WAVsToAAFProcessor:
             print("Error: --bit-depth and --sample-rate cannot be used with --one-aaf because multi-clip AAFs are linked only.")
             return 1
 
+        run_stats = {'mode': _run_mode_key(embed_audio, one_aaf, tape_mode, ale_only), 'files': 0,
+                     'essence_bytes': 0, 'converted_bytes': 0, 'output_bytes': 0, 'seconds': 0.0}
+        self.last_run_stats = run_stats
+        run_start = time.perf_counter()
+        skipped_up_to_date = 0
+        # A cancelled run leaves batch-level outputs (batch.aaf, manifest, ALE, reports) as they were
+        cancelled = False
+
         if one_aaf:
             # Build multi-clip AAF in one file (linked mode only)
             wav_entries = []
-            for wav_file in wav_files:
+            # batch_manifest.json records the clips of every one-AAF run; a delta run reads only
+            # the WAVs whose size/mtime (and so UMIDs) differ from it
+            manifest_file = output_path / self.BATCH_MANIFEST
+            previous = self._load_batch_manifest(manifest_file, tape_mode, input_path) if self.delta else {}
+            manifest_clips: Dict[str, Dict] = {}
+            entry_clips: Dict[int, Tuple[str, Dict]] = {}
+            removed_rows: List[Dict] = []
+            for file_index, wav_file in enumerate(wav_files, start=1):
+                if cancel_event and cancel_event.is_set():
+                    print("\nBatch processing cancelled by user.")
+                    cancelled = True
+                    break
+                wait_while_paused()
+                report_progress(file_index - 1)
+                key = self._manifest_key(wav_file, input_path)
+                old = None
                 try:
-                    wav_meta = self.extractor.extract_basic_info(str(wav_file))
-                    if not wav_meta:
+                    clip = self._manifest_clip(wav_file, tape_mode)
+                    old = previous.pop(key, None)
+                    if old is not None and old.get('size') == clip['size'] and old.get('mtime') == clip['mtime']:
+                        manifest_clips[key] = old
+                        continue
+                    entry = self._extract_file_record(wav_file)
+                    if entry is None:
                         print(f"  Skipping {wav_file.name}: Could not read metadata")
+                        if old is not None:
+                            # Nothing replaces its clip in the bin, so keep listing the old one
+                            manifest_clips[key] = old
                         continue
-                    all_chunks = self.extractor.extract_all_metadata_chunks(str(wav_file))
-                    bext_metadata = {k: v for k, v in all_chunks.items() if k in [
-                        'description', 'originator', 'originator_reference', 'origination_date',
-                        'origination_time', 'time_reference', 'version', 'umid', 'loudness_value',
-                        'loudness_range', 'max_true_peak', 'max_momentary_loudness', 'max_short_term_loudness'
-                    ]}
-                    xml_prefixes = ['ebucore_', 'bwfmetaedit_', 'protools_', 'axml_', 'xml_']
-                    xml_metadata = {k: v for k, v in all_chunks.items() if any(k.startswith(prefix) for prefix in xml_prefixes)}
-                    used_keys = set(bext_metadata.keys()) | set(xml_metadata.keys())
-                    info_metadata = {k: v for k, v in all_chunks.items() if k not in used_keys}
-
-                    # Resolve UCS metadata taking INFO / iXML fields into account
+                    description = entry['bext_metadata'].get('description', '')
+
+                    # Resolve exact/explicit UCS metadata now (INFO / iXML fields taken into
+                    # account); fuzzy guesses are batch-scored once all clips are read
                     ucs_metadata = self._resolve_ucs_metadata(
-                        wav_file.name,
-                        bext_metadata.get('description', ''),
-                        info_metadata, xml_metadata,
-                        allow_guess=allow_ucs_guess
+                        wav_file.name, description,
+                        entry['info_metadata'], entry['xml_metadata'],
+                        allow_guess=False, wav_path=wav_file
                     )
-                    # Collect low-confidence fuzzy matches for reporting (multi-clip path)
-                    try:
-                        if allow_ucs_guess and ucs_metadata and 'primary_category' in ucs_metadata:
-                            score = float(ucs_metadata['primary_category'].get('score', 0.0))
-                            if 0 < score < getattr(self, '_ucs_min_score', 25.0):
-                                low_confidence_items.append({
-                                    'file': str(wav_file.name),
-                                    'description': bext_metadata.get('description',''),
-                                    'ucs_id': ucs_metadata['primary_category'].get('id',''),
-                                    'category': ucs_metadata['primary_category'].get('category',''),
-                                    'subcategory': ucs_metadata['primary_category'].get('subcategory',''),
-                                    'score': score,
-                                })
-                    except Exception:
-                        pass
-
-                    wav_entries.append({
-                        'wav_metadata': wav_meta,
-                        'bext_metadata': bext_metadata,
-                        'info_metadata': info_metadata,
-                        'xml_metadata': xml_metadata,
-                        'ucs_metadata': ucs_metadata,
-                    })
-                    add_ale_row_from_wavmeta(wav_file, wav_meta)
+                    entry['ucs_metadata'] = ucs_metadata
+                    if not ucs_metadata and allow_ucs_guess:
+                        entry['catalog_path'] = wav_file
+                        deferred_ucs.append((entry, wav_file.name, description))
+                    elif self.catalog is not None:
+                        self.catalog.add(wav_file, entry, ucs_metadata)
+                    wav_entries.append(entry)
+                    entry_clips[id(entry)] = (key, clip)
+                    if old is not None:
+                        removed_rows.append({'name': old.get('name', wav_file.name), 'path': str(wav_file),
+                                             'master_mob_id': old.get('master_mob_id', ''), 'reason': 'changed'})
+                        old = None
+                    add_ale_row_from_wavmeta(wav_file, entry['wav_metadata'], entry['bext_metadata'])
                 except Exception as e:
                     print(f"  Error preparing {wav_file.name}: {e}")
-
-            out_file = output_path / 'batch.aaf'
-            try:
-                if tape_mode:
-                    self.generator.create_multi_tape_aaf(wav_entries, str(out_file), fps=fps)
-                    print(f"  Created (tape-mode): {out_file.name}")
+                    if old is not None and key not in manifest_clips:
+                        manifest_clips[key] = old
+
+            resolve_deferred_ucs()
+            if sync_index is not None:
+                # Lay the clips out group by group (in time order), ungrouped clips last
+                order = {id(meta): n for n, ((meta, _), _) in enumerate(assign_sync_groups())}
+                wav_entries.sort(key=lambda e: order.get(id(e['wav_metadata']), len(order)))
+            if cancelled:
+                # A partial batch.aaf would replace a complete one and the manifest would lose the
+                # clips never reached, so both are left as they were
+                print(f"  Cancelled: no multi-clip AAF written; {self.BATCH_MANIFEST} left as it was")
+            else:
+                if self.delta:
+                    stamp = datetime.now().strftime('%Y%m%d_%H%M%S')
+                    out_file = output_path / f'batch_delta_{stamp}.aaf'
+                    removed_rows.extend({'name': old.get('name', ''), 'path': str(input_path / key),
+                                         'master_mob_id': old.get('master_mob_id', ''), 'reason': 'removed'}
+                                        for key, old in previous.items())
+                    print(f"  Delta: {len(wav_entries)} new or changed, {len(manifest_clips)} unchanged, "
+                          f"{sum(1 for row in removed_rows if row['reason'] == 'removed')} removed")
                 else:
-                    self.generator.create_multi_aaf(wav_entries, str(out_file), fps=fps, embed_audio=embed_audio, link_mode=link_mode)
-                    print(f"  Created: {out_file.name}")
-                processed = len(wav_entries)
-            except Exception as e:
-                print(f"  Error creating multi-clip AAF: {e}")
+                    out_file = output_path / 'batch.aaf'
+                written = False
+                try:
+                    if self.delta and not wav_entries:
+                        print("  No new or changed clips: no AAF written")
+                        written = True
+                    elif tape_mode:
+                        self.generator.create_multi_tape_aaf(wav_entries, str(out_file), fps=fps)
+                        print(f"  Created (tape-mode): {out_file.name}")
+                    else:
+                        self.generator.create_multi_aaf(wav_entries, str(out_file), fps=fps, embed_audio=embed_audio, link_mode=link_mode)
+                        print(f"  Created: {out_file.name}")
+                    if wav_entries:
+                        processed = len(wav_entries)
+                        run_stats['output_bytes'] = out_file.stat().st_size
+                        written = True
+                        self._deliver(out_file, output_path)
+                except Exception as e:
+                    print(f"  Error creating multi-clip AAF: {e}")
+                # The manifest lists what has been delivered: the clips of batch.aaf, or the previous
+                # manifest updated by this delta
+                if written:
+                    for entry in wav_entries:
+                        key, clip = entry_clips[id(entry)]
+                        manifest_clips[key] = clip
+                    if self.delta and removed_rows:
+                        removed_file = output_path / f'batch_delta_{stamp}_removed.csv'
+                        self._write_delta_removed(removed_file, removed_rows)
+                        self._deliver(removed_file, output_path)
+                    self._write_batch_manifest(manifest_file, manifest_clips, tape_mode,
+                                               out_file.name if wav_entries else '')
+            report_progress(total_files)
         else:
             # One AAF per clip
             if not embed_audio and (bit_depth is not None or sample_rate is not None):
                 print("Warning: --bit-depth and --sample-rate are only applied to embedded AAF audio. Linked AAFs will use original WAV specs.")
 
-            for wav_file in wav_files:
-                # Check for cancellation
-                if cancel_event and cancel_event.is_set():
-                    print("\nBatch processing cancelled by user.")
-                    break
-                    
+            completed = [0]
+            # ALE, low-confidence and catalog rows are committed in discovery order, also when
+            # clips finish out of order on worker threads
+            rows_lock = threading.Lock()
+            pending_rows: Dict[int, List[Callable[[], None]]] = {}
+            next_rows = [0]
+
+            def commit_rows(index: int, rows: List[Callable[[], None]]):
+                with rows_lock:
+                    pending_rows[index] = rows
+                    while next_rows[0] in pending_rows:
+                        for row in pending_rows.pop(next_rows[0]):
+                            row()
+                        next_rows[0] += 1
+
+            def process_clip(index: int, wav_file: Path):
+                nonlocal processed, skipped_up_to_date
+                rows: List[Callable[[], None]] = []
                 try:
-                    print(f"Processing: {wav_file.name}")
                     source_wav = wav_file
                     temp_wav_cleanup = None
+                    if skip_up_to_date and not ale_only and self._is_up_to_date(
+                            wav_file, self._per_clip_output_file(wav_file, input_path, output_path, near_sources)):
+                        with tally_lock:
+                            skipped_up_to_date += 1
+                        # The AAF is current but batch.ale lists every clip: header read only
+                        basic = self._header_basic_info(wav_file) if emit_ale else {}
+                        if basic:
+                            rows.append(lambda: add_ale_row_from_wavmeta(wav_file, basic))
+                        return
+                    print(f"Processing: {wav_file.name}")
                     if embed_audio and (bit_depth is not None or sample_rate is not None):
                         try:
                             source_wav, temp_wav_cleanup = self._prepare_audio_source(
@@ -2373,74 +5252,55 @@ class WAVsToAAFProcessor:
                             )
                         except Exception as e:
                             print(f"  Error preparing {wav_file.name} for conversion: {e}")
-                            continue
-
-                    wav_metadata = self.extractor.extract_basic_info(str(source_wav))
-                    if temp_wav_cleanup is not None:
-                        wav_metadata['filename'] = wav_file.name
-                        wav_metadata['filepath'] = str(source_wav)
-                        wav_metadata['source_filepath'] = str(wav_file)
+                            return
 
-                    if not wav_metadata:
+                    record = self._extract_file_record(wav_file, basic_path=source_wav)
+                    if record is None:
+                        # temp_wav_cleanup is removed in the finally block below
                         print(f"  Skipping {wav_file.name}: Could not read metadata")
-                        if temp_wav_cleanup:
-                            try:
-                                os.unlink(temp_wav_cleanup)
-                            except Exception:
-                                pass
-                        continue
-                    # Extract all metadata chunks
-                    all_chunks = self.extractor.extract_all_metadata_chunks(str(wav_file))
-                    bext_metadata = {k: v for k, v in all_chunks.items() if k in [
-                        'description', 'originator', 'originator_reference', 'origination_date',
-                        'origination_time', 'time_reference', 'version', 'umid', 'loudness_value',
-                        'loudness_range', 'max_true_peak', 'max_momentary_loudness', 'max_short_term_loudness'
-                    ]}
-                    xml_prefixes = ['ebucore_', 'bwfmetaedit_', 'protools_', 'axml_', 'xml_']
-                    xml_metadata = {k: v for k, v in all_chunks.items() if any(k.startswith(prefix) for prefix in xml_prefixes)}
-                    used_keys = set(bext_metadata.keys()) | set(xml_metadata.keys())
-                    info_metadata = {k: v for k, v in all_chunks.items() if k not in used_keys}
+                        return
+                    wav_metadata = record['wav_metadata']
+                    bext_metadata = record['bext_metadata']
+                    info_metadata = record['info_metadata']
+                    xml_metadata = record['xml_metadata']
+
+                    if ale_only:
+                        # Only the low-confidence report uses UCS here; batch-score it at the end
+                        ucs_metadata = self._resolve_ucs_metadata(
+                            wav_file.name, bext_metadata.get('description', ''),
+                            info_metadata, xml_metadata, allow_guess=False, wav_path=wav_file
+                        )
+                        if not ucs_metadata and allow_ucs_guess:
+                            deferred = dict(record, catalog_path=wav_file) if self.catalog is not None else {}
+                            rows.append(lambda: deferred_ucs.append(
+                                (deferred, wav_file.name, bext_metadata.get('description', ''))))
+                        elif self.catalog is not None:
+                            rows.append(lambda: self.catalog.add(wav_file, record, ucs_metadata))
+                        with tally_lock:
+                            processed += 1
+                        rows.append(lambda: add_ale_row_from_wavmeta(wav_file, wav_metadata, bext_metadata))
+                        return
 
                     ucs_metadata = self._resolve_ucs_metadata(
                         wav_file.name,
                         bext_metadata.get('description', ''),
                         info_metadata, xml_metadata,
-                        allow_guess=allow_ucs_guess
+                        allow_guess=allow_ucs_guess, wav_path=wav_file
                     )
+                    rows.append(lambda: note_low_confidence(
+                        wav_file.name, bext_metadata.get('description', ''), ucs_metadata))
+                    if self.catalog is not None:
+                        rows.append(lambda: self.catalog.add(wav_file, record, ucs_metadata))
 
-                    try:
-                        if allow_ucs_guess and ucs_metadata and 'primary_category' in ucs_metadata:
-                            score = float(ucs_metadata['primary_category'].get('score', 0.0))
-                            if 0 < score < getattr(self, '_ucs_min_score', 25.0):
-                                low_confidence_items.append({
-                                    'file': str(wav_file.name),
-                                    'description': bext_metadata.get('description',''),
-                                    'ucs_id': ucs_metadata['primary_category'].get('id',''),
-                                    'category': ucs_metadata['primary_category'].get('category',''),
-                                    'subcategory': ucs_metadata['primary_category'].get('subcategory',''),
-                                    'score': score,
-                                })
-                    except Exception:
-                        pass
                     output_filename = wav_file.stem + '.aaf'
                     
-                    # Choose output location based on near_sources flag
+                    # Save next to the source WAV (near_sources) or mirror the subdirectory
+                    # structure within the output directory
+                    out_file = self._per_clip_output_file(wav_file, input_path, output_path, near_sources)
                     if near_sources:
-                        # Save AAF next to the source WAV file
-                        out_file = wav_file.parent / output_filename
                         print(f"  Saving near source: {out_file}")
                     else:
-                        # Mirror the subdirectory structure within the output directory
-                        # Calculate relative path from input_path to wav_file
-                        try:
-                            rel_dir = wav_file.parent.relative_to(input_path)
-                            out_dir = output_path / rel_dir
-                        except ValueError:
-                            # Fallback if relative path calculation fails
-                            out_dir = output_path
-                        
-                        out_dir.mkdir(parents=True, exist_ok=True)
-                        out_file = out_dir / output_filename
+                        out_file.parent.mkdir(parents=True, exist_ok=True)
                     
                     # Choose AAF generation method based on tape_mode flag
                     if tape_mode:
@@ -2455,8 +5315,22 @@ class WAVsToAAFProcessor:
                             fps=fps, embed_audio=embed_audio, link_mode=link_mode, relative_locators=relative_locators
                         )
                         print(f"  Created: {output_filename}")
-                    processed += 1
-                    add_ale_row_from_wavmeta(wav_file, wav_metadata)
+                    with tally_lock:
+                        processed += 1
+                    rows.append(lambda: add_ale_row_from_wavmeta(wav_file, wav_metadata))
+                    try:
+                        converted_bytes = wav_file.stat().st_size if temp_wav_cleanup else 0
+                        output_bytes = out_file.stat().st_size
+                        with tally_lock:
+                            if embed_audio and not tape_mode:
+                                run_stats['essence_bytes'] += (int(wav_metadata.get('frames', 0)) *
+                                                               int(wav_metadata.get('channels', 1)) *
+                                                               int(wav_metadata.get('sample_width', 2)))
+                            run_stats['converted_bytes'] += converted_bytes
+                            run_stats['output_bytes'] += output_bytes
+                    except (OSError, ValueError):
+                        pass
+                    self._deliver(out_file, input_path if near_sources else output_path)
                 except Exception as e:
                     print(f"  Error processing {wav_file.name}: {e}")
                 finally:
@@ -2465,45 +5339,424 @@ class WAVsToAAFProcessor:
                             os.unlink(temp_wav_cleanup)
                         except Exception:
                             pass
+                    commit_rows(index, rows)
+                    with tally_lock:
+                        completed[0] += 1
+                        done = completed[0]
+                    report_progress(done)
 
-        # Optionally write ALE
-        if emit_ale and ale_rows:
-            ale_path = output_path / 'batch.ale'
+            def process_admitted(index: int, wav_file: Path, cost: int):
+                try:
+                    process_clip(index, wav_file)
+                finally:
+                    if governor is not None:
+                        governor.release(cost)
+
+            # Per-file work can run on several threads; the governor (if any) admits files only
+            # while their estimated working sets fit in its budget
+            governor = None if ale_only else self.memory_governor
+            pool = ThreadPoolExecutor(max_workers=workers) if workers > 1 and not ale_only else None
             try:
-                with open(ale_path, 'w', encoding='utf-8') as f:
-                    f.write('Heading\n')
-                    f.write('FIELD_DELIM\tTABS\n')
-                    f.write('VIDEO_FORMAT\t1080\n')
-                    f.write('AUDIO_FORMAT\t48kHz\n')
-                    f.write(f'FPS\t{int(fps)}\n')
-                    f.write('\nColumn\n')
-                    cols = ['Name','Tracks','Start','End','Tape','Source File','AudioRate','SampleRate','Channels','Duration']
-                    f.write('\t'.join(cols)+'\n')
-                    f.write('Data\n')
-                    for r in ale_rows:
-                        f.write('\t'.join(r.get(c,'') for c in cols)+'\n')
-                print(f"  Wrote ALE: {ale_path}")
-            except Exception as e:
-                print(f"  Failed to write ALE: {e}")
+                for index, wav_file in enumerate(wav_files):
+                    # Check for cancellation
+                    wait_while_paused()
+                    if cancel_event and cancel_event.is_set():
+                        print("\nBatch processing cancelled by user.")
+                        cancelled = True
+                        break
+                    cost = governor.acquire(self._clip_memory_cost(wav_file, embed_audio)) if governor else 0
+                    if pool is None:
+                        process_admitted(index, wav_file, cost)
+                    else:
+                        pool.submit(process_admitted, index, wav_file, cost)
+            finally:
+                if pool is not None:
+                    pool.shutdown(wait=True)
+
+        resolve_deferred_ucs()
+        if ale_only:
+            assign_sync_groups()
+
+        if cancelled and (emit_ale or low_confidence_items):
+            print("  Cancelled: batch.ale and ucs_low_confidence.csv left as they were")
+        # Optionally write ALE
+        if emit_ale and ale_rows and not cancelled:
+            self._write_ale(output_path / 'batch.ale', ale_rows, fps)
+            self._deliver(output_path / 'batch.ale', output_path)
 
         # Write batch low-confidence report if present
-        if low_confidence_items:
+        if low_confidence_items and not cancelled:
+            self._write_low_confidence_report(output_path / 'ucs_low_confidence.csv', low_confidence_items)
+            self._deliver(output_path / 'ucs_low_confidence.csv', output_path)
+
+        run_stats['files'] = processed
+        run_stats['seconds'] = time.perf_counter() - run_start
+
+        if skipped_up_to_date:
+            print(f"\nSkipped {skipped_up_to_date} up-to-date file(s)")
+        print(f"\nCompleted! Processed {processed} file(s)")
+        print(f"Output files saved to: {output_path}")
+        return 0
+    
+    def process_targets(self, input_dir: str, targets: List[Dict], allow_ucs_guess: bool = True,
+                        cancel_event: Optional[Any] = None, pause_event: Optional[Any] = None,
+                        progress_callback: Optional[Callable[[int, int], None]] = None,
+                        skip_up_to_date: bool = False) -> int:
+        """Write several output targets (see parse_output_target) from one pass over the input.
+
+        Each WAV is discovered, parsed and UCS-resolved once and the record is handed to every
+        target's writer. Files are read TARGET_BATCH at a time so fuzzy UCS guesses are
+        batch-scored; embedded targets with the same bit-depth/sample-rate share one converted copy.
+        """
+        input_path = Path(input_dir)
+        if not input_path.exists():
+            print(f"Error: Input directory '{input_dir}' does not exist")
+            return 1
+        wav_files = self.discover_wav_files(input_path)
+        if not wav_files:
+            print(f"No WAV files found in '{input_dir}'")
+            return 1
+
+        for target in targets:
+            target['path'] = Path(target['output'])
+            target['path'].mkdir(parents=True, exist_ok=True)
+            target.update(entries=[], ale_rows=[], processed=0, skipped=0)
+        print(f"Found {len(wav_files)} WAV file(s) to process for {len(targets)} target(s)...")
+
+        low_confidence_items = []
+        total_files = len(wav_files)
+        done = 0
+        cancelled = False
+        for start in range(0, total_files, self.TARGET_BATCH):
+            records = []
+            for wav_file in wav_files[start:start + self.TARGET_BATCH]:
+                while pause_event is not None and pause_event.is_set() and not (cancel_event and cancel_event.is_set()):
+                    time.sleep(0.2)
+                if cancel_event and cancel_event.is_set():
+                    cancelled = True
+                    break
+                try:
+                    record = self._extract_file_record(wav_file)
+                    if record is None:
+                        print(f"  Skipping {wav_file.name}: Could not read metadata")
+                        continue
+                    record['wav_file'] = wav_file
+                    record['ucs_metadata'] = self._resolve_ucs_metadata(
+                        wav_file.name, record['bext_metadata'].get('description', ''),
+                        record['info_metadata'], record['xml_metadata'], allow_guess=False, wav_path=wav_file
+                    )
+                    records.append(record)
+                except Exception as e:
+                    print(f"  Error reading {wav_file.name}: {e}")
+
+            pending = [r for r in records if not r['ucs_metadata']] if allow_ucs_guess else []
+            if pending:
+                items = [(r['wav_file'].name, r['bext_metadata'].get('description', '')) for r in pending]
+                for record, (name, description), result in zip(pending, items,
+                                                                 self.ucs_processor.categorize_batch(items)):
+                    record['ucs_metadata'] = result
+                    item = self._low_confidence_item(name, description, result)
+                    if item:
+                        low_confidence_items.append(item)
+            if self.catalog is not None:
+                for record in records:
+                    self.catalog.add(record['wav_file'], record, record['ucs_metadata'])
+
+            for record in records:
+                print(f"Processing: {record['wav_file'].name}")
+                converted: Dict[Tuple, Tuple] = {}
+                try:
+                    for target in targets:
+                        self._write_target_clip(target, record, input_path, converted, skip_up_to_date)
+                finally:
+                    for _, cleanup, _ in converted.values():
+                        if cleanup:
+                            try:
+                                os.unlink(cleanup)
+                            except Exception:
+                                pass
+            done = min(total_files, start + self.TARGET_BATCH)
+            if progress_callback:
+                try:
+                    progress_callback(done, total_files)
+                except Exception:
+                    pass
+            if cancelled:
+                print("\nBatch processing cancelled by user.")
+                break
+
+        if cancelled:
+            print("  Cancelled: batch.aaf, batch.ale and ucs_low_confidence.csv of every target left as they were")
+        for target in targets:
+            if cancelled:
+                break
+            if target['one_aaf'] and target['entries']:
+                out_file = target['path'] / 'batch.aaf'
+                try:
+                    if target['tape_mode']:
+                        self.generator.create_multi_tape_aaf(target['entries'], str(out_file), fps=target['fps'])
+                    else:
+                        self.generator.create_multi_aaf(target['entries'], str(out_file), fps=target['fps'],
+                                                        embed_audio=False, link_mode=target['link_mode'])
+                    print(f"  Created: {out_file}")
+                except Exception as e:
+                    print(f"  Error creating multi-clip AAF {out_file}: {e}")
+            if target['emit_ale'] and target['ale_rows']:
+                self._write_ale(target['path'] / 'batch.ale', target['ale_rows'], target['fps'])
+            if low_confidence_items:
+                self._write_low_confidence_report(target['path'] / 'ucs_low_confidence.csv', low_confidence_items)
+
+        print(f"\nCompleted! Read {done} file(s) once for {len(targets)} target(s)")
+        for target in targets:
+            skipped = f", skipped {target['skipped']} up-to-date" if target['skipped'] else ""
+            print(f"  {target['kind']:<8} {target['fps']:g} fps → {target['path']}: {target['processed']} file(s){skipped}")
+        return 0
+
+    def process_catalog(self, input_dir: str, catalog_file: str, allow_ucs_guess: bool = True,
+                        incremental: bool = True, row_group_size: int = CATALOG_ROW_GROUP,
+                        cancel_event: Optional[Any] = None,
+                        progress_callback: Optional[Callable[[int, int], None]] = None) -> int:
+        """Write (or refresh) a columnar metadata catalog of every WAV under input_dir; no AAFs.
+
+        With incremental=True, rows of an existing catalog whose file still has the same size and
+        mtime are copied over batch by batch and only new or changed files are read, so a nightly
+        refresh costs a directory walk plus the changes. Files are read TARGET_BATCH at a time so
+        fuzzy UCS guesses are batch-scored.
+        """
+        input_path = Path(input_dir)
+        if not input_path.exists():
+            print(f"Error: Input directory '{input_dir}' does not exist")
+            return 1
+        try:
+            catalog = CatalogWriter(catalog_file, row_group_size=row_group_size)
+        except ImportError:
+            print("Error: catalog export needs the optional 'pyarrow' package (pip install pyarrow)")
+            return 1
+        wav_files = self.discover_wav_files(input_path)
+        reused = set()
+        try:
+            if incremental:
+                current = {}
+                for wav_file in wav_files:
+                    try:
+                        st = wav_file.stat()
+                        current[str(wav_file)] = (st.st_size, datetime.fromtimestamp(st.st_mtime))
+                    except OSError:
+                        pass
+                reused = catalog.copy_unchanged(current)
+            changed = [w for w in wav_files if str(w) not in reused]
+            print(f"Found {len(wav_files)} WAV file(s): {len(reused)} unchanged, {len(changed)} to read...")
+            for start in range(0, len(changed), self.TARGET_BATCH):
+                if cancel_event and cancel_event.is_set():
+                    print("\nCatalog refresh cancelled by user; keeping the previous catalog.")
+                    catalog.abort()
+                    return 1
+                records = []
+                for wav_file in changed[start:start + self.TARGET_BATCH]:
+                    try:
+                        record = self._extract_file_record(wav_file)
+                        if record is None:
+                            print(f"  Skipping {wav_file.name}: Could not read metadata")
+                            continue
+                        record['ucs_metadata'] = self._resolve_ucs_metadata(
+                            wav_file.name, record['bext_metadata'].get('description', ''),
+                            record['info_metadata'], record['xml_metadata'], allow_guess=False,
+                            wav_path=wav_file)
+                        records.append((wav_file, record))
+                    except Exception as e:
+                        print(f"  Error reading {wav_file.name}: {e}")
+                pending = [r for _, r in records if not r['ucs_metadata']] if allow_ucs_guess else []
+                if pending:
+                    items = [(Path(r['wav_metadata']['filepath']).name, r['bext_metadata'].get('description', ''))
+                             for r in pending]
+                    for record, result in zip(pending, self.ucs_processor.categorize_batch(items)):
+                        record['ucs_metadata'] = result
+                for wav_file, record in records:
+                    catalog.add(wav_file, record, record['ucs_metadata'])
+                if progress_callback:
+                    try:
+                        progress_callback(min(len(changed), start + self.TARGET_BATCH), len(changed))
+                    except Exception:
+                        pass
+            catalog.close()
+        except Exception:
+            catalog.abort()
+            raise
+        print(f"\nCompleted! Catalog {catalog.path} has {catalog.rows_written} row(s) "
+              f"({len(reused)} reused, {catalog.rows_written - len(reused)} read)")
+        return 0
+
+    def _write_target_clip(self, target: Dict, record: Dict, input_path: Path, converted: Dict,
+                           skip_up_to_date: bool):
+        """Hand one extracted record to one target: ALE row, multi-clip entry or per-clip AAF"""
+        wav_file = record['wav_file']
+        if target['emit_ale']:
+            row = self._ale_row(wav_file, record['wav_metadata'])
+            if row:
+                target['ale_rows'].append(row)
+        if target['kind'] == 'ale' or target['one_aaf']:
+            if target['one_aaf']:
+                target['entries'].append(record)
+            target['processed'] += 1
+            return
+
+        out_file = self._per_clip_output_file(wav_file, input_path, target['path'], False)
+        if skip_up_to_date and self._is_up_to_date(wav_file, out_file):
+            target['skipped'] += 1
+            return
+        embed_audio = target['kind'] == 'embedded'
+        wav_metadata = record['wav_metadata']
+        conversion = (target['bit_depth'], target['sample_rate'])
+        try:
+            if embed_audio and conversion != (None, None):
+                if conversion not in converted:
+                    source_wav, cleanup = self._prepare_audio_source(
+                        wav_file, target_sample_rate=target['sample_rate'], target_bit_depth=target['bit_depth'])
+                    # Registered before reading it so the copy is removed even if that fails
+                    converted[conversion] = (source_wav, cleanup, None)
+                    converted_metadata = self.extractor.extract_basic_info(str(source_wav))
+                    if converted_metadata:
+                        converted_metadata.update(filename=wav_file.name, filepath=str(source_wav),
+                                                  source_filepath=str(wav_file))
+                        if 'regions' in wav_metadata:
+                            converted_metadata['regions'] = wav_metadata['regions']
+                    converted[conversion] = (source_wav, cleanup, converted_metadata)
+                wav_metadata = converted[conversion][2]
+                if not wav_metadata:
+                    print(f"  [{target['kind']}] Could not read converted audio for {wav_file.name}")
+                    return
+            out_file.parent.mkdir(parents=True, exist_ok=True)
+            # Writers get their own copy so one target can't leak changes into the next
+            args = (dict(wav_metadata), record['bext_metadata'], record['info_metadata'], record['xml_metadata'],
+                    record['ucs_metadata'], str(out_file))
+            if target['tape_mode']:
+                self.generator.create_tape_aaf_file(*args, fps=target['fps'], embed_audio=embed_audio)
+            else:
+                self.generator.create_aaf_file(*args, fps=target['fps'], embed_audio=embed_audio,
+                                               link_mode=target['link_mode'],
+                                               relative_locators=target['relative_locators'])
+            target['processed'] += 1
+            print(f"  [{target['kind']}] Created: {out_file}")
+        except Exception as e:
+            print(f"  [{target['kind']}] Error writing {out_file.name}: {e}")
+
+    def _extract_member_record(self, member: ArchiveMember) -> Optional[Dict]:
+        """_extract_file_record for a WAV stored in an archive: one ranged header walk, nothing extracted"""
+        header = self.extractor.read_riff_header(member)
+        wav_metadata = self.extractor.basic_info_from_header(header, member.name, str(member)) if header else {}
+        if not wav_metadata:
+            return None
+        wav_metadata['archive_member'] = member
+        wav_metadata['modification_time'] = datetime.fromtimestamp(member.mtime).isoformat()
+        bext_metadata, info_metadata, xml_metadata = self._split_metadata_chunks(
+            self.extractor.parse_metadata_bytes(header['metadata_bytes']))
+        return {
+            'wav_metadata': wav_metadata,
+            'bext_metadata': bext_metadata,
+            'info_metadata': info_metadata,
+            'xml_metadata': xml_metadata,
+        }
+
+    def process_archive(self, archive_file: str, output_dir: Optional[str], fps: float = 24,
+                        embed_audio: bool = True, emit_ale: bool = False, allow_ucs_guess: bool = True,
+                        ale_only: bool = False, skip_up_to_date: bool = False,
+                        cancel_event: Optional[threading.Event] = None,
+                        progress_callback: Optional[Callable[[int, int], None]] = None) -> int:
+        """Write embedded per-clip AAFs for the stored WAVs of a ZIP or uncompressed TAR archive.
+
+        Members are never extracted: headers are walked and audio is streamed into the AAF
+        essence through ranged reads at each member's offset. Linked AAFs are refused (there is
+        no file on disk to link to). AAFs mirror the member paths under output_dir (default:
+        '<archive name>_AAFs' next to the archive).
+        """
+        archive_path = Path(archive_file)
+        if not embed_audio and not ale_only:
+            print("Error: linked AAFs can't point into an archive. Extract it first, or create embedded AAFs "
+                  "(the default) to read the WAVs in place.")
+            return 1
+        if not ale_only and self.generator.essence_writer.mode != 'stream':
+            print("Error: archive input needs the stream essence writer (--essence-writer stream).")
+            return 1
+        try:
+            members, skipped_members = list_archive_wavs(archive_path)
+        except (OSError, ValueError, zipfile.BadZipFile, tarfile.TarError) as e:
+            print(f"Error: could not read archive {archive_path}: {e}")
+            return 1
+        for name, reason in skipped_members:
+            print(f"  Skipping {name}: {reason}")
+        if not members:
+            print(f"No readable WAV members found in '{archive_path.name}'")
+            return 1
+        output_path = Path(output_dir) if output_dir else archive_path.parent / f"{archive_path.stem}_AAFs"
+        output_path.mkdir(parents=True, exist_ok=True)
+        print(f"Found {len(members)} WAV member(s) in {archive_path.name} to process...")
+
+        ale_rows: List[Dict[str, str]] = []
+        low_confidence_items = []
+        processed = skipped_up_to_date = 0
+        for index, member in enumerate(members, start=1):
+            if cancel_event and cancel_event.is_set():
+                print("\nBatch processing cancelled by user.")
+                break
+            member_path = Path(member.name)
+            out_file = output_path / member_path.parent / (member_path.stem + '.aaf')
+            if output_path.resolve() not in out_file.resolve().parents:
+                # list_archive_wavs already drops unsafe names; never write outside output_path
+                print(f"  Skipping {member.name}: unsafe path")
+                continue
             try:
-                import csv
-                report_path = output_path / 'ucs_low_confidence.csv'
-                with open(report_path, 'w', newline='', encoding='utf-8') as rf:
-                    writer = csv.DictWriter(rf, fieldnames=['file','description','ucs_id','category','subcategory','score'])
-                    writer.writeheader()
-                    for row in low_confidence_items:
-                        writer.writerow(row)
-                print(f"  Wrote UCS low-confidence report: {report_path}")
+                if skip_up_to_date and not ale_only and out_file.exists() and \
+                        out_file.stat().st_mtime >= member.mtime:
+                    skipped_up_to_date += 1
+                    basic = self._header_basic_info(member) if emit_ale else {}
+                    row = self._ale_row(member_path, basic) if basic else None
+                    if row:
+                        ale_rows.append(row)
+                    continue
+                print(f"Processing: {member.name}")
+                record = self._extract_member_record(member)
+                if record is None:
+                    print(f"  Skipping {member.name}: not a PCM WAV")
+                    continue
+                wav_metadata = record['wav_metadata']
+                description = record['bext_metadata'].get('description', '')
+                ucs_metadata = self._resolve_ucs_metadata(member_path.name, description, record['info_metadata'],
+                                                          record['xml_metadata'], allow_guess=allow_ucs_guess)
+                if allow_ucs_guess:
+                    item = self._low_confidence_item(member_path.name, description, ucs_metadata)
+                    if item:
+                        low_confidence_items.append(item)
+                if self.catalog is not None:
+                    self.catalog.add(member, record, ucs_metadata)
+                if not ale_only:
+                    out_file.parent.mkdir(parents=True, exist_ok=True)
+                    self.generator.create_aaf_file(
+                        wav_metadata, record['bext_metadata'], record['info_metadata'], record['xml_metadata'],
+                        ucs_metadata, str(out_file), fps=fps, embed_audio=True)
+                    print(f"  Created: {out_file.name}")
+                processed += 1
+                row = self._ale_row(member_path, wav_metadata)
+                if row:
+                    ale_rows.append(row)
             except Exception as e:
-                print(f"  Failed to write UCS low-confidence report: {e}")
+                print(f"  Error processing {member.name}: {e}")
+            finally:
+                if progress_callback:
+                    try:
+                        progress_callback(index, len(members))
+                    except Exception:
+                        pass
 
+        if (emit_ale or ale_only) and ale_rows:
+            self._write_ale(output_path / 'batch.ale', ale_rows, fps)
+        if low_confidence_items:
+            self._write_low_confidence_report(output_path / 'ucs_low_confidence.csv', low_confidence_items)
+        if skipped_up_to_date:
+            print(f"\nSkipped {skipped_up_to_date} up-to-date file(s)")
         print(f"\nCompleted! Processed {processed} file(s)")
         print(f"Output files saved to: {output_path}")
         return 0
-    
+
     def process_single_file(self, wav_file: str, output_file: str, fps: float = 24, embed_audio: bool = False,
                             link_mode: str = 'import', relative_locators: bool = False,
                             bit_depth: Optional[int] = None, sample_rate: Optional[int] = None,
@@ -2565,20 +5818,9 @@ class WAVsToAAFProcessor:
             # Extract all metadata chunks
             all_chunks = self.extractor.extract_all_metadata_chunks(wav_file)
             
-            # Separate chunk types
-            bext_metadata = {k: v for k, v in all_chunks.items() if k in [
-                'description', 'originator', 'originator_reference', 'origination_date', 
-                'origination_time', 'time_reference', 'version', 'umid', 'loudness_value',
-                'loudness_range', 'max_true_peak', 'max_momentary_loudness', 'max_short_term_loudness'
-            ]}
-            
-            # Extract XML metadata (keys with XML prefixes)
-            xml_prefixes = ['ebucore_', 'bwfmetaedit_', 'protools_', 'axml_', 'xml_']
-            xml_metadata = {k: v for k, v in all_chunks.items() if any(k.startswith(prefix) for prefix in xml_prefixes)}
-            
-            # INFO metadata is everything else (not BEXT or XML)
-            used_keys = set(bext_metadata.keys()) | set(xml_metadata.keys())
-            info_metadata = {k: v for k, v in all_chunks.items() if k not in used_keys}
+            # Separate chunk types (INFO metadata is everything that is not BEXT or XML)
+            bext_metadata, info_metadata, xml_metadata = self._split_metadata_chunks(all_chunks)
+            self._attach_regions(wav_metadata, wav_file, bext_metadata)
             
             # Show metadata found
             if info_metadata:
@@ -2593,7 +5835,7 @@ class WAVsToAAFProcessor:
                 Path(wav_file).name,
                 bext_metadata.get('description', ''),
                 info_metadata, xml_metadata,
-                allow_guess=allow_ucs_guess
+                allow_guess=allow_ucs_guess, wav_path=wav_file
             )
             
             if ucs_metadata and 'primary_category' in ucs_metadata:
@@ -2659,14 +5901,151 @@ class WAVsToAAFProcessor:
             print(f"Error processing {wav_file}: {e}")
             return 1
 
-    def _resolve_ucs_metadata(self, filename: str, description: str, info_metadata: Dict, xml_metadata: Dict, allow_guess: bool = True) -> Dict:
+    def _growing_record(self, follower: GrowingWavFollower, allow_ucs_guess: bool = True) -> Dict:
+        """Metadata of a followed recording once it has finished, with the follower's final length"""
+        wav_file = follower.path
+        record = self._extract_file_record(wav_file) or {
+            'wav_metadata': self.extractor.basic_info_from_header(follower.header, wav_file.name, str(wav_file)),
+            'bext_metadata': {}, 'info_metadata': {}, 'xml_metadata': {}}
+        wav_metadata = record['wav_metadata']
+        # The header may never have been patched (settled recordings): the follower's count is the truth
+        duration = follower.frames / wav_metadata['sample_rate'] if wav_metadata.get('sample_rate') else 0
+        wav_metadata.update(frames=follower.frames, duration_seconds=duration,
+                            duration_timecode=self.extractor._seconds_to_timecode(duration))
+        record['ucs_metadata'] = self._resolve_ucs_metadata(
+            wav_file.name, record['bext_metadata'].get('description', ''), record['info_metadata'],
+            record['xml_metadata'], allow_guess=allow_ucs_guess, wav_path=str(wav_file))
+        return record
+
+    def follow_file(self, wav_file: str, output_file: str, fps: float = 24, embed_audio: bool = True,
+                    link_mode: str = 'import', relative_locators: bool = False, allow_ucs_guess: bool = True,
+                    cancel_event: Optional[threading.Event] = None) -> int:
+        """Write the AAF of a WAV that may still be recording or copying.
+
+        Embedded AAFs (link_mode 'import') take the audio while it is written, so the AAF is
+        finished within a poll of the writer closing the file; other modes wait for the finished
+        file. Lengths and metadata are read once the recording has finished.
+        """
+        wav_path = Path(wav_file)
+        follower = GrowingWavFollower(wav_path, settle_seconds=self.follow_settle_seconds,
+                                      poll_interval=self.follow_poll_interval, cancel_event=cancel_event,
+                                      refresh=lambda fl: self._growing_record(fl, allow_ucs_guess))
+        try:
+            print(f"Following: {wav_path}")
+            header = follower.wait_for_header()
+            if header is None:
+                print(f"Stopped waiting for a WAV header in {wav_path.name}")
+                return 1
+            Path(output_file).parent.mkdir(parents=True, exist_ok=True)
+            start_metadata = self.extractor.basic_info_from_header(header, wav_path.name, str(wav_path))
+            if embed_audio and link_mode == 'import' and start_metadata:
+                self.generator.create_aaf_file(start_metadata, {}, {}, {}, None, output_file, fps=fps,
+                                               embed_audio=True, link_mode=link_mode,
+                                               relative_locators=relative_locators, growing=follower)
+            else:
+                follower.wait()
+                record = follower.final_record()
+                self.generator.create_aaf_file(
+                    record['wav_metadata'], record['bext_metadata'], record['info_metadata'],
+                    record['xml_metadata'], record['ucs_metadata'], output_file, fps=fps,
+                    embed_audio=embed_audio, link_mode=link_mode, relative_locators=relative_locators)
+            lag = time.monotonic() - follower.finished_at if follower.finished_at else 0.0
+            print(f"Created: {output_file} ({follower.frames} frames, recording {follower.reason}, "
+                  f"AAF done {lag:.2f}s later)")
+            return 0
+        except Exception as e:
+            print(f"Error following {wav_path}: {e}")
+            return 1
+
+    def process_growing(self, input_path: str, output_dir: Optional[str], fps: float = 24, embed_audio: bool = True,
+                        link_mode: str = 'import', relative_locators: bool = False, near_sources: bool = False,
+                        allow_ucs_guess: bool = True, idle_exit: Optional[float] = None,
+                        cancel_event: Optional[threading.Event] = None, workers: int = FOLLOW_WORKERS) -> int:
+        """Watch a directory and write a per-clip AAF for every WAV, following files still being written.
+
+        New WAVs are followed on up to `workers` threads at once, since poly recorders write several
+        files at once; later ones queue and catch up when a thread frees. With self.memory_governor
+        each file is admitted against its estimate from the header at discovery (the final length
+        of a recording is not known yet). WAVs already there with an up-to-date AAF are skipped.
+        Returns once nothing has been followed and no WAV has appeared for idle_exit seconds, or
+        when cancel_event is set (Ctrl-C on the CLI).
+        """
+        input_dir = Path(input_path)
+        if not input_dir.is_dir():
+            print(f"Error: Input directory '{input_dir}' does not exist")
+            return 1
+        output_root = Path(output_dir) if output_dir else input_dir / 'aaf_output'
+        cancel_event = cancel_event or threading.Event()
+        seen = set()
+        pending = []
+        results: List[int] = []
+        last_activity = time.monotonic()
+        governor = self.memory_governor
+        pool = ThreadPoolExecutor(max_workers=max(1, workers))
+        print(f"Watching {input_dir} for recordings (settle {self.follow_settle_seconds:g}s)…")
+
+        def follow(wav_file: Path, out_file: Path, cost: int) -> int:
+            try:
+                return self.follow_file(str(wav_file), str(out_file), fps=fps, embed_audio=embed_audio,
+                                        link_mode=link_mode, relative_locators=relative_locators,
+                                        allow_ucs_guess=allow_ucs_guess, cancel_event=cancel_event)
+            finally:
+                if governor is not None:
+                    governor.release(cost)
+
+        try:
+            while not cancel_event.is_set():
+                for wav_file in self.discover_wav_files(input_dir):
+                    key = str(wav_file.resolve())
+                    if key in seen:
+                        continue
+                    seen.add(key)
+                    out_file = self._per_clip_output_file(wav_file, input_dir, output_root, near_sources)
+                    if self._is_up_to_date(wav_file, out_file):
+                        continue
+                    cost = governor.acquire(self._clip_memory_cost(wav_file, embed_audio)) if governor else 0
+                    pending.append(pool.submit(follow, wav_file, out_file, cost))
+                    last_activity = time.monotonic()
+                results.extend(f.result() for f in pending if f.done())
+                pending = [f for f in pending if not f.done()]
+                if pending:
+                    last_activity = time.monotonic()
+                elif idle_exit is not None and time.monotonic() - last_activity >= idle_exit:
+                    break
+                cancel_event.wait(max(self.follow_poll_interval, 0.5))
+        except KeyboardInterrupt:
+            print("Stopping: recordings still being followed will not get AAFs")
+            cancel_event.set()
+        pool.shutdown(wait=True)
+        results.extend(f.result() for f in pending)
+        failed = sum(1 for r in results if r)
+        print(f"Growing-file ingest: {len(results) - failed} AAF(s) written, {failed} failed")
+        return 1 if failed else 0
+
+    def _resolve_ucs_metadata(self, filename: str, description: str, info_metadata: Dict, xml_metadata: Dict,
+                              allow_guess: bool = True, wav_path: Optional[str] = None) -> Dict:
         """Resolve UCS metadata for a file, preferring filename-ID exact matches, then INFO/iXML fields, then fuzzy UCS guessing.
 
         Returns a ucs_metadata dict in the same shape as UCSProcessor.categorize_sound.
+        With an xattr cache and wav_path, the result is cached on the file per matching options.
         """
+        cache = self.extractor.xattr_cache
+        if cache is None or wav_path is None:
+            return self._resolve_ucs_uncached(filename, description, info_metadata, xml_metadata, allow_guess)
+        key = (f"{__version__}:ucs={self.ucs_processor.table_hash},guess={int(allow_guess)},"
+               f"edits={self.ucs_processor.max_edit_distance},name={filename}")
+        cached = (cache.get(str(wav_path), 'ucs') or {}).get(key)
+        if cached is not None:
+            return cached
+        result = self._resolve_ucs_uncached(filename, description, info_metadata, xml_metadata, allow_guess)
+        cache.update(str(wav_path), ucs={key: result})
+        return result
+
+    def _resolve_ucs_uncached(self, filename: str, description: str, info_metadata: Dict, xml_metadata: Dict,
+                              allow_guess: bool = True) -> Dict:
         # 1) Exact filename-ID match handled by categorize_sound (it returns score 100)
-        res = self.ucs_processor.categorize_sound(filename, description, allow_guess=True)
-        if res and 'primary_category' in res and float(res['primary_category'].get('score', 0)) >= 100.0:
+        res = self.ucs_processor.categorize_sound(filename, description, allow_guess=False)
+        if res and 'primary_category' in res:
             return res
 
         # 2) Check INFO metadata (case-insensitive keys) for explicit Category/SubCategory/UCS ID
@@ -2719,35 +6098,17 @@ class WAVsToAAFProcessor:
             wav_entries = []
             for wav_file in wav_files:
                 # Extract metadata
-                wav_metadata = self.extractor.extract_basic_info(wav_file)
-                if not wav_metadata:
+                entry = self._extract_file_record(wav_file)
+                if entry is None:
                     print(f"Skipping {wav_file}: cannot read metadata")
                     continue
 
-                all_chunks = self.extractor.extract_all_metadata_chunks(wav_file)
-                bext_metadata = {k: v for k, v in all_chunks.items() if k in [
-                    'description', 'originator', 'originator_reference', 'origination_date', 
-                    'origination_time', 'time_reference', 'version', 'umid', 'loudness_value',
-                    'loudness_range', 'max_true_peak', 'max_momentary_loudness', 'max_short_term_loudness'
-                ]}
-                xml_prefixes = ['ebucore_', 'bwfmetaedit_', 'protools_', 'axml_', 'xml_']
-                xml_metadata = {k: v for k, v in all_chunks.items() if any(k.startswith(prefix) for prefix in xml_prefixes)}
-                used_keys = set(bext_metadata.keys()) | set(xml_metadata.keys())
-                info_metadata = {k: v for k, v in all_chunks.items() if k not in used_keys}
-
-                ucs_metadata = self.ucs_processor.categorize_sound(
+                entry['ucs_metadata'] = self.ucs_processor.categorize_sound(
                         Path(wav_file).name,
-                        bext_metadata.get('description', ''),
+                        entry['bext_metadata'].get('description', ''),
                         allow_guess=allow_ucs_guess
                     )
-
-                wav_entries.append({
-                    'wav_metadata': wav_metadata,
-                    'bext_metadata': bext_metadata,
-                    'info_metadata': info_metadata,
-                    'xml_metadata': xml_metadata,
-                    'ucs_metadata': ucs_metadata,
-                })
+                wav_entries.append(entry)
 
             if not wav_entries:
                 print("No valid WAV entries to process")
@@ -3327,13 +6688,16 @@ NOTE: WAVsToAAF intentionally accepts PCM WAV files only (extensions: .wav, .wav
     )
     
     parser.add_argument('input', nargs='?', default=None,
-                        help='Input directory or file (if not provided, interactive mode is used)')
+                        help='Input directory, file, or ZIP/uncompressed TAR of stored WAVs (read in place, embedded '
+                             'AAFs only). If not provided, interactive mode is used')
     parser.add_argument('output', nargs='?', default=None,
                         help='Output directory or file (if not provided, interactive mode is used)')
     parser.add_argument('-f', '--file', action='store_true',
                         help='Process single file instead of directory')
     parser.add_argument('--emit-ale', action='store_true',
                         help='Also write an ALE for batch importing in Media Composer (directory mode only)')
+    parser.add_argument('--ale-only', action='store_true',
+                        help='In directory mode, extract metadata and write batch.ale without creating any AAFs')
     parser.add_argument('--one-aaf', action='store_true',
                         help='In directory mode, write one AAF containing all clips instead of one-per-clip (only applies with --linked)')
     # Embedded AAFs are now the default. Use --linked to create linked AAFs.
@@ -3344,21 +6708,106 @@ NOTE: WAVsToAAF intentionally accepts PCM WAV files only (extensions: .wav, .wav
                         help='(Default) Create embedded AAFs. Multi-channel WAVs will be split into per-channel mono embeds for best Avid compatibility')
     parser.add_argument('--relative-locators', action='store_true',
                         help='Use relative paths in locators (e.g., "./filename.wav") to eliminate locate prompts')
-    parser.add_argument('--link-mode', choices=['import','pcm'], default='import',
-                        help="Link style for linked AAFs: 'import' (ImportDescriptor chain) or 'pcm' (PCMDescriptor linked)")
+    parser.add_argument('--link-mode', choices=['import','pcm','mxf'], default='import',
+                        help="Link style for linked AAFs: 'import' (ImportDescriptor chain), 'pcm' (PCMDescriptor linked) "
+                             "or 'mxf' (also write per-channel OP-Atom MXF media and link to it; implies --linked)")
+    parser.add_argument('--mxf-media-dir', default=None,
+                        help="Folder for --link-mode mxf media (default: 'Avid MediaFiles/MXF/1' next to the AAFs)")
     parser.add_argument('--near-sources', action='store_true',
                         help='Save per-clip AAFs next to their source WAV files')
     parser.add_argument('--tape-mode', action='store_true',
                         help='Use TapeDescriptor structure (like ALE-exported AAFs) instead of ImportDescriptor')
+    parser.add_argument('--shared-tapes', action='store_true',
+                        help='With --tape-mode --one-aaf: create one TapeDescriptor SourceMob per tape (iXML TAPE, BEXT '
+                             'originator reference or folder name) shared by its clips, placed by BEXT time reference')
+    parser.add_argument('--sync-groups', action='store_true',
+                        help='With --one-aaf or --ale-only: give recordings that overlap in time (BEXT time reference '
+                             '+ duration, per origination date) a shared SyncGroup ID in MasterMob comments and the ALE')
+    parser.add_argument('--sync-gap', type=float, default=0.0,
+                        help='Seconds of gap still treated as the same sync group (default: 0, overlap only)')
+    parser.add_argument('--delta', action='store_true',
+                        help='With --one-aaf: write batch_delta_<time>.aaf with only the clips new or changed since '
+                             'the last one-AAF run (per batch_manifest.json) plus a CSV of removed clips')
+    parser.add_argument('--follow', action='store_true',
+                        help='Growing-file ingest: follow WAVs still being recorded or copied and embed their audio '
+                             'as it is written; a directory is watched for new recordings until Ctrl-C or --idle-exit')
+    parser.add_argument('--settle-seconds', type=float, default=5.0,
+                        help='With --follow: seconds without growth after which a recording whose header was never '
+                             'patched counts as finished (default: 5)')
+    parser.add_argument('--idle-exit', type=float, default=None,
+                        help='With --follow on a directory: stop after this many seconds with no recording in progress')
     parser.add_argument('--bit-depth', type=int, choices=[16, 24], default=None,
                         help='Optional output bit depth for embedded audio (16 or 24). Preserve source depth if omitted.')
     parser.add_argument('--sample-rate', type=int, choices=[44100, 48000, 96000], default=None,
                         help='Optional output sample rate in Hz for embedded audio. Preserve source rate if omitted.')
+    parser.add_argument('--plan', action='store_true',
+                        help='Dry run: read WAV headers only and report files per action, essence bytes, estimated output size and wall time')
+    parser.add_argument('--profile', action='store_true',
+                        help='Record this run\'s throughput in ~/.wavstoaaf/throughput.json to calibrate --plan estimates on this machine (directory mode)')
+    parser.add_argument('--skip-up-to-date', action='store_true',
+                        help='In directory mode, skip WAVs whose per-clip AAF already exists and is newer than the WAV')
+    parser.add_argument('--essence-block-size', default='4M',
+                        help='Block size for copying PCM into embedded AAF essence, e.g. 256K, 4M, 16M (default: 4M)')
+    parser.add_argument('--no-preallocate', action='store_true',
+                        help='Do not preallocate embedded essence streams to their final size')
+    parser.add_argument('--fsync', choices=['none', 'close'], default='none',
+                        help='fsync each AAF when it is closed (default: none; leave flushing to the OS)')
+    parser.add_argument('--essence-writer', choices=['stream', 'import'], default='import',
+                        help='import: use pyaaf2 import_audio_essence (default); stream: write essence blocks '
+                             'directly (needed for archive input and to embed --follow recordings while they grow)')
+    parser.add_argument('--interleaved-embed', action='store_true',
+                        help='Experimental: embed multi-channel WAVs as one interleaved multichannel SourceMob instead of '
+                             'one SourceMob per channel (not yet benchmarked against per-channel embedding)')
+    parser.add_argument('--mob-prototypes', action='store_true',
+                        help='Experimental: clone a per-shape prototype mob chain for each clip of a multi-clip AAF '
+                             'instead of building every clip from scratch')
+    parser.add_argument('--remap-locator', action='append', default=[], metavar='OLD=NEW',
+                        help='Rewrite the path prefix OLD to NEW in linked-media locators (repeatable), '
+                             'e.g. /Volumes/SFX=//nas/sfx')
+    parser.add_argument('--locator-remap-file', default=None,
+                        help='Text file of OLD=NEW locator prefix remaps, one per line')
+    parser.add_argument('--locator-set', choices=list(LOCATOR_SETS), default='all',
+                        help='Locators to write for linked media: all variants (default) or only the one '
+                             'the target platform resolves first (mac/windows: file:// URL, posix: path)')
+    parser.add_argument('--subclips', action='store_true',
+                        help='Add a subclip per cue/LIST-adtl region or iXML sync-point region, referencing the '
+                             'whole-file clip (no audio is split or copied; linked and embedded modes)')
+    parser.add_argument('--xattr-cache', action='store_true',
+                        help='Cache parsed chunk data and UCS results in an extended attribute on each WAV '
+                             '(validated by size, mtime and a header checksum; travels with the file)')
+    parser.add_argument('--sector-size', type=int, choices=[512, 4096], default=None,
+                        help='AAF compound-file sector size: 512 (version 3) or 4096 (version 4) '
+                             '(default: pyaaf2\'s own default)')
+    parser.add_argument('--workers', type=int, default=None,
+                        help='Directory mode: write per-clip AAFs on this many threads (default: 1). '
+                             f'With --follow: recordings followed at once (default: {FOLLOW_WORKERS})')
+    parser.add_argument('--memory-budget', default=None,
+                        help='Admit concurrent files only while their estimated peak memory fits in this budget, '
+                             'e.g. 4G (default with --workers > 1: half of physical RAM); oversize files run alone')
+    parser.add_argument('--target', action='append', default=[], metavar='KIND:OUTPUT[,opts]',
+                        help='Directory mode: write this output target (repeatable) from a single metadata pass. '
+                             'KIND is embedded, linked or ale; opts are fps=N, link=import|pcm, tape, one-aaf, '
+                             'relative, ale, bit-depth=N, sample-rate=N. Relative OUTPUTs are under the output argument')
+    parser.add_argument('--catalog', default=None, metavar='PATH',
+                        help='Also write a typed columnar catalog of the extracted metadata (format, BEXT, INFO, '
+                             'selected iXML keys, UCS): .parquet, or Arrow IPC for .arrow/.feather (needs pyarrow)')
+    parser.add_argument('--catalog-only', action='store_true',
+                        help='Only refresh the --catalog file: rows of unchanged files (same size and mtime) are '
+                             'reused and only new or changed WAVs are read; no AAFs or ALE')
+    parser.add_argument('--catalog-row-group', type=int, default=CATALOG_ROW_GROUP,
+                        help=f'Rows per catalog row group / record batch (default: {CATALOG_ROW_GROUP})')
+    parser.add_argument('--package', default=None, metavar='PATH',
+                        help='Stream each finished AAF, the ALE and reports of a directory run into a .zip (zip64) or '
+                             '.tar delivery archive as they complete, with index.json and SHA256SUMS at the end')
+    parser.add_argument('--package-only', action='store_true',
+                        help='With --package: delete each loose output once it is in the archive')
     parser.add_argument('-v', '--version', action='version',
                         version=f'WAVsToAAF {__version__}')
 
     parser.add_argument('--ucs-exact', action='store_true',
                         help='Only use exact UCS ID filename matches (disable fuzzy UCS guessing).')
+    parser.add_argument('--ucs-max-edit-distance', type=int, choices=[0, 1, 2], default=1,
+                        help='Typo tolerance for fuzzy UCS matching, in edits per word (default: 1; 0 disables)')
     parser.add_argument('--ucs-min-score', type=float, default=25.0,
                         help='Score threshold under which fuzzy UCS matches will be recorded to a low-confidence report (default: 25.0)')
     
@@ -3366,11 +6815,77 @@ NOTE: WAVsToAAF intentionally accepts PCM WAV files only (extensions: .wav, .wav
     # Other audio formats (AIFF, MP3, FLAC, etc.) are not supported by design.
     args = parser.parse_args()
 
+    if args.link_mode == 'mxf':
+        if args.embedded:
+            parser.error("--link-mode mxf writes linked AAFs and cannot be combined with --embedded")
+        if args.one_aaf or args.tape_mode:
+            parser.error("--link-mode mxf writes one AAF per clip and cannot be combined with --one-aaf or --tape-mode")
+        args.linked = True
+    if args.sync_groups and not (args.one_aaf or args.ale_only):
+        parser.error("--sync-groups requires --one-aaf or --ale-only")
+    if args.shared_tapes and not (args.tape_mode and args.one_aaf):
+        parser.error("--shared-tapes requires --tape-mode and --one-aaf")
+    if args.delta and not args.one_aaf:
+        parser.error("--delta requires --one-aaf")
+    if args.delta and (args.sync_groups or args.shared_tapes):
+        parser.error("--delta cannot be combined with --sync-groups or --shared-tapes (both are built from every clip of a run)")
     if args.linked and (args.bit_depth is not None or args.sample_rate is not None):
         parser.error("--bit-depth and --sample-rate are only supported when creating embedded AAFs")
+    if args.follow and (args.one_aaf or args.tape_mode or args.ale_only or args.plan or args.target or args.catalog
+                        or args.bit_depth is not None or args.sample_rate is not None
+                        or (args.input and is_archive(args.input))):
+        parser.error("--follow writes one AAF per recording and cannot be combined with --one-aaf, --tape-mode, "
+                     "--ale-only, --plan, --target, --catalog, --bit-depth, --sample-rate or archive input")
+    try:
+        essence_block_size = parse_byte_size(args.essence_block_size)
+    except ValueError:
+        parser.error(f"Invalid --essence-block-size: {args.essence_block_size}")
+    try:
+        locator_remaps = [parse_locator_remap(spec) for spec in args.remap_locator]
+        if args.locator_remap_file:
+            locator_remaps += load_locator_remap_file(args.locator_remap_file)
+    except (OSError, ValueError) as e:
+        parser.error(f"Invalid locator remap: {e}")
+    try:
+        memory_budget = parse_byte_size(args.memory_budget) if args.memory_budget else None
+    except ValueError:
+        parser.error(f"Invalid --memory-budget: {args.memory_budget}")
+    if args.workers is not None and args.workers < 1:
+        parser.error("--workers must be at least 1")
+    workers = args.workers or (FOLLOW_WORKERS if args.follow else 1)
+    try:
+        targets = [parse_output_target(spec, args.output) for spec in args.target]
+    except ValueError as e:
+        parser.error(str(e))
+    if args.catalog_only and not args.catalog:
+        parser.error("--catalog-only needs --catalog PATH")
+    if args.catalog and (args.file or args.plan):
+        parser.error("--catalog applies to directory runs (not -f or --plan)")
+    if args.package_only and not args.package:
+        parser.error("--package-only needs --package PATH")
+    if args.package:
+        if Path(args.package).suffix.lower() not in DeliveryPackage.FORMATS:
+            parser.error("--package must name a .zip or .tar file")
+        if args.file or args.plan or args.catalog_only or args.follow or targets \
+                or (args.input and is_archive(args.input)):
+            parser.error("--package applies to directory runs (not -f, --plan, --catalog-only, --follow, "
+                         "--target or archive input)")
+    if args.input and is_archive(args.input) and not args.file:
+        if args.linked and not args.ale_only:
+            parser.error("Archive input is read in place, so only embedded AAFs can be written: linked AAFs need "
+                         "the WAVs extracted to disk to point at. Drop --linked, or extract the archive first.")
+        if targets or args.plan or args.one_aaf or args.tape_mode or args.bit_depth or args.sample_rate:
+            parser.error("Archive input supports per-clip embedded AAFs and --ale-only/--emit-ale only "
+                         "(not --target, --plan, --one-aaf, --tape-mode, --bit-depth or --sample-rate)")
+        if args.essence_writer != 'stream':
+            parser.error("Archive input needs --essence-writer stream")
+    if targets and (args.file or args.plan or args.ale_only or args.one_aaf):
+        parser.error("--target cannot be combined with -f, --plan, --ale-only or --one-aaf (set them per target)")
     
     # Validate ffmpeg availability when audio conversion is requested
-    if not args.linked and (args.bit_depth is not None or args.sample_rate is not None):
+    if any(t['bit_depth'] or t['sample_rate'] for t in targets) and not ffmpeg_available():
+        parser.error("ffmpeg is required for targets with bit-depth or sample-rate conversion.")
+    if not args.linked and not args.plan and (args.bit_depth is not None or args.sample_rate is not None):
         if not ffmpeg_available():
             parser.error("ffmpeg is required for audio conversion (--bit-depth, --sample-rate). "
                         "Please install ffmpeg and add it to your PATH, or use --linked mode for no conversion.")
@@ -3396,19 +6911,133 @@ NOTE: WAVsToAAF intentionally accepts PCM WAV files only (extensions: .wav, .wav
     processor = WAVsToAAFProcessor()
     # configure processor with UCS low confidence threshold
     processor._ucs_min_score = float(getattr(args, 'ucs_min_score', 25.0))
+    if args.ucs_max_edit_distance != processor.ucs_processor.max_edit_distance:
+        processor.ucs_processor.set_max_edit_distance(args.ucs_max_edit_distance)
+    processor.generator.essence_writer = EssenceWriter(block_size=essence_block_size,
+                                                       preallocate=not args.no_preallocate,
+                                                       fsync=args.fsync, mode=args.essence_writer)
+    processor.generator.interleaved_embed = args.interleaved_embed
+    processor.generator.mob_prototypes = args.mob_prototypes
+    processor.generator.locator_remaps = locator_remaps
+    processor.generator.locator_set = args.locator_set
+    processor.generator.mxf_media_dir = args.mxf_media_dir
+    processor.generator.shared_tapes = args.shared_tapes
+    processor.generator.sector_size = args.sector_size
+    processor.subclips = args.subclips
+    processor.sync_groups = args.sync_groups
+    processor.sync_gap_seconds = max(0.0, args.sync_gap)
+    processor.delta = args.delta
+    processor.follow_settle_seconds = max(0.0, args.settle_seconds)
+    if workers > 1 or memory_budget:
+        processor.memory_governor = MemoryGovernor(memory_budget or default_memory_budget())
+    if args.xattr_cache:
+        processor.extractor.xattr_cache = XattrChunkCache()
+        if not processor.extractor.xattr_cache.available:
+            print("Warning: extended attributes are not available on this platform; --xattr-cache has no effect "
+                  "(on macOS install the 'xattr' package)")
     
+    if args.plan:
+        plan_output = os.path.dirname(output_path) if (args.file and output_path) else output_path
+        plan = processor.plan_directory(args.input, plan_output, embed_audio=embed_audio,
+                                        one_aaf=args.one_aaf and not args.file, near_sources=args.near_sources,
+                                        tape_mode=args.tape_mode, bit_depth=args.bit_depth,
+                                        sample_rate=args.sample_rate, ale_only=args.ale_only,
+                                        skip_up_to_date=args.skip_up_to_date)
+        return 0 if plan else 1
+
+    if args.catalog_only:
+        return processor.process_catalog(args.input, args.catalog, allow_ucs_guess=allow_ucs_guess,
+                                         row_group_size=args.catalog_row_group)
+    # Output sinks fed while the batch runs: discarded if it fails, finalized once it returns
+    sinks = []
+    if args.catalog:
+        try:
+            processor.catalog = CatalogWriter(args.catalog, row_group_size=args.catalog_row_group)
+        except ImportError:
+            print("Error: --catalog needs the optional 'pyarrow' package (pip install pyarrow)")
+            return 1
+        sinks.append(processor.catalog)
+    if args.package:
+        processor.package = DeliveryPackage(args.package, remove_added=args.package_only)
+        sinks.append(processor.package)
+    try:
+        result = run_batch(processor, args, output_path, targets, embed_audio, allow_ucs_guess)
+    except BaseException:
+        for sink in sinks:
+            sink.abort()
+        raise
+    if processor.catalog is not None:
+        processor.catalog.close()
+        print(f"Catalog: {processor.catalog.rows_written} row(s) written to {processor.catalog.path}")
+    package = processor.package
+    if package is not None and package.failed:
+        # An archive missing outputs is not a delivery: discard it (loose outputs are kept)
+        package.abort()
+        print(f"Error: {len(package.failed)} output(s) could not be packaged; {package.path.name} not written")
+        for name, error in package.failed:
+            print(f"  {name}: {error}")
+        return 1
+    if package is not None:
+        package.close()
+        print(f"Package: {len(package.entries)} file(s), "
+              f"{_format_bytes(package.bytes_added)} written to {package.path}")
+    return result
+
+
+def run_batch(processor: WAVsToAAFProcessor, args, output_path: Optional[str], targets: List[Dict],
+              embed_audio: bool, allow_ucs_guess: bool) -> int:
+    """Dispatch a configured CLI run to archive, multi-target, single-file or directory processing"""
+    if is_archive(args.input) and not args.file:
+        if args.profile:
+            print("Note: --profile only records directory runs; ignoring it for archive input.")
+        return processor.process_archive(args.input, args.output, embed_audio=embed_audio, emit_ale=args.emit_ale,
+                                         allow_ucs_guess=allow_ucs_guess, ale_only=args.ale_only,
+                                         skip_up_to_date=args.skip_up_to_date)
+
+    if args.follow:
+        if args.file:
+            return processor.follow_file(args.input, output_path, embed_audio=embed_audio, link_mode=args.link_mode,
+                                         relative_locators=args.relative_locators, allow_ucs_guess=allow_ucs_guess)
+        return processor.process_growing(args.input, output_path, embed_audio=embed_audio, link_mode=args.link_mode,
+                                         relative_locators=args.relative_locators, near_sources=args.near_sources,
+                                         allow_ucs_guess=allow_ucs_guess, idle_exit=args.idle_exit, workers=workers)
+
+    if targets:
+        if args.profile:
+            print("Note: --profile does not record multi-target runs; ignoring it.")
+        return processor.process_targets(args.input, targets, allow_ucs_guess=allow_ucs_guess,
+                                         skip_up_to_date=args.skip_up_to_date)
+
     if args.file:
+        if args.profile:
+            print("Note: --profile only records directory runs; ignoring it for single-file mode.")
         return processor.process_single_file(args.input, output_path, embed_audio=embed_audio,
                                            link_mode=args.link_mode, relative_locators=args.relative_locators,
                                            bit_depth=args.bit_depth, sample_rate=args.sample_rate,
                                            allow_ucs_guess=allow_ucs_guess)
     else:
-        return processor.process_directory(args.input, output_path, embed_audio=embed_audio,
+        result = processor.process_directory(args.input, output_path, embed_audio=embed_audio,
                                           link_mode=args.link_mode, emit_ale=args.emit_ale, 
                                           one_aaf=args.one_aaf, near_sources=args.near_sources, 
                                           tape_mode=args.tape_mode, relative_locators=args.relative_locators,
                                           bit_depth=args.bit_depth, sample_rate=args.sample_rate,
-                                          allow_ucs_guess=allow_ucs_guess)
+                                          allow_ucs_guess=allow_ucs_guess, ale_only=args.ale_only,
+                                          skip_up_to_date=args.skip_up_to_date, workers=workers)
+        governor = processor.memory_governor
+        if governor and governor.stats['waited']:
+            print(f"Memory governor: {governor.stats['waited']} file(s) waited for budget, "
+                  f"{governor.stats['serialized']} oversize file(s) ran alone, "
+                  f"peak estimate {governor.stats['peak_bytes'] / 1024 ** 2:.0f} MB of "
+                  f"{governor.budget / 1024 ** 2:.0f} MB")
+        if args.profile:
+            model = ThroughputModel()
+            try:
+                if model.record(processor.last_run_stats):
+                    model.save()
+                    print(f"Recorded throughput sample ({processor.last_run_stats['mode']}) in {model.path}")
+            except OSError as e:
+                print(f"Warning: could not save throughput profile: {e}")
+        return result
 
 def interactive_mode() -> int:
     """Interactive mode for user-friendly input prompting"""
@@ -21,13 +21,17 @@ Date: 2025-11-04
 
 import os
 import sys
+import json
+import time
+import uuid
 import threading
 import webbrowser
+from concurrent.futures import ThreadPoolExecutor
 import tkinter as tk
 from tkinter import ttk, filedialog, messagebox
 from tkinter.scrolledtext import ScrolledText
 from pathlib import Path
-from typing import Optional, Any
+from typing import Optional, Any, Callable, Dict, List, Tuple
 
 # Try to import tkinterdnd2 for drag-and-drop support
 try:
@@ -40,7 +44,7 @@ except ImportError:
 
 # Import the main WAVsToAAF processor
 try:
-    from wav_to_aaf import WAVsToAAFProcessor
+    from wav_to_aaf import WAVsToAAFProcessor, XattrChunkCache, MemoryGovernor, default_memory_budget
 except ImportError:
     print("Error: Could not import wav_to_aaf module")
     sys.exit(1)
@@ -66,6 +70,582 @@ def load_text_file(paths):
     return "License information not available."
 
 
+QUEUE_STATE_PATH = Path.home() / '.wavstoaaf' / 'job_queue.json'
+QUEUE_ACTIVE_STATES = ('queued', 'running', 'paused')
+# Shared by every queued job, so files from concurrent jobs are admitted against one memory budget
+QUEUE_MEMORY_GOVERNOR = MemoryGovernor(default_memory_budget())
+
+
+def run_conversion_job(job: Dict, cancel_event: threading.Event, pause_event: threading.Event,
+                       progress_callback: Optional[Callable[[int, int], None]] = None) -> int:
+    """Run one queued job (single file or directory) with its own options"""
+    opts = job.get('options', {})
+    inp = job['input']
+    outp = job.get('output') or None
+    processor = WAVsToAAFProcessor()
+    processor.memory_governor = QUEUE_MEMORY_GOVERNOR
+    if opts.get('xattr_cache'):
+        processor.extractor.xattr_cache = XattrChunkCache()
+    if os.path.isfile(inp):
+        if not outp:
+            outp = os.path.join(os.path.dirname(inp), "AAFs")
+        os.makedirs(outp, exist_ok=True)
+        dest = os.path.join(outp, os.path.splitext(os.path.basename(inp))[0] + ".aaf")
+        if progress_callback:
+            progress_callback(0, 1)
+        result = processor.process_single_file(
+            inp, dest, fps=opts.get('fps', 24.0), embed_audio=opts.get('embed_audio', True),
+            link_mode=opts.get('link_mode', 'import'), relative_locators=opts.get('relative_locators', False),
+            bit_depth=opts.get('bit_depth'), sample_rate=opts.get('sample_rate')
+        )
+        if progress_callback:
+            progress_callback(1, 1)
+        return result
+    return processor.process_directory(
+        inp, outp, fps=opts.get('fps', 24.0), embed_audio=opts.get('embed_audio', True),
+        link_mode=opts.get('link_mode', 'import'), emit_ale=opts.get('emit_ale', False),
+        one_aaf=opts.get('one_aaf', False), near_sources=opts.get('near_sources', False),
+        tape_mode=opts.get('tape_mode', False), relative_locators=opts.get('relative_locators', False),
+        bit_depth=opts.get('bit_depth'), sample_rate=opts.get('sample_rate'),
+        cancel_event=cancel_event, pause_event=pause_event, progress_callback=progress_callback
+    )
+
+
+class JobQueue:
+    """Queue of input→output jobs run through a shared, bounded worker pool.
+
+    Job state is persisted to a JSON file on every status change so queued work
+    survives restarts; jobs that were running or paused when the app closed are
+    re-queued on load. Callbacks fire on worker threads, never after shutdown().
+    Paused jobs that have not started wait outside the pool, so they hold no worker.
+    """
+
+    def __init__(self, state_path: Path = QUEUE_STATE_PATH, max_workers: int = 2,
+                 runner: Callable = run_conversion_job, on_change: Optional[Callable[[Dict], None]] = None):
+        self.state_path = Path(state_path)
+        self.max_workers = max(1, int(max_workers))
+        self.runner = runner
+        self.on_change = on_change
+        self.jobs: List[Dict] = []
+        self.running = False
+        self._closing = False
+        self._events: Dict[str, Tuple[threading.Event, threading.Event]] = {}
+        self._submitted = set()
+        self._lock = threading.RLock()
+        self._executor: Optional[ThreadPoolExecutor] = None
+        self.load()
+
+    # --- persistence -------------------------------------------------------------
+    def load(self):
+        try:
+            with open(self.state_path, 'r', encoding='utf-8') as f:
+                saved = json.load(f)
+        except (OSError, ValueError):
+            return
+        for job in saved.get('jobs', []):
+            if job.get('status') in QUEUE_ACTIVE_STATES:
+                job['status'] = 'queued'
+                job['done'] = 0
+            self.jobs.append(job)
+            self._events[job['id']] = (threading.Event(), threading.Event())
+        self.max_workers = max(1, int(saved.get('max_workers', self.max_workers)))
+
+    def save(self):
+        # Held across the write and replace: workers save concurrently through one temp file
+        with self._lock:
+            state = {'max_workers': self.max_workers, 'jobs': [dict(j) for j in self.jobs]}
+            try:
+                self.state_path.parent.mkdir(parents=True, exist_ok=True)
+                tmp_path = self.state_path.with_suffix('.tmp')
+                with open(tmp_path, 'w', encoding='utf-8') as f:
+                    json.dump(state, f, indent=2)
+                os.replace(tmp_path, self.state_path)
+            except OSError as e:
+                print(f"Warning: could not save job queue: {e}")
+
+    # --- job management ----------------------------------------------------------
+    def get(self, job_id: str) -> Optional[Dict]:
+        with self._lock:
+            for job in self.jobs:
+                if job['id'] == job_id:
+                    return job
+        return None
+
+    def add_job(self, input_path: str, output_path: Optional[str], options: Dict) -> Dict:
+        job = {
+            'id': uuid.uuid4().hex[:12],
+            'input': input_path,
+            'output': output_path or '',
+            'options': dict(options),
+            'status': 'queued',
+            'done': 0,
+            'total': 0,
+            'message': '',
+            'added': time.strftime('%Y-%m-%d %H:%M:%S'),
+        }
+        with self._lock:
+            self.jobs.append(job)
+            self._events[job['id']] = (threading.Event(), threading.Event())
+        self._changed(job, persist=True)
+        if self.running:
+            self._submit_pending()
+        return job
+
+    def remove_job(self, job_id: str) -> bool:
+        """Remove a job that is not currently running"""
+        with self._lock:
+            job = self.get(job_id)
+            if not job or job['status'] == 'running' or job_id in self._submitted:
+                return False
+            self.jobs.remove(job)
+            self._events.pop(job_id, None)
+        self.save()
+        return True
+
+    def clear_finished(self):
+        with self._lock:
+            self.jobs = [j for j in self.jobs if j['status'] in QUEUE_ACTIVE_STATES]
+        self.save()
+
+    def toggle_pause(self, job_id: str):
+        job = self.get(job_id)
+        if not job or job['status'] not in QUEUE_ACTIVE_STATES:
+            return
+        _, pause_evt = self._events[job_id]
+        if pause_evt.is_set():
+            pause_evt.clear()
+            self._update(job, status='running' if job.get('started') else 'queued')
+            if self.running:
+                self._submit_pending()
+        else:
+            pause_evt.set()
+            self._update(job, status='paused')
+
+    def cancel_job(self, job_id: str):
+        job = self.get(job_id)
+        if not job or job['status'] not in QUEUE_ACTIVE_STATES:
+            return
+        cancel_evt, pause_evt = self._events[job_id]
+        cancel_evt.set()
+        pause_evt.clear()
+        if job_id not in self._submitted:
+            self._update(job, status='cancelled')
+
+    def set_workers(self, count: int) -> bool:
+        """Resize the pool; only allowed while no job is running"""
+        with self._lock:
+            if self._submitted:
+                return False
+            self.max_workers = max(1, int(count))
+            if self._executor is not None:
+                self._executor.shutdown(wait=False)
+                self._executor = None
+        self.save()
+        return True
+
+    # --- execution ---------------------------------------------------------------
+    def start(self):
+        self.running = True
+        self._submit_pending()
+
+    def stop(self):
+        """Stop starting new jobs; running jobs finish normally"""
+        self.running = False
+
+    def shutdown(self):
+        """Stop for app exit: running jobs are cancelled but saved as active, so they re-queue on load"""
+        self.running = False
+        self.on_change = None
+        with self._lock:
+            self._closing = True
+            for job in self.jobs:
+                if job['status'] in QUEUE_ACTIVE_STATES:
+                    cancel_evt, pause_evt = self._events[job['id']]
+                    cancel_evt.set()
+                    pause_evt.clear()
+        self.save()
+        if self._executor is not None:
+            self._executor.shutdown(wait=False, cancel_futures=True)
+
+    def _submit_pending(self):
+        with self._lock:
+            if self._executor is None:
+                self._executor = ThreadPoolExecutor(max_workers=self.max_workers,
+                                                    thread_name_prefix='wavstoaaf-job')
+            for job in self.jobs:
+                if job['status'] == 'queued' and job['id'] not in self._submitted:
+                    self._submitted.add(job['id'])
+                    self._executor.submit(self._run_job, job['id'])
+
+    def _run_job(self, job_id: str):
+        job = self.get(job_id)
+        try:
+            if job is None:
+                return
+            cancel_evt, pause_evt = self._events[job_id]
+            if self._closing:
+                return
+            if cancel_evt.is_set():
+                self._update(job, status='cancelled')
+                return
+            if pause_evt.is_set() or not self.running:
+                # Paused or stopped while waiting for a worker: resubmitted on resume/start
+                return
+            job['started'] = True
+            self._update(job, status='running', message='')
+
+            def progress(done: int, total: int):
+                job['done'], job['total'] = done, total
+                self._changed(job)
+
+            try:
+                result = self.runner(job, cancel_evt, pause_evt, progress)
+                if self._closing:
+                    # Interrupted by app exit: keep it active in the saved state
+                    return
+                if cancel_evt.is_set():
+                    status = 'cancelled'
+                else:
+                    status = 'done' if result == 0 else 'failed'
+                self._update(job, status=status)
+            except Exception as e:
+                if not self._closing:
+                    self._update(job, status='failed', message=str(e))
+        finally:
+            with self._lock:
+                self._submitted.discard(job_id)
+                if job is not None:
+                    job.pop('started', None)
+                # Resumed while this worker was handing it back: submit it again
+                resubmit = (job is not None and job['status'] == 'queued' and self.running
+                            and not self._closing)
+            if resubmit:
+                self._submit_pending()
+
+    def _update(self, job: Dict, **fields):
+        job.update(fields)
+        self._changed(job, persist=True)
+
+    def _changed(self, job: Dict, persist: bool = False):
+        if persist:
+            self.save()
+        if self.on_change:
+            try:
+                self.on_change(job)
+            except Exception:
+                pass
+
+
+PREVIEW_COLUMNS = (('name', "File", 260), ('description', "Description", 240), ('ucs_id', "UCS ID", 90),
+                   ('category', "Category", 150), ('score', "Score", 60), ('channels', "Ch", 40),
+                   ('sample_rate', "Rate", 60), ('duration', "Duration", 70))
+
+
+class PreviewLoader:
+    """Builds pre-run preview rows for an input file or folder on a background thread.
+
+    Only headers are read (read_riff_header, or the xattr chunk cache when enabled); fuzzy UCS
+    guesses are batch-scored per chunk of files. Rows are appended under a lock, so the Tk side
+    polls snapshot() instead of being called back from the worker.
+    """
+
+    CHUNK = 500
+
+    def __init__(self, input_path: str, use_xattr_cache: bool = False):
+        self.input_path = input_path
+        self.processor = WAVsToAAFProcessor()
+        if use_xattr_cache:
+            self.processor.extractor.xattr_cache = XattrChunkCache()
+        self.rows: List[Dict] = []
+        self.total = 0
+        self.skipped = 0
+        self.done = False
+        self.error: Optional[str] = None
+        self.cancel_event = threading.Event()
+        self._lock = threading.Lock()
+        self._thread: Optional[threading.Thread] = None
+
+    def start(self):
+        self._thread = threading.Thread(target=self._run, name='wavstoaaf-preview', daemon=True)
+        self._thread.start()
+
+    def cancel(self):
+        self.cancel_event.set()
+
+    def loaded_rows(self) -> List[Dict]:
+        with self._lock:
+            return list(self.rows)
+
+    def snapshot(self) -> Tuple[int, int, bool]:
+        """(rows loaded, files found, finished)"""
+        with self._lock:
+            return len(self.rows), self.total, self.done
+
+    def _run(self):
+        try:
+            path = Path(self.input_path)
+            files = [path] if path.is_file() else self.processor.discover_wav_files(path)
+            self.total = len(files)
+            for start in range(0, len(files), self.CHUNK):
+                if self.cancel_event.is_set():
+                    break
+                rows = [row for row in map(self._read_row, files[start:start + self.CHUNK]) if row]
+                self._score_guesses(rows)
+                with self._lock:
+                    self.rows.extend(rows)
+        except Exception as e:
+            self.error = str(e)
+        finally:
+            with self._lock:
+                self.done = True
+
+    def _read_row(self, wav_file: Path) -> Optional[Dict]:
+        """Preview row for one WAV; None (counted as skipped) if it can't be read or parsed"""
+        try:
+            return self._build_row(wav_file)
+        except Exception:
+            self.skipped += 1
+            return None
+
+    def _build_row(self, wav_file: Path) -> Optional[Dict]:
+        extractor = self.processor.extractor
+        cache = extractor.xattr_cache
+        basic = cache.get(str(wav_file), 'basic') if cache else None
+        if basic:
+            chunks = extractor.extract_all_metadata_chunks(str(wav_file))
+        else:
+            header = extractor.read_riff_header(str(wav_file))
+            if not header or not header.get('sample_rate'):
+                self.skipped += 1
+                return None
+            basic = {'channels': header.get('channels', 0), 'sample_rate': header['sample_rate'],
+                     'duration_seconds': header['frames'] / header['sample_rate']}
+            if cache:
+                chunks = extractor.extract_all_metadata_chunks(str(wav_file))
+            else:
+                chunks = extractor.parse_metadata_bytes(header['metadata_bytes'])
+        bext_metadata, info_metadata, xml_metadata = self.processor._split_metadata_chunks(chunks)
+        description = bext_metadata.get('description', '')
+        # Exact IDs and explicit INFO/iXML fields now; fuzzy guesses are batch-scored per chunk
+        ucs = self.processor._resolve_ucs_metadata(wav_file.name, description, info_metadata, xml_metadata,
+                                                   allow_guess=False, wav_path=wav_file)
+        row = {'name': wav_file.name, 'path': str(wav_file), 'description': description,
+               'channels': basic.get('channels', 0), 'sample_rate': basic.get('sample_rate', 0),
+               'duration': float(basic.get('duration_seconds', 0.0))}
+        self._set_ucs(row, ucs)
+        return row
+
+    def _score_guesses(self, rows: List[Dict]):
+        pending = [row for row in rows if row['ucs_id'] is None]
+        if not pending:
+            return
+        results = self.processor.ucs_processor.categorize_batch([(r['name'], r['description']) for r in pending])
+        for row, result in zip(pending, results):
+            self._set_ucs(row, result, guessed=True)
+
+    @staticmethod
+    def _set_ucs(row: Dict, ucs: Dict, guessed: bool = False):
+        primary = (ucs or {}).get('primary_category')
+        if primary:
+            row.update(ucs_id=primary.get('id', ''), category=primary.get('full_name', ''),
+                       score=float(primary.get('score', 0.0)))
+        else:
+            # None marks "not resolved yet" until the batch guess runs
+            row.update(ucs_id='' if guessed else None, category='', score=0.0)
+
+
+class VirtualTable(ttk.Frame):
+    """Treeview that only holds the rows currently on screen.
+
+    The Treeview gets a fixed pool of items and the scrollbar drives an offset into `view`
+    (a list of row dicts), so scrolling 100k rows costs one screenful of item updates.
+    """
+
+    ROW_HEIGHT = 20
+
+    def __init__(self, master, columns, **kwargs):
+        super().__init__(master, **kwargs)
+        self.columns = columns
+        self.view: List[Dict] = []
+        self.offset = 0
+        self.visible = 0
+        self.on_heading: Optional[Callable[[str], None]] = None
+        ttk.Style(self).configure('Preview.Treeview', rowheight=self.ROW_HEIGHT)
+        self.tree = ttk.Treeview(self, columns=[c[0] for c in columns], show='headings',
+                                 style='Preview.Treeview', selectmode='browse', height=1)
+        for col, heading, width in columns:
+            self.tree.heading(col, text=heading, command=lambda c=col: self.on_heading and self.on_heading(c))
+            self.tree.column(col, width=width, anchor='e' if col in ('score', 'channels', 'sample_rate', 'duration') else 'w')
+        self.scrollbar = ttk.Scrollbar(self, orient='vertical', command=self._on_scrollbar)
+        self.scrollbar.pack(side='right', fill='y')
+        self.tree.pack(side='left', fill='both', expand=True)
+        self.tree.bind('<Configure>', self._on_resize)
+        self.tree.bind('<MouseWheel>', lambda e: self.scroll_by(-1 if e.delta > 0 else 1, 3))
+        self.tree.bind('<Button-4>', lambda e: self.scroll_by(-1, 3))
+        self.tree.bind('<Button-5>', lambda e: self.scroll_by(1, 3))
+        self.tree.bind('<Prior>', lambda e: self.scroll_by(-1, self.visible))
+        self.tree.bind('<Next>', lambda e: self.scroll_by(1, self.visible))
+
+    def set_view(self, view: List[Dict], keep_offset: bool = True):
+        self.view = view
+        if not keep_offset:
+            self.offset = 0
+        self.refresh()
+
+    def scroll_by(self, direction: int, rows: int):
+        self.offset += direction * max(1, rows)
+        self.refresh()
+        return 'break'
+
+    def _on_scrollbar(self, action, value, unit=None):
+        if action == 'moveto':
+            self.offset = int(float(value) * len(self.view))
+            self.refresh()
+        elif action == 'scroll':
+            self.scroll_by(int(value), self.visible if unit == 'pages' else 1)
+
+    def _on_resize(self, event):
+        # Heading row takes roughly one row height
+        visible = max(1, event.height // self.ROW_HEIGHT - 1)
+        if visible != self.visible:
+            self.visible = visible
+            self.refresh()
+
+    def refresh(self):
+        total = len(self.view)
+        self.offset = max(0, min(self.offset, total - self.visible))
+        items = self.tree.get_children()
+        if len(items) != self.visible:
+            self.tree.delete(*items)
+            items = [self.tree.insert('', 'end', values=()) for _ in range(self.visible)]
+        for n, item in enumerate(items):
+            index = self.offset + n
+            if index < total:
+                self.tree.item(item, values=self.format_row(self.view[index]))
+            else:
+                self.tree.item(item, values=())
+        if total:
+            self.scrollbar.set(self.offset / total, min(1.0, (self.offset + self.visible) / total))
+        else:
+            self.scrollbar.set(0.0, 1.0)
+
+    @staticmethod
+    def format_row(row: Dict) -> Tuple:
+        minutes, seconds = divmod(row['duration'], 60)
+        return (row['name'], row['description'], row['ucs_id'] or '', row['category'],
+                f"{row['score']:.0f}", row['channels'], row['sample_rate'], f"{int(minutes)}:{seconds:04.1f}")
+
+
+def compute_preview_view(rows: List[Dict], request: Tuple) -> List[Dict]:
+    """Rows matching (text, min score, max score, sort column, reverse), filtered and sorted"""
+    text, low, high, sort_key, reverse = request
+    view = [r for r in rows if low <= r['score'] <= high and
+            (not text or text in r['name'].lower() or text in r['description'].lower()
+             or text in r['category'].lower() or text in (r['ucs_id'] or '').lower())]
+    if sort_key:
+        view.sort(key=lambda r: r[sort_key].lower() if isinstance(r[sort_key], str) else r[sort_key],
+                  reverse=reverse)
+    return view
+
+
+def open_preview_window(parent, input_path: str, use_xattr_cache: bool = False):
+    """Pre-run metadata preview: header fields, BEXT description and UCS guesses for every WAV"""
+    win = tk.Toplevel(parent)
+    win.title(f"Preview - {os.path.basename(input_path.rstrip(os.sep)) or input_path}")
+    win.geometry("1000x600")
+
+    toolbar = ttk.Frame(win, padding=(8, 8, 8, 4))
+    toolbar.pack(fill='x')
+    filter_var = tk.StringVar(value="")
+    min_score_var = tk.StringVar(value="0")
+    max_score_var = tk.StringVar(value="100")
+    ttk.Label(toolbar, text="Filter:").pack(side='left')
+    ttk.Entry(toolbar, textvariable=filter_var, width=28).pack(side='left', padx=(4, 12))
+    ttk.Label(toolbar, text="UCS score").pack(side='left')
+    ttk.Spinbox(toolbar, from_=0, to=100, width=5, textvariable=min_score_var).pack(side='left', padx=(4, 2))
+    ttk.Label(toolbar, text="to").pack(side='left')
+    ttk.Spinbox(toolbar, from_=0, to=100, width=5, textvariable=max_score_var).pack(side='left', padx=(2, 0))
+    count_var = tk.StringVar(value="Scanning…")
+    ttk.Label(toolbar, textvariable=count_var).pack(side='right')
+
+    table = VirtualTable(win, PREVIEW_COLUMNS, padding=(8, 0, 8, 8))
+    table.pack(fill='both', expand=True)
+
+    loader = PreviewLoader(input_path, use_xattr_cache=use_xattr_cache)
+    # Sort/filter requests and results; the worker never touches Tk, _poll applies results
+    state = {'sort': None, 'reverse': False, 'generation': 0, 'applied': 0, 'result': None,
+             'rows_seen': 0, 'pending': None}
+
+    def current_request():
+        try:
+            low, high = float(min_score_var.get() or 0), float(max_score_var.get() or 100)
+        except ValueError:
+            low, high = 0.0, 100.0
+        return (filter_var.get().strip().lower(), low, high, state['sort'], state['reverse'])
+
+    def compute_view(generation: int, request: Tuple, rows: List[Dict]):
+        state['result'] = (generation, compute_preview_view(rows, request))
+
+    def request_view():
+        """Recompute the view off the Tk thread; only the newest request is applied"""
+        state['generation'] += 1
+        rows = loader.loaded_rows()
+        state['rows_seen'] = len(rows)
+        threading.Thread(target=compute_view, args=(state['generation'], current_request(), rows),
+                         daemon=True).start()
+
+    def debounced_request(*_):
+        if state['pending'] is not None:
+            win.after_cancel(state['pending'])
+        state['pending'] = win.after(200, fire_request)
+
+    def fire_request():
+        state['pending'] = None
+        request_view()
+
+    def heading_clicked(col: str):
+        state['reverse'] = not state['reverse'] if state['sort'] == col else col == 'score'
+        state['sort'] = col
+        for c, heading, _ in PREVIEW_COLUMNS:
+            arrow = (' ▼' if state['reverse'] else ' ▲') if c == col else ''
+            table.tree.heading(c, text=heading + arrow)
+        request_view()
+
+    def poll():
+        if not win.winfo_exists():
+            return
+        result = state['result']
+        if result and result[0] > state['applied']:
+            state['applied'] = result[0]
+            table.set_view(result[1], keep_offset=True)
+        loaded, total, done = loader.snapshot()
+        # While loading, refresh the view every time a chunk lands
+        if loaded != state['rows_seen'] and state['applied'] == state['generation']:
+            request_view()
+        shown = len(table.view)
+        if loader.error:
+            count_var.set(f"Error: {loader.error}")
+        elif done:
+            skipped = f", {loader.skipped} unreadable" if loader.skipped else ""
+            count_var.set(f"{shown:,} of {loaded:,} files shown{skipped}")
+        else:
+            count_var.set(f"Reading {loaded:,} / {total:,} files…")
+        win.after(100, poll)
+
+    def close():
+        loader.cancel()
+        win.destroy()
+
+    table.on_heading = heading_clicked
+    filter_var.trace_add('write', debounced_request)
+    min_score_var.trace_add('write', debounced_request)
+    max_score_var.trace_add('write', debounced_request)
+    win.protocol("WM_DELETE_WINDOW", close)
+    loader.start()
+    win.after(100, poll)
+    return win
+
+
 def launch_gui():
     """Launch the WAVsToAAF GUI"""
     global root, input_var, out_var, emit_ale_var, one_aaf_var
@@ -79,8 +659,8 @@ def launch_gui():
         root = tk.Tk()
 
     root.title("WAVsToAAF - WAV to AAF Converter")
-    root.geometry("800x700")
-    root.minsize(700, 600)
+    root.geometry("820x860")
+    root.minsize(720, 720)
 
     # Variables
     input_var = tk.StringVar(value="")
@@ -93,10 +673,12 @@ def launch_gui():
     bit_depth_var = tk.StringVar(value="24")
     sample_rate_var = tk.StringVar(value="48000")
     fps_var = tk.StringVar(value="24")
+    xattr_cache_var = tk.BooleanVar(value=False)
     last_outputs = {'paths': [], 'last_output_path': None}
     progress_var = tk.StringVar(value="")
     status_var = tk.StringVar(value="")
     cancel_event = threading.Event()
+    job_queue = JobQueue()
 
     def log(msg):
         log_text.configure(state='normal')
@@ -205,19 +787,19 @@ def launch_gui():
             root.after(3000, lambda: status_var.set("") if status_var.get().startswith("Output set to:") else None)
         return 'copy'
 
-    def run_clicked():
-        """Handle the Run button click"""
+    def collect_job_options():
+        """Validate the input/output fields and parse options; returns (inp, outp, opts) or None"""
         inp = input_var.get().strip()
         outp = out_var.get().strip()
 
         # Validate inputs
         if not inp:
             messagebox.showerror("Missing input", "Please select a WAV file or directory.")
-            return
+            return None
 
         if not os.path.exists(inp):
             messagebox.showerror("Input not found", f"The selected input does not exist:\n{inp}")
-            return
+            return None
 
         # Parse options
         try:
@@ -229,12 +811,7 @@ def launch_gui():
             fps = 24.0
 
         embed_audio = True
-        emit_ale = emit_ale_var.get()
-        one_aaf = one_aaf_var.get()
         near_sources = near_sources_var.get()
-        tape_mode = tape_mode_var.get()
-        relative_locators = relative_locators_var.get()
-        link_mode = 'import'
 
         # Parse bit depth and sample rate (only for embedded audio)
         bit_depth = None
@@ -265,6 +842,47 @@ def launch_gui():
                 dir_name = os.path.basename(inp.rstrip('/\\'))
                 outp = os.path.join(parent_dir, "AAFs", dir_name)
 
+        opts = {
+            'fps': fps,
+            'embed_audio': embed_audio,
+            'link_mode': 'import',
+            'emit_ale': emit_ale_var.get(),
+            'one_aaf': one_aaf_var.get(),
+            'near_sources': near_sources,
+            'tape_mode': tape_mode_var.get(),
+            'relative_locators': relative_locators_var.get(),
+            'bit_depth': bit_depth,
+            'sample_rate': sample_rate,
+            'xattr_cache': xattr_cache_var.get(),
+        }
+        return inp, outp, opts
+
+    def preview_clicked():
+        """Open the metadata preview table for the current input"""
+        inp = input_var.get().strip()
+        if not inp or not os.path.exists(inp):
+            messagebox.showerror("Input not found", "Please select an existing WAV file or directory to preview.")
+            return
+        open_preview_window(root, inp, use_xattr_cache=xattr_cache_var.get())
+
+    def run_clicked():
+        """Handle the Run button click"""
+        collected = collect_job_options()
+        if collected is None:
+            return
+        inp, outp, opts = collected
+        fps = opts['fps']
+        embed_audio = opts['embed_audio']
+        emit_ale = opts['emit_ale']
+        one_aaf = opts['one_aaf']
+        near_sources = opts['near_sources']
+        tape_mode = opts['tape_mode']
+        relative_locators = opts['relative_locators']
+        link_mode = opts['link_mode']
+        bit_depth = opts['bit_depth']
+        sample_rate = opts['sample_rate']
+        xattr_cache = opts['xattr_cache']
+
         cancel_event.clear()
         run_btn.configure(state='disabled')
         cancel_btn.configure(state='normal')
@@ -289,6 +907,8 @@ def launch_gui():
 
             try:
                 processor = WAVsToAAFProcessor()
+                if xattr_cache:
+                    processor.extractor.xattr_cache = XattrChunkCache()
 
                 if os.path.isfile(inp):
                     # Single file processing
@@ -365,6 +985,102 @@ def launch_gui():
         cancel_event.set()
         log("Cancelling operation...")
 
+    # --- Job queue ---------------------------------------------------------------
+    def queue_job_changed(job):
+        # Called from worker threads; marshal onto the Tk thread
+        try:
+            root.after(0, lambda: refresh_queue_row(job))
+        except Exception:
+            pass
+
+    def queue_row_values(job):
+        mode = "One AAF" if job['options'].get('one_aaf') else "Per clip"
+        if job['options'].get('tape_mode'):
+            mode += " (tape)"
+        if job.get('total'):
+            progress = f"{job['done']}/{job['total']}"
+        else:
+            progress = ""
+        status = job['status'] + (f": {job['message']}" if job.get('message') else "")
+        return (os.path.basename(job['input'].rstrip('/\\')) or job['input'],
+                job['output'] or "(next to sources)", mode, status, progress)
+
+    def refresh_queue_row(job):
+        if queue_tree.exists(job['id']):
+            queue_tree.item(job['id'], values=queue_row_values(job))
+        else:
+            queue_tree.insert('', 'end', iid=job['id'], values=queue_row_values(job))
+        update_queue_buttons()
+
+    def reload_queue_tree():
+        queue_tree.delete(*queue_tree.get_children())
+        for job in list(job_queue.jobs):
+            queue_tree.insert('', 'end', iid=job['id'], values=queue_row_values(job))
+        update_queue_buttons()
+
+    def selected_job_id():
+        sel = queue_tree.selection()
+        return sel[0] if sel else None
+
+    def update_queue_buttons(event=None):
+        start_queue_btn.configure(text="Stop Queue" if job_queue.running else "Start Queue")
+        job = job_queue.get(selected_job_id() or '')
+        active = bool(job) and job['status'] in QUEUE_ACTIVE_STATES
+        pause_job_btn.configure(state='normal' if active else 'disabled',
+                                text="Resume" if job and job['status'] == 'paused' else "Pause")
+        cancel_job_btn.configure(state='normal' if active else 'disabled')
+        remove_job_btn.configure(state='normal' if job and job['status'] != 'running' else 'disabled')
+
+    def add_to_queue_clicked():
+        collected = collect_job_options()
+        if collected is None:
+            return
+        inp, outp, opts = collected
+        job = job_queue.add_job(inp, outp, opts)
+        refresh_queue_row(job)
+        status_var.set(f"Queued: {queue_row_values(job)[0]}")
+
+    def start_queue_clicked():
+        if job_queue.running:
+            job_queue.stop()
+            status_var.set("Queue stopped; running jobs will finish")
+        else:
+            try:
+                workers = int(workers_var.get())
+            except ValueError:
+                workers = job_queue.max_workers
+            if workers != job_queue.max_workers and not job_queue.set_workers(workers):
+                messagebox.showwarning("Workers", "Worker count can only change while no job is running.")
+                workers_var.set(str(job_queue.max_workers))
+            job_queue.start()
+            status_var.set(f"Queue running with {job_queue.max_workers} worker(s)")
+        update_queue_buttons()
+
+    def pause_job_clicked():
+        job_id = selected_job_id()
+        if job_id:
+            job_queue.toggle_pause(job_id)
+
+    def cancel_job_clicked():
+        job_id = selected_job_id()
+        if job_id:
+            job_queue.cancel_job(job_id)
+            log("Cancelling queued job...")
+
+    def remove_job_clicked():
+        job_id = selected_job_id()
+        if job_id and job_queue.remove_job(job_id):
+            queue_tree.delete(job_id)
+        update_queue_buttons()
+
+    def clear_finished_clicked():
+        job_queue.clear_finished()
+        reload_queue_tree()
+
+    def on_close():
+        job_queue.shutdown()
+        root.destroy()
+
     def open_output_location():
         """Open the output directory in file explorer"""
         if last_outputs['paths']:
@@ -530,6 +1246,12 @@ def launch_gui():
     fps_combo = ttk.Combobox(embed_opts_frame, textvariable=fps_var, values=["23.976", "24", "25", "29.97", "30"], state="readonly", width=8)
     fps_combo.pack(side='left', padx=(4, 0))
 
+    # Applies to every mode (and the preview), not just embedded audio
+    general_opts_frame = ttk.Frame(adv_container)
+    general_opts_frame.pack(fill='x', pady=(0, 8))
+    ttk.Checkbutton(general_opts_frame, text="Cache metadata in xattrs",
+                    variable=xattr_cache_var).pack(side='left')
+
     adv_container.pack_forget()
 
     # Action buttons
@@ -539,10 +1261,46 @@ def launch_gui():
     run_btn.pack(side='left')
     cancel_btn = ttk.Button(buttons_row, text="Cancel", command=cancel_clicked, state='disabled')
     cancel_btn.pack(side='left', padx=(8, 0))
+    preview_btn = ttk.Button(buttons_row, text="Preview", command=preview_clicked)
+    preview_btn.pack(side='left', padx=(8, 0))
     open_btn = ttk.Button(buttons_row, text="Open AAF Location", command=open_output_location, state='disabled')
     open_btn.pack(side='left', padx=(8, 0))
     open_btn.pack_forget()  # Hide initially
 
+    # Job queue
+    queue_frame = ttk.LabelFrame(frm, text="Job Queue", padding=8)
+    queue_frame.pack(fill='x', pady=(0, 8))
+
+    queue_columns = ('input', 'output', 'mode', 'status', 'progress')
+    queue_tree = ttk.Treeview(queue_frame, columns=queue_columns, show='headings', height=4, selectmode='browse')
+    for col, heading, width in (('input', "Input", 170), ('output', "Output", 220), ('mode', "Mode", 110),
+                                ('status', "Status", 140), ('progress', "Progress", 80)):
+        queue_tree.heading(col, text=heading)
+        queue_tree.column(col, width=width, anchor='w')
+    queue_tree.pack(fill='x')
+    queue_tree.bind('<<TreeviewSelect>>', update_queue_buttons)
+
+    queue_btns = ttk.Frame(queue_frame)
+    queue_btns.pack(fill='x', pady=(6, 0))
+    ttk.Button(queue_btns, text="Add to Queue", command=add_to_queue_clicked).pack(side='left')
+    start_queue_btn = ttk.Button(queue_btns, text="Start Queue", command=start_queue_clicked)
+    start_queue_btn.pack(side='left', padx=(8, 0))
+    pause_job_btn = ttk.Button(queue_btns, text="Pause", command=pause_job_clicked, state='disabled')
+    pause_job_btn.pack(side='left', padx=(8, 0))
+    cancel_job_btn = ttk.Button(queue_btns, text="Cancel Job", command=cancel_job_clicked, state='disabled')
+    cancel_job_btn.pack(side='left', padx=(8, 0))
+    remove_job_btn = ttk.Button(queue_btns, text="Remove", command=remove_job_clicked, state='disabled')
+    remove_job_btn.pack(side='left', padx=(8, 0))
+    ttk.Button(queue_btns, text="Clear Finished", command=clear_finished_clicked).pack(side='left', padx=(8, 0))
+    workers_var = tk.StringVar(value=str(job_queue.max_workers))
+    ttk.Spinbox(queue_btns, from_=1, to=max(1, os.cpu_count() or 1), width=4,
+                textvariable=workers_var).pack(side='right')
+    ttk.Label(queue_btns, text="Workers:").pack(side='right', padx=(0, 4))
+
+    job_queue.on_change = queue_job_changed
+    reload_queue_tree()
+    root.protocol("WM_DELETE_WINDOW", on_close)
+
     # Status bar
     status_label = ttk.Label(frm, textvariable=status_var, foreground="blue")
     status_label.pack(fill='x', pady=(0, 8))